@@ -77,6 +77,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/blackoil/blackoillocalresidual.hh
              opm/models/blackoil/blackoillocalresidualtpfa.hh
              opm/models/blackoil/blackoilnewtonmethod.hh
+             opm/models/blackoil/blackoilphaseconfig.hh
              opm/models/blackoil/blackoilnewtonmethodparameters.hh
              opm/models/blackoil/blackoilonephaseindices.hh
              opm/models/blackoil/blackoilsolventmodules.hh
@@ -143,6 +144,9 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/discretization/common/fvbaseproblem.hh
              opm/models/discretization/common/fvbaseprimaryvariables.hh
              opm/models/discretization/common/linearizationtype.hh
+             opm/models/discretization/common/nlddsubdomain.hh
+             opm/models/discretization/common/dofordering.hh
+             opm/models/discretization/common/permutedmapper.hh
              opm/models/discretization/ecfv/ecfvgridcommhandlefactory.hh
              opm/models/discretization/ecfv/ecfvstencil.hh
              opm/models/discretization/ecfv/ecfvbaseoutputmodule.hh
@@ -175,6 +179,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/io/cubegridvanguard.hh
              opm/models/io/baseoutputwriter.hh
              opm/models/io/vtkmultiwriter.hh
+             opm/models/io/vtunativewriter.hh
              opm/models/io/vtkmultiphasemodule.hh
              opm/models/io/vtkdiscretefracturemodule.hh
              opm/models/io/vtkdiffusionmodule.hh
@@ -210,9 +215,11 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/nonlinear/newtonmethodproperties.hh
              opm/models/parallel/mpiutil.hh
              opm/models/parallel/tasklets.hh
+             opm/models/parallel/numaplacement.hh
              opm/models/parallel/threadmanager.hh
              opm/models/parallel/gridcommhandles.hh
              opm/models/parallel/mpibuffer.hh
+             opm/models/parallel/packedallreduce.hh
              opm/models/parallel/threadedentityiterator.hh
              opm/models/ptflash/flashintensivequantities.hh
              opm/models/ptflash/flashindices.hh
@@ -251,7 +258,11 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/utils/quadraturegeometries.hh
              opm/models/utils/alignedallocator.hh
              opm/models/utils/timer.hh
+             opm/models/utils/timestepcontroller.hh
              opm/models/utils/signum.hh
+             opm/models/utils/tabulated2dfunctionbundle.hh
+             opm/models/utils/allocationaudit.hh
+             opm/models/utils/allocationauditoperators.hh
              opm/models/utils/genericguard.hh
              opm/models/utils/basicparameters.hh
              opm/models/utils/basicproperties.hh
@@ -278,12 +289,17 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/globalindices.hh
              opm/simulators/linalg/superlubackend.hh
              opm/simulators/linalg/matrixblock.hh
+             opm/simulators/linalg/matrixfreebackend.hh
              opm/simulators/linalg/istlsolverwrappers.hh
              opm/simulators/linalg/overlaptypes.hh
              opm/simulators/linalg/overlappingpreconditioner.hh
              opm/simulators/linalg/domesticoverlapfrombcrsmatrix.hh
              opm/simulators/linalg/fixpointcriterion.hh
              opm/simulators/linalg/parallelamgbackend.hh
+             opm/simulators/linalg/parallelcprbackend.hh
+             opm/simulators/linalg/cprpreconditioner.hh
+             opm/simulators/linalg/pressuretransportsplitting.hh
+             opm/simulators/linalg/nlddlocalsystem.hh
              opm/simulators/linalg/foreignoverlapfrombcrsmatrix.hh
              opm/simulators/linalg/overlappingscalarproduct.hh
              opm/simulators/linalg/convergencecriterion.hh)
@@ -17,6 +17,7 @@ set (opm-models_CONFIG_VAR
   HAVE_OPM_GRID
   DUNE_AVOID_CAPABILITIES_IS_PARALLEL_DEPRECATION_WARNING
   HAVE_FLOATING_POINT_FROM_CHARS
+  HAVE_ZLIB
   )
 
 # dependencies
@@ -38,6 +39,8 @@ set (opm-models_DEPS
   "Valgrind"
   # quadruple precision floating point calculations
   "QuadMath"
+  # compression of the output of the native VTK writer
+  "ZLIB"
   )
 
 find_package_deps(opm-models)
@@ -447,6 +447,7 @@ public:
                                   unsigned timeIdx)
     {
         const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
+        const auto linearizationType = elemCtx.linearizationType();
 
         auto& fs = asImp_().fluidState_;
 
@@ -458,18 +459,18 @@ public:
             saltDensity_ = saltdenTable;
 
             if (priVars.primaryVarsMeaningBrine() == PrimaryVariables::BrineMeaning::Sp) {
-                saltSaturation_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx);
+                saltSaturation_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx, linearizationType);
                 fs.setSaltConcentration(saltSolubility_);
             }
             else {
-                saltConcentration_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx);
+                saltConcentration_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx, linearizationType);
                 fs.setSaltConcentration(saltConcentration_);
                 saltSaturation_ = 0.0;
             }
             fs.setSaltSaturation(saltSaturation_);
         }
         else {
-            saltConcentration_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx);
+            saltConcentration_ = priVars.makeEvaluation(saltConcentrationIdx, timeIdx, linearizationType);
             fs.setSaltConcentration(saltConcentration_);
         }
     }
@@ -28,6 +28,8 @@
 #ifndef OPM_BLACKOIL_DIFFUSION_MODULE_HH
 #define OPM_BLACKOIL_DIFFUSION_MODULE_HH
 
+#include <opm/models/blackoil/blackoilphaseconfig.hh>
+#include <opm/models/blackoil/blackoilproperties.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 
 #include <opm/material/common/Valgrind.hpp>
@@ -99,6 +101,8 @@ class BlackOilDiffusionModule<TypeTag, /*enableDiffusion=*/true>
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using RateVector = GetPropType<TypeTag, Properties::RateVector>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
     using Indices = GetPropType<TypeTag, Properties::Indices>;
 
     enum { numPhases = FluidSystem::numPhases };
@@ -173,17 +177,17 @@ public:
     {
         unsigned pvtRegionIndex = fluidStateI.pvtRegionIndex();
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 continue;
             }
 
             // no diffusion in water for blackoil models
-            if (!FluidSystem::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
+            if (!PhaseConfig::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
                 continue;
             }
 
             // no diffusion in gas phase in water + gas system.
-            if (FluidSystem::gasPhaseIdx == phaseIdx && !FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (FluidSystem::gasPhaseIdx == phaseIdx && !PhaseConfig::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 continue;
             }
 
@@ -197,22 +201,22 @@ public:
                 continue;
             Evaluation convFactor = 1.0;
             Evaluation diffR = 0.0;
-            if (FluidSystem::enableDissolvedGas() && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && phaseIdx == FluidSystem::oilPhaseIdx) {
+            if (PhaseConfig::enableDissolvedGas() && PhaseConfig::phaseIsActive(FluidSystem::gasPhaseIdx) && phaseIdx == FluidSystem::oilPhaseIdx) {
                 Evaluation rsAvg = (fluidStateI.Rs() + Toolbox::value(fluidStateJ.Rs())) / 2;
                 convFactor = 1.0 / (toFractionGasOil(pvtRegionIndex) + rsAvg);
                 diffR = fluidStateI.Rs() - Toolbox::value(fluidStateJ.Rs());
             }
-            if (FluidSystem::enableVaporizedOil() && FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIdx == FluidSystem::gasPhaseIdx) {
+            if (PhaseConfig::enableVaporizedOil() && PhaseConfig::phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIdx == FluidSystem::gasPhaseIdx) {
                 Evaluation rvAvg = (fluidStateI.Rv() + Toolbox::value(fluidStateJ.Rv())) / 2;
                 convFactor = toFractionGasOil(pvtRegionIndex) / (1.0 + rvAvg*toFractionGasOil(pvtRegionIndex));
                 diffR = fluidStateI.Rv() - Toolbox::value(fluidStateJ.Rv());
             }
-            if (FluidSystem::enableDissolvedGasInWater() && phaseIdx == FluidSystem::waterPhaseIdx) {
+            if (PhaseConfig::enableDissolvedGasInWater() && phaseIdx == FluidSystem::waterPhaseIdx) {
                 Evaluation rsAvg = (fluidStateI.Rsw() + Toolbox::value(fluidStateJ.Rsw())) / 2;
                 convFactor = 1.0 / (toFractionGasWater(pvtRegionIndex) + rsAvg);
                 diffR = fluidStateI.Rsw() - Toolbox::value(fluidStateJ.Rsw());
             }
-            if (FluidSystem::enableVaporizedWater() && phaseIdx == FluidSystem::gasPhaseIdx) {
+            if (PhaseConfig::enableVaporizedWater() && phaseIdx == FluidSystem::gasPhaseIdx) {
                 Evaluation rvAvg = (fluidStateI.Rvw() + Toolbox::value(fluidStateJ.Rvw())) / 2;
                 convFactor = toFractionGasWater(pvtRegionIndex)/ (1.0 + rvAvg*toFractionGasWater(pvtRegionIndex));
                 diffR = fluidStateI.Rvw() - Toolbox::value(fluidStateJ.Rvw());
@@ -338,6 +342,8 @@ class BlackOilDiffusionIntensiveQuantities<TypeTag, /*enableDiffusion=*/true>
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
     using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     enum { numPhases = FluidSystem::numPhases };
     enum { numComponents = FluidSystem::numComponents };
@@ -419,12 +425,12 @@ protected:
         using Toolbox = MathToolbox<Evaluation>;
 
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 continue;
             }
 
             // no diffusion in water for blackoil models
-            if (!FluidSystem::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
+            if (!PhaseConfig::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
                 continue;
             }
 
@@ -529,6 +535,8 @@ class BlackOilDiffusionExtensiveQuantities<TypeTag, /*enableDiffusion=*/true>
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
     using Toolbox = MathToolbox<Evaluation>;
     using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
 
@@ -570,11 +578,11 @@ public:
                        const IntensiveQuantities& intQuantsOutside) {
         // opm-models expects per area flux
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 continue;
             }
             // no diffusion in water for blackoil models
-            if (!FluidSystem::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
+            if (!PhaseConfig::enableDissolvedGasInWater() && FluidSystem::waterPhaseIdx == phaseIdx) {
                 continue;
             }
             for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
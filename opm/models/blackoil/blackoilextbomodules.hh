@@ -52,6 +52,7 @@
 
 #include <dune/common/fvector.hh>
 
+#include <array>
 #include <cmath>
 #include <stdexcept>
 #include <string>
@@ -84,6 +85,8 @@ class BlackOilExtboModule
 
     using TabulatedFunction = typename BlackOilExtboParams<Scalar>::TabulatedFunction;
     using Tabulated2DFunction = typename BlackOilExtboParams<Scalar>::Tabulated2DFunction;
+    using OilTableBundle = typename BlackOilExtboParams<Scalar>::OilTableBundle;
+    using GasTableBundle = typename BlackOilExtboParams<Scalar>::GasTableBundle;
 
     static constexpr unsigned zFractionIdx = Indices::zFractionIdx;
     static constexpr unsigned contiZfracEqIdx = Indices::contiZfracEqIdx;
@@ -133,6 +136,9 @@ public:
         params_.PBUB_RS_.resize(numPvtRegions, Tabulated2DFunction{Tabulated2DFunction::InterpolationPolicy::LeftExtreme});
         params_.PBUB_RV_.resize(numPvtRegions, Tabulated2DFunction{Tabulated2DFunction::InterpolationPolicy::LeftExtreme});
 
+        params_.oilTables_.resize(numPvtRegions, OilTableBundle{Tabulated2DFunction::InterpolationPolicy::LeftExtreme});
+        params_.gasTables_.resize(numPvtRegions, GasTableBundle{Tabulated2DFunction::InterpolationPolicy::LeftExtreme});
+
         params_.zLim_.resize(numPvtRegions);
 
         const bool extractCmpFromPvt = true; //<false>: Default values used in [*]
@@ -170,6 +176,9 @@ public:
             params_.PBUB_RS_[regionIdx].appendXPos(ZCO2);
             params_.PBUB_RV_[regionIdx].appendXPos(ZCO2);
 
+            params_.oilTables_[regionIdx].appendXPos(ZCO2);
+            params_.gasTables_[regionIdx].appendXPos(ZCO2);
+
             const auto& underSaturatedTable = pvtsolTable.getUnderSaturatedTable(outerIdx);
             size_t numRows = underSaturatedTable.numRows();
 
@@ -213,6 +222,8 @@ public:
                   params_.Y_[regionIdx].appendSamplePoint(outerIdx,po,yv);
                   params_.VISCO_[regionIdx].appendSamplePoint(outerIdx,po,mo);
                   params_.VISCG_[regionIdx].appendSamplePoint(outerIdx,po,mg);
+                  params_.oilTables_[regionIdx].appendSamplePoint(outerIdx, po, {mo, bo, rs, xv, yv});
+                  params_.gasTables_[regionIdx].appendSamplePoint(outerIdx, po, {mg, bg, rv});
                   break;
               }
 
@@ -231,6 +242,9 @@ public:
               params_.VISCO_[regionIdx].appendSamplePoint(outerIdx,po,mo);
               params_.VISCG_[regionIdx].appendSamplePoint(outerIdx,po,mg);
 
+              params_.oilTables_[regionIdx].appendSamplePoint(outerIdx, po, {mo, bo, rs, xv, yv});
+              params_.gasTables_[regionIdx].appendSamplePoint(outerIdx, po, {mg, bg, rv});
+
               // rs,rv -> pressure
               params_.PBUB_RS_[regionIdx].appendSamplePoint(outerIdx, rs, po);
               params_.PBUB_RV_[regionIdx].appendSamplePoint(outerIdx, rv, po);
@@ -474,6 +488,32 @@ public:
         }
     }
 
+    /*!
+     * \brief Returns the viscosity, the formation volume factor, the gas dissolution
+     *        factor and the X and Y volume fractions of the oil phase.
+     *
+     * The result is indexed by BlackOilExtboParams::oilViscosityIdx, boIdx, rsIdx,
+     * xVolumeIdx and yVolumeIdx. This is equivalent to calling the individual methods,
+     * but the tables are only searched once.
+     */
+    template <typename Value>
+    static std::array<Value, BlackOilExtboParams<Scalar>::numOilProperties>
+    oilProperties(unsigned pvtRegionIdx, const Value& pressure, const Value& z) {
+        return params_.oilTables_[pvtRegionIdx].eval(z, pressure, true);
+    }
+
+    /*!
+     * \brief Returns the viscosity, the formation volume factor and the oil vaporization
+     *        factor of the gas phase.
+     *
+     * The result is indexed by BlackOilExtboParams::gasViscosityIdx, bgIdx and rvIdx.
+     */
+    template <typename Value>
+    static std::array<Value, BlackOilExtboParams<Scalar>::numGasProperties>
+    gasProperties(unsigned pvtRegionIdx, const Value& pressure, const Value& z) {
+        return params_.gasTables_[pvtRegionIdx].eval(z, pressure, true);
+    }
+
     template <typename Value>
     static Value xVolume(unsigned pvtRegionIdx, const Value& pressure, const Value& z) {
         return params_.X_[pvtRegionIdx].eval(z, pressure, true);
@@ -571,6 +611,7 @@ class BlackOilExtboIntensiveQuantities
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
 
     using ExtboModule = BlackOilExtboModule<TypeTag>;
+    using ExtboParams = BlackOilExtboParams<Scalar>;
 
     enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
     static constexpr int zFractionIdx = Indices::zFractionIdx;
@@ -591,43 +632,48 @@ public:
                           unsigned timeIdx)
     {
         const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
+        const auto linearizationType = elemCtx.linearizationType();
         unsigned pvtRegionIdx = priVars.pvtRegionIndex();
         auto& fs = asImp_().fluidState_;
 
-        zFraction_ = priVars.makeEvaluation(zFractionIdx, timeIdx);
+        zFraction_ = priVars.makeEvaluation(zFractionIdx, timeIdx, linearizationType);
+
+        // the tables which are evaluated at the same position are looked up together
+        const auto oilProps = ExtboModule::oilProperties(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
+        const auto gasProps = ExtboModule::gasProperties(pvtRegionIdx, fs.pressure(gasPhaseIdx), zFraction_);
 
-        oilViscosity_ = ExtboModule::oilViscosity(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
-        gasViscosity_ = ExtboModule::gasViscosity(pvtRegionIdx, fs.pressure(gasPhaseIdx), zFraction_);
+        oilViscosity_ = oilProps[ExtboParams::oilViscosityIdx];
+        gasViscosity_ = gasProps[ExtboParams::gasViscosityIdx];
 
-        bo_ = ExtboModule::bo(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
-        bg_ = ExtboModule::bg(pvtRegionIdx, fs.pressure(gasPhaseIdx), zFraction_);
+        bo_ = oilProps[ExtboParams::boIdx];
+        bg_ = gasProps[ExtboParams::bgIdx];
 
         bz_ = ExtboModule::bg(pvtRegionIdx, fs.pressure(oilPhaseIdx), Evaluation{0.99});
 
         if (FluidSystem::enableDissolvedGas())
-            rs_ = ExtboModule::rs(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
+            rs_ = oilProps[ExtboParams::rsIdx];
         else
             rs_ = 0.0;
 
         if (FluidSystem::enableVaporizedOil())
-            rv_ = ExtboModule::rv(pvtRegionIdx, fs.pressure(gasPhaseIdx), zFraction_);
+            rv_ = gasProps[ExtboParams::rvIdx];
         else
             rv_ = 0.0;
 
-        xVolume_ = ExtboModule::xVolume(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
-        yVolume_ = ExtboModule::yVolume(pvtRegionIdx, fs.pressure(oilPhaseIdx), zFraction_);
+        xVolume_ = oilProps[ExtboParams::xVolumeIdx];
+        yVolume_ = oilProps[ExtboParams::yVolumeIdx];
 
         Evaluation pbub = fs.pressure(oilPhaseIdx);
 
         if (priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Sw) {
            static const Scalar thresholdWaterFilledCell = 1.0 - 1e-6;
-           Scalar sw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx).value();
+           Scalar sw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx, linearizationType).value();
            if (sw >= thresholdWaterFilledCell)
               rs_ = 0.0;  // water only, zero rs_ ...
         }
 
         if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Rs) {
-           rs_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+           rs_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx, linearizationType);
            const Evaluation zLim = ExtboModule::zLim(pvtRegionIdx);
            if (zFraction_ > zLim) {
              pbub = ExtboModule::pbubRs(pvtRegionIdx, zLim, rs_);
@@ -640,7 +686,7 @@ public:
         }
 
         if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Rv) {
-           rv_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+           rv_ = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx, linearizationType);
            Evaluation rvsat = ExtboModule::rv(pvtRegionIdx, pbub, zFraction_);
            bg_ = ExtboModule::bg(pvtRegionIdx, pbub, zFraction_) + ExtboModule::gasCmp(pvtRegionIdx, zFraction_)*(rv_-rvsat);
 
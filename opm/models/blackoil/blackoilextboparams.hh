@@ -35,6 +35,8 @@
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 
+#include <opm/models/utils/tabulated2dfunctionbundle.hh>
+
 #include <vector>
 
 namespace Opm {
@@ -45,6 +47,14 @@ struct BlackOilExtboParams {
     using TabulatedFunction = Tabulated1DFunction<Scalar>;
     using Tabulated2DFunction = UniformXTabulated2DFunction<Scalar>;
 
+    //! the indices of the properties in the bundle of tables evaluated at the oil pressure
+    enum { oilViscosityIdx, boIdx, rsIdx, xVolumeIdx, yVolumeIdx, numOilProperties };
+    //! the indices of the properties in the bundle of tables evaluated at the gas pressure
+    enum { gasViscosityIdx, bgIdx, rvIdx, numGasProperties };
+
+    using OilTableBundle = UniformXTabulated2DFunctionBundle<Scalar, numOilProperties>;
+    using GasTableBundle = UniformXTabulated2DFunctionBundle<Scalar, numGasProperties>;
+
     std::vector<Tabulated2DFunction> X_;
     std::vector<Tabulated2DFunction> Y_;
     std::vector<Tabulated2DFunction> PBUB_RS_;
@@ -56,6 +66,11 @@ struct BlackOilExtboParams {
     std::vector<Tabulated2DFunction> RS_;
     std::vector<Tabulated2DFunction> RV_;
 
+    // the tables above which are evaluated at the same position for each degree of
+    // freedom, stored such that they only need to be searched once
+    std::vector<OilTableBundle> oilTables_;
+    std::vector<GasTableBundle> gasTables_;
+
     std::vector<Scalar> zReferenceDensity_;
 
     std::vector<Scalar> zLim_;
@@ -492,7 +492,8 @@ public:
                                unsigned timeIdx)
     {
         const PrimaryVariables& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
-        foamConcentration_ = priVars.makeEvaluation(foamConcentrationIdx, timeIdx);
+        const auto linearizationType = elemCtx.linearizationType();
+        foamConcentration_ = priVars.makeEvaluation(foamConcentrationIdx, timeIdx, linearizationType);
         const auto& fs = asImp_().fluidState_;
 
         // Compute gas mobility reduction factor
@@ -29,6 +29,7 @@
 #define EWOMS_BLACK_OIL_INTENSIVE_QUANTITIES_HH
 
 #include "blackoilproperties.hh"
+#include "blackoilphaseconfig.hh"
 #include "blackoilsolventmodules.hh"
 #include "blackoilextbomodules.hh"
 #include "blackoilpolymermodules.hh"
@@ -49,10 +50,9 @@
 
 #include <opm/models/common/directionalmobility.hh>
 
-#include <opm/utility/CopyablePtr.hpp>
-
 #include <dune/common/fmatrix.hh>
 
+#include <array>
 #include <cstring>
 #include <utility>
 
@@ -86,6 +86,8 @@ class BlackOilIntensiveQuantities
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
     using MaterialLaw = GetPropType<TypeTag, Properties::MaterialLaw>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
@@ -129,7 +131,7 @@ class BlackOilIntensiveQuantities
     using DiffusionIntensiveQuantities = BlackOilDiffusionIntensiveQuantities<TypeTag, enableDiffusion>;
     using DispersionIntensiveQuantities = BlackOilDispersionIntensiveQuantities<TypeTag, enableDispersion>;
 
-    using DirectionalMobilityPtr = Opm::Utility::CopyablePtr<DirectionalMobility<TypeTag, Evaluation>>;
+    using DirectionalMobilityPtr = DirectionalMobilityStorage<TypeTag, Evaluation>;
     using BrineModule = BlackOilBrineModule<TypeTag>;
 
 
@@ -184,13 +186,13 @@ public:
         const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
         const auto& linearizationType = problem.model().linearizer().getLinearizationType();
         unsigned globalSpaceIdx = elemCtx.globalSpaceIndex(dofIdx, timeIdx);
-        Scalar RvMax = FluidSystem::enableVaporizedOil()
+        Scalar RvMax = PhaseConfig::enableVaporizedOil()
             ? problem.maxOilVaporizationFactor(timeIdx, globalSpaceIdx)
             : 0.0;
-        Scalar RsMax = FluidSystem::enableDissolvedGas()
+        Scalar RsMax = PhaseConfig::enableDissolvedGas()
             ? problem.maxGasDissolutionFactor(timeIdx, globalSpaceIdx)
             : 0.0;
-        Scalar RswMax = FluidSystem::enableDissolvedGasInWater()
+        Scalar RswMax = PhaseConfig::enableDissolvedGasInWater()
             ? problem.maxGasDissolutionFactor(timeIdx, globalSpaceIdx)
             : 0.0;
 
@@ -205,7 +207,7 @@ public:
         Evaluation Sw = 0.0;
         if constexpr (waterEnabled) {
             if (priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Sw) {
-                Sw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx);
+                Sw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx, linearizationType);
             } else if(priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Rsw ||
                       priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Disabled) {
                       // water is enabled but is not a primary variable i.e. one component/phase case
@@ -216,7 +218,7 @@ public:
         Evaluation Sg = 0.0;
         if constexpr (gasEnabled) {
             if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Sg) {
-                Sg = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+                Sg = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx, linearizationType);
             } else if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Rv) {
                 Sg = 1.0 - Sw;
             } else if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Disabled) {
@@ -236,21 +238,21 @@ public:
         // deal with solvent
         if constexpr (enableSolvent) {
             if(priVars.primaryVarsMeaningSolvent() == PrimaryVariables::SolventMeaning::Ss) {
-                if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
-                    So -= priVars.makeEvaluation(Indices::solventSaturationIdx, timeIdx);
-                } else if (FluidSystem::phaseIsActive(gasPhaseIdx)) {
-                    Sg -= priVars.makeEvaluation(Indices::solventSaturationIdx, timeIdx);
+                if (PhaseConfig::phaseIsActive(oilPhaseIdx)) {
+                    So -= priVars.makeEvaluation(Indices::solventSaturationIdx, timeIdx, linearizationType);
+                } else if (PhaseConfig::phaseIsActive(gasPhaseIdx)) {
+                    Sg -= priVars.makeEvaluation(Indices::solventSaturationIdx, timeIdx, linearizationType);
                 }
             }
         }
 
-        if (FluidSystem::phaseIsActive(waterPhaseIdx))
+        if (PhaseConfig::phaseIsActive(waterPhaseIdx))
             fluidState_.setSaturation(waterPhaseIdx, Sw);
 
-        if (FluidSystem::phaseIsActive(gasPhaseIdx))
+        if (PhaseConfig::phaseIsActive(gasPhaseIdx))
             fluidState_.setSaturation(gasPhaseIdx, Sg);
 
-        if (FluidSystem::phaseIsActive(oilPhaseIdx))
+        if (PhaseConfig::phaseIsActive(oilPhaseIdx))
             fluidState_.setSaturation(oilPhaseIdx, So);
 
         asImp_().solventPreSatFuncUpdate_(elemCtx, dofIdx, timeIdx);
@@ -264,32 +266,32 @@ public:
         // scaling the capillary pressure due to salt precipitation 
         if (BrineModule::hasPcfactTables() && priVars.primaryVarsMeaningBrine() == PrimaryVariables::BrineMeaning::Sp) {
             unsigned satnumRegionIdx = elemCtx.problem().satnumRegionIndex(elemCtx, dofIdx, timeIdx);
-            const Evaluation Sp = priVars.makeEvaluation(Indices::saltConcentrationIdx, timeIdx);
+            const Evaluation Sp = priVars.makeEvaluation(Indices::saltConcentrationIdx, timeIdx, linearizationType);
             const Evaluation porosityFactor  = min(1.0 - Sp, 1.0); //phi/phi_0
             const auto& pcfactTable = BrineModule::pcfactTable(satnumRegionIdx);
             const Evaluation pcFactor = pcfactTable.eval(porosityFactor, /*extrapolation=*/true);
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
-                if (FluidSystem::phaseIsActive(phaseIdx)) {
+                if (PhaseConfig::phaseIsActive(phaseIdx)) {
                     pC[phaseIdx] *= pcFactor;
                 }
         }
 
         // oil is the reference phase for pressure
         if (priVars.primaryVarsMeaningPressure() == PrimaryVariables::PressureMeaning::Pg) {
-            const Evaluation& pg = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx);
+            const Evaluation& pg = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx, linearizationType);
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
-                if (FluidSystem::phaseIsActive(phaseIdx))
+                if (PhaseConfig::phaseIsActive(phaseIdx))
                     fluidState_.setPressure(phaseIdx, pg + (pC[phaseIdx] - pC[gasPhaseIdx]));
         } else if (priVars.primaryVarsMeaningPressure() == PrimaryVariables::PressureMeaning::Pw) {
-            const Evaluation& pw = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx);
+            const Evaluation& pw = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx, linearizationType);
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
-                if (FluidSystem::phaseIsActive(phaseIdx))
+                if (PhaseConfig::phaseIsActive(phaseIdx))
                     fluidState_.setPressure(phaseIdx, pw + (pC[phaseIdx] - pC[waterPhaseIdx]));
         } else {
-            assert(FluidSystem::phaseIsActive(oilPhaseIdx));
-            const Evaluation& po = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx);
+            assert(PhaseConfig::phaseIsActive(oilPhaseIdx));
+            const Evaluation& po = priVars.makeEvaluation(Indices::pressureSwitchIdx, timeIdx, linearizationType);
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
-                if (FluidSystem::phaseIsActive(phaseIdx))
+                if (PhaseConfig::phaseIsActive(phaseIdx))
                     fluidState_.setPressure(phaseIdx, po + (pC[phaseIdx] - pC[oilPhaseIdx]));
         }
 
@@ -300,17 +302,17 @@ public:
         asImp_().zFractionUpdate_(elemCtx, dofIdx, timeIdx);
 
         Evaluation SoMax = 0.0;
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        if (PhaseConfig::phaseIsActive(FluidSystem::oilPhaseIdx)) {
             SoMax = max(fluidState_.saturation(oilPhaseIdx),
                         problem.maxOilSaturation(globalSpaceIdx));
         }
         // take the meaning of the switching primary variable into account for the gas
         // and oil phase compositions
         if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Rs) {
-            const auto& Rs = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+            const auto& Rs = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx, linearizationType);
             fluidState_.setRs(Rs);
         } else {
-            if (FluidSystem::enableDissolvedGas()) { // Add So > 0? i.e. if only water set rs = 0)
+            if (PhaseConfig::enableDissolvedGas()) { // Add So > 0? i.e. if only water set rs = 0)
                 const Evaluation& RsSat = enableExtbo ? asImp_().rs() :
                 FluidSystem::saturatedDissolutionFactor(fluidState_,
                                                         oilPhaseIdx,
@@ -322,10 +324,10 @@ public:
                 fluidState_.setRs(0.0);
         }
         if (priVars.primaryVarsMeaningGas() == PrimaryVariables::GasMeaning::Rv) {
-            const auto& Rv = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx);
+            const auto& Rv = priVars.makeEvaluation(Indices::compositionSwitchIdx, timeIdx, linearizationType);
             fluidState_.setRv(Rv);
         } else {
-            if (FluidSystem::enableVaporizedOil() ) { // Add Sg > 0? i.e. if only water set rv = 0)
+            if (PhaseConfig::enableVaporizedOil() ) { // Add Sg > 0? i.e. if only water set rv = 0)
                 const Evaluation& RvSat = enableExtbo ? asImp_().rv() :
                     FluidSystem::saturatedDissolutionFactor(fluidState_,
                                                             gasPhaseIdx,
@@ -338,10 +340,10 @@ public:
         }
 
         if (priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Rvw) {
-            const auto& Rvw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx);
+            const auto& Rvw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx, linearizationType);
             fluidState_.setRvw(Rvw);
         } else {
-            if (FluidSystem::enableVaporizedWater()) { // Add Sg > 0? i.e. if only water set rv = 0)
+            if (PhaseConfig::enableVaporizedWater()) { // Add Sg > 0? i.e. if only water set rv = 0)
                 const Evaluation& RvwSat = FluidSystem::saturatedVaporizationFactor(fluidState_,
                                                             gasPhaseIdx,
                                                             pvtRegionIdx);
@@ -350,10 +352,10 @@ public:
         }
 
         if (priVars.primaryVarsMeaningWater() == PrimaryVariables::WaterMeaning::Rsw) {
-            const auto& Rsw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx);
+            const auto& Rsw = priVars.makeEvaluation(Indices::waterSwitchIdx, timeIdx, linearizationType);
             fluidState_.setRsw(Rsw);
         } else {
-            if (FluidSystem::enableDissolvedGasInWater()) {
+            if (PhaseConfig::enableDissolvedGasInWater()) {
                 const Evaluation& RswSat = FluidSystem::saturatedDissolutionFactor(fluidState_,
                                                             waterPhaseIdx,
                                                             pvtRegionIdx);
@@ -363,22 +365,22 @@ public:
 
         typename FluidSystem::template ParameterCache<Evaluation> paramCache;
         paramCache.setRegionIndex(pvtRegionIdx);
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        if (PhaseConfig::phaseIsActive(FluidSystem::oilPhaseIdx)) {
             paramCache.setMaxOilSat(SoMax);
         }
         paramCache.updateAll(fluidState_);
 
         // compute the phase densities and transform the phase permeabilities into mobilities
         int nmobilities = 1;
-        std::vector<std::array<Evaluation,numPhases>*> mobilities = {&mobility_};
+        std::array<std::array<Evaluation,numPhases>*, 4> mobilities = {&mobility_};
         if (dirMob_) {
             for (int i=0; i<3; i++) {
+                mobilities[nmobilities] = &(dirMob_->getArray(i));
                 nmobilities += 1;
-                mobilities.push_back(&(dirMob_->getArray(i)));
             }
         }
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!PhaseConfig::phaseIsActive(phaseIdx))
                 continue;
             const auto& b = FluidSystem::inverseFormationVolumeFactor(fluidState_, phaseIdx, pvtRegionIdx);
             fluidState_.setInvB(phaseIdx, b);
@@ -399,10 +401,10 @@ public:
 
         // calculate the phase densities
         Evaluation rho;
-        if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
+        if (PhaseConfig::phaseIsActive(waterPhaseIdx)) {
             rho = fluidState_.invB(waterPhaseIdx);
             rho *= FluidSystem::referenceDensity(waterPhaseIdx, pvtRegionIdx);
-            if (FluidSystem::enableDissolvedGasInWater()) {
+            if (PhaseConfig::enableDissolvedGasInWater()) {
                 rho +=
                     fluidState_.invB(waterPhaseIdx) *
                     fluidState_.Rsw() *
@@ -411,16 +413,16 @@ public:
             fluidState_.setDensity(waterPhaseIdx, rho);
         }
 
-        if (FluidSystem::phaseIsActive(gasPhaseIdx)) {
+        if (PhaseConfig::phaseIsActive(gasPhaseIdx)) {
             rho = fluidState_.invB(gasPhaseIdx);
             rho *= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
-            if (FluidSystem::enableVaporizedOil()) {
+            if (PhaseConfig::enableVaporizedOil()) {
                 rho +=
                     fluidState_.invB(gasPhaseIdx) *
                     fluidState_.Rv() *
                     FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
             }
-            if (FluidSystem::enableVaporizedWater()) {
+            if (PhaseConfig::enableVaporizedWater()) {
                 rho +=
                     fluidState_.invB(gasPhaseIdx) *
                     fluidState_.Rvw() *
@@ -429,10 +431,10 @@ public:
             fluidState_.setDensity(gasPhaseIdx, rho);
         }
 
-        if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
+        if (PhaseConfig::phaseIsActive(oilPhaseIdx)) {
             rho = fluidState_.invB(oilPhaseIdx);
             rho *= FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
-            if (FluidSystem::enableDissolvedGas()) {
+            if (PhaseConfig::enableDissolvedGas()) {
                 rho +=
                     fluidState_.invB(oilPhaseIdx) *
                     fluidState_.Rs() *
@@ -451,9 +453,9 @@ public:
         if (rockCompressibility > 0.0) {
             Scalar rockRefPressure = problem.rockReferencePressure(globalSpaceIdx);
             Evaluation x;
-            if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
+            if (PhaseConfig::phaseIsActive(oilPhaseIdx)) {
                 x = rockCompressibility*(fluidState_.pressure(oilPhaseIdx) - rockRefPressure);
-            } else if (FluidSystem::phaseIsActive(waterPhaseIdx)){
+            } else if (PhaseConfig::phaseIsActive(waterPhaseIdx)){
                 x = rockCompressibility*(fluidState_.pressure(waterPhaseIdx) - rockRefPressure);
             } else {
                 x = rockCompressibility*(fluidState_.pressure(gasPhaseIdx) - rockRefPressure);
@@ -473,7 +475,7 @@ public:
 
         // deal with salt-precipitation
         if (enableSaltPrecipitation && priVars.primaryVarsMeaningBrine() == PrimaryVariables::BrineMeaning::Sp) {
-            Evaluation Sp = priVars.makeEvaluation(Indices::saltConcentrationIdx, timeIdx);
+            Evaluation Sp = priVars.makeEvaluation(Indices::saltConcentrationIdx, timeIdx, linearizationType);
             porosity_ *= (1.0 - Sp);
         }
 
@@ -500,7 +502,7 @@ public:
 #ifndef NDEBUG
         // some safety checks in debug mode
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!PhaseConfig::phaseIsActive(phaseIdx))
                 continue;
 
             assert(isfinite(fluidState_.density(phaseIdx)));
@@ -610,21 +612,8 @@ private:
     Evaluation rockCompTransMultiplier_;
     std::array<Evaluation,numPhases> mobility_;
 
-    // Instead of writing a custom copy constructor and a custom assignment operator just to handle
-    // the dirMob_ unique ptr member variable when copying BlackOilIntensiveQuantites (see for example
-    // updateIntensitiveQuantities_() in fvbaseelementcontext.hh for a copy example) we write the below
-    // custom wrapper class CopyablePtr which wraps the unique ptr and makes it copyable.
-    //
-    // The advantage of this approach is that we avoid having to call all the base class copy constructors and
-    // assignment operators explicitly (which is needed when writing the custom copy constructor and assignment
-    // operators) which could become a maintenance burden. For example, when adding a new base class (if that should
-    // be needed sometime in the future) to BlackOilIntensiveQuantites we could forget to update the copy
-    // constructor and assignment operators.
-    //
-    // We want each copy of the BlackOilIntensiveQuantites to be unique, (TODO: why?) so we have to make a copy
-    // of the unique_ptr each time we copy construct or assign to it from another BlackOilIntensiveQuantites.
-    // (On the other hand, if a copy could share the ptr with the original, a shared_ptr could be used instead and the
-    // wrapper would not be needed)
+    // the directional mobilities are stored inline, so copying the intensive quantities
+    // (e.g. when they are cached) does not need to allocate memory.
     DirectionalMobilityPtr dirMob_;
 };
 
@@ -29,6 +29,7 @@
 #define EWOMS_BLACK_OIL_LOCAL_RESIDUAL_HH
 
 #include "blackoilproperties.hh"
+#include "blackoilphaseconfig.hh"
 #include "blackoilsolventmodules.hh"
 #include "blackoilextbomodules.hh"
 #include "blackoilpolymermodules.hh"
@@ -58,6 +59,8 @@ class BlackOilLocalResidual : public GetPropType<TypeTag, Properties::DiscLocalR
     using EqVector = GetPropType<TypeTag, Properties::EqVector>;
     using RateVector = GetPropType<TypeTag, Properties::RateVector>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
 
     enum { conti0EqIdx = Indices::conti0EqIdx };
     enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
@@ -111,7 +114,7 @@ public:
         storage = 0.0;
 
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 if (Indices::numPhases == 3) { // add trivial equation for the pseudo phase
                     unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
                     if (timeIdx == 0)
@@ -131,7 +134,7 @@ public:
             storage[conti0EqIdx + activeCompIdx] += surfaceVolume;
 
             // account for dissolved gas
-            if (phaseIdx == oilPhaseIdx && FluidSystem::enableDissolvedGas()) {
+            if (phaseIdx == oilPhaseIdx && PhaseConfig::enableDissolvedGas()) {
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
                 storage[conti0EqIdx + activeGasCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rs())
@@ -139,7 +142,7 @@ public:
             }
 
             // account for dissolved gas in water phase
-            if (phaseIdx == waterPhaseIdx && FluidSystem::enableDissolvedGasInWater()) {
+            if (phaseIdx == waterPhaseIdx && PhaseConfig::enableDissolvedGasInWater()) {
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
                 storage[conti0EqIdx + activeGasCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rsw())
@@ -147,7 +150,7 @@ public:
             }
 
             // account for vaporized oil
-            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedOil()) {
+            if (phaseIdx == gasPhaseIdx && PhaseConfig::enableVaporizedOil()) {
                 unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
                 storage[conti0EqIdx + activeOilCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rv())
@@ -155,7 +158,7 @@ public:
             }
 
             // account for vaporized water
-            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedWater()) {
+            if (phaseIdx == gasPhaseIdx && PhaseConfig::enableVaporizedWater()) {
                 unsigned activeWaterCompIdx = Indices::canonicalToActiveComponentIndex(waterCompIdx);
                 storage[conti0EqIdx + activeWaterCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rvw())
@@ -202,7 +205,7 @@ public:
         const ExtensiveQuantities& extQuants = elemCtx.extensiveQuantities(scvfIdx, timeIdx);
         unsigned focusDofIdx = elemCtx.focusDofIndex();
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!PhaseConfig::phaseIsActive(phaseIdx))
                 continue;
 
             unsigned upIdx = static_cast<unsigned>(extQuants.upstreamIndex(phaseIdx));
@@ -281,7 +284,7 @@ public:
 
         if (phaseIdx == oilPhaseIdx) {
             // dissolved gas (in the oil phase).
-            if (FluidSystem::enableDissolvedGas()) {
+            if (PhaseConfig::enableDissolvedGas()) {
                 const auto& Rs = BlackOil::getRs_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
@@ -292,7 +295,7 @@ public:
             }
         } else if (phaseIdx == waterPhaseIdx) {
             // dissolved gas (in the water phase).
-            if (FluidSystem::enableDissolvedGasInWater()) {
+            if (PhaseConfig::enableDissolvedGasInWater()) {
                 const auto& Rsw = BlackOil::getRsw_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
@@ -304,7 +307,7 @@ public:
         }
         else if (phaseIdx == gasPhaseIdx) {
             // vaporized oil (in the gas phase).
-            if (FluidSystem::enableVaporizedOil()) {
+            if (PhaseConfig::enableVaporizedOil()) {
                 const auto& Rv = BlackOil::getRv_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
@@ -314,7 +317,7 @@ public:
                     flux[conti0EqIdx + activeOilCompIdx] += Rv*surfaceVolumeFlux*FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
             }
              // vaporized water (in the gas phase).
-            if (FluidSystem::enableVaporizedWater()) {
+            if (PhaseConfig::enableVaporizedWater()) {
                 const auto& Rvw = BlackOil::getRvw_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeWaterCompIdx = Indices::canonicalToActiveComponentIndex(waterCompIdx);
@@ -29,6 +29,7 @@
 #define EWOMS_BLACK_OIL_LOCAL_TPFA_RESIDUAL_HH
 
 #include "blackoilproperties.hh"
+#include "blackoilphaseconfig.hh"
 #include "blackoilsolventmodules.hh"
 #include "blackoilextbomodules.hh"
 #include "blackoilpolymermodules.hh"
@@ -61,6 +62,8 @@ class BlackOilLocalResidualTPFA : public GetPropType<TypeTag, Properties::DiscLo
     using EqVector = GetPropType<TypeTag, Properties::EqVector>;
     using RateVector = GetPropType<TypeTag, Properties::RateVector>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using Problem = GetPropType<TypeTag, Properties::Problem>;
     using FluidState = typename IntensiveQuantities::FluidState;
@@ -158,7 +161,7 @@ public:
         storage = 0.0;
 
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 continue;
             }
             unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
@@ -170,7 +173,7 @@ public:
             storage[conti0EqIdx + activeCompIdx] += surfaceVolume;
 
             // account for dissolved gas
-            if (phaseIdx == oilPhaseIdx && FluidSystem::enableDissolvedGas()) {
+            if (phaseIdx == oilPhaseIdx && PhaseConfig::enableDissolvedGas()) {
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
                 storage[conti0EqIdx + activeGasCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rs())
@@ -178,7 +181,7 @@ public:
             }
 
             // account for dissolved gas in water
-            if (phaseIdx == waterPhaseIdx && FluidSystem::enableDissolvedGasInWater()) {
+            if (phaseIdx == waterPhaseIdx && PhaseConfig::enableDissolvedGasInWater()) {
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
                 storage[conti0EqIdx + activeGasCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rsw())
@@ -186,7 +189,7 @@ public:
             }
 
             // account for vaporized oil
-            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedOil()) {
+            if (phaseIdx == gasPhaseIdx && PhaseConfig::enableVaporizedOil()) {
                 unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
                 storage[conti0EqIdx + activeOilCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rv())
@@ -194,7 +197,7 @@ public:
             }
 
             // account for vaporized water
-            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedWater()) {
+            if (phaseIdx == gasPhaseIdx && PhaseConfig::enableVaporizedWater()) {
                 unsigned activeWaterCompIdx = Indices::canonicalToActiveComponentIndex(waterCompIdx);
                 storage[conti0EqIdx + activeWaterCompIdx] +=
                     Toolbox::template decay<LhsEval>(intQuants.fluidState().Rvw())
@@ -341,7 +344,7 @@ public:
         FaceDir::DirEnum facedir = nbInfo.faceDir;
 
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
+            if (!PhaseConfig::phaseIsActive(phaseIdx))
                 continue;
             // darcy flux calculation
             short dnIdx;
@@ -562,7 +565,7 @@ public:
         ////////
         bdyFlux = 0.0;
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseConfig::phaseIsActive(phaseIdx)) {
                 continue;
             }
             const auto& pBoundary = bdyInfo.exFluidState.pressure(phaseIdx);
@@ -767,7 +770,7 @@ public:
 
         if (phaseIdx == oilPhaseIdx) {
             // dissolved gas (in the oil phase).
-            if (FluidSystem::enableDissolvedGas()) {
+            if (PhaseConfig::enableDissolvedGas()) {
                 const auto& Rs = BlackOil::getRs_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
@@ -778,7 +781,7 @@ public:
             }
         } else  if (phaseIdx == waterPhaseIdx) {
             // dissolved gas (in the water phase).
-            if (FluidSystem::enableDissolvedGasInWater()) {
+            if (PhaseConfig::enableDissolvedGasInWater()) {
                 const auto& Rsw = BlackOil::getRsw_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
@@ -790,7 +793,7 @@ public:
         }
         else if (phaseIdx == gasPhaseIdx) {
             // vaporized oil (in the gas phase).
-            if (FluidSystem::enableVaporizedOil()) {
+            if (PhaseConfig::enableVaporizedOil()) {
                 const auto& Rv = BlackOil::getRv_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
@@ -800,7 +803,7 @@ public:
                     flux[conti0EqIdx + activeOilCompIdx] += Rv*surfaceVolumeFlux*FluidSystem::referenceDensity(oilPhaseIdx, pvtRegionIdx);
             }
              // vaporized water (in the gas phase).
-            if (FluidSystem::enableVaporizedWater()) {
+            if (PhaseConfig::enableVaporizedWater()) {
                 const auto& Rvw = BlackOil::getRvw_<FluidSystem, FluidState, UpEval>(upFs, pvtRegionIdx);
 
                 unsigned activeWaterCompIdx = Indices::canonicalToActiveComponentIndex(waterCompIdx);
@@ -433,7 +433,7 @@ public:
         return params_.yieldGrowthCoefficient_;
     }
 
-    static const std::vector<Scalar> phi()
+    static const std::vector<Scalar>& phi()
     {
         return params_.phi_;
     }
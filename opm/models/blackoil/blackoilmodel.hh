@@ -45,6 +45,7 @@
 #include <opm/models/blackoil/blackoillocalresidual.hh>
 #include <opm/models/blackoil/blackoilmicpmodules.hh>
 #include <opm/models/blackoil/blackoilnewtonmethod.hh>
+#include <opm/models/blackoil/blackoilphaseconfig.hh>
 #include <opm/models/blackoil/blackoilpolymermodules.hh>
 #include <opm/models/blackoil/blackoilprimaryvariables.hh>
 #include <opm/models/blackoil/blackoilproblem.hh>
@@ -179,6 +180,11 @@ struct EnableDispersion<TypeTag, TTag::BlackOilModel> { static constexpr bool va
 template<class TypeTag>
 struct EnableConvectiveMixing<TypeTag, TTag::BlackOilModel> { static constexpr bool value = false; };
 
+//! by default, the active phases are determined by the fluid system at runtime
+template<class TypeTag>
+struct BlackOilPhaseConfiguration<TypeTag, TTag::BlackOilModel>
+{ static constexpr int value = BlackOilConfigMask::runtime; };
+
 //! by default, scale the energy equation by the inverse of the energy required to heat
 //! up one kg of water by 30 Kelvin. If we conserve surface volumes, this must be divided
 //! by the weight of one cubic meter of water. This is required to make the "dumb" linear
@@ -302,6 +308,8 @@ private:
     using DiffusionModule = BlackOilDiffusionModule<TypeTag, enableDiffusion>;
     using DispersionModule = BlackOilDispersionModule<TypeTag, enableDispersion>;
     using MICPModule = BlackOilMICPModule<TypeTag>;
+    using PhaseConfig = BlackOilPhaseConfig<FluidSystem,
+                                            getPropValue<TypeTag, Properties::BlackOilPhaseConfiguration>()>;
 
 public:
 
@@ -544,6 +552,19 @@ public:
         priVars.setPvtRegionIndex(pvtRegionIdx);
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::applyInitialSolution
+     */
+    void applyInitialSolution()
+    {
+        // the fluid system is initialized by the problem, so this is the first
+        // opportunity to make sure that it matches the configuration for which the
+        // kernels were compiled
+        PhaseConfig::checkFluidSystem();
+
+        ParentType::applyInitialSolution();
+    }
+
     /*!
      * \brief Deserializes the state of the model.
      *
@@ -554,6 +575,8 @@ public:
     template <class Restarter>
     void deserialize(Restarter& res)
     {
+        PhaseConfig::checkFluidSystem();
+
         ParentType::deserialize(res);
 
         // set the PVT indices of the primary variables. This is also done by writing
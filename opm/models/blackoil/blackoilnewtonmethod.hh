@@ -83,6 +83,10 @@ public:
         pressMin_ = Parameters::Get<Parameters::PressureMin<Scalar>>();
         waterSaturationMax_ = Parameters::Get<Parameters::MaximumWaterSaturation<Scalar>>();
         waterOnlyThreshold_ = Parameters::Get<Parameters::WaterOnlyThreshold<Scalar>>();
+
+        updateSucceeded_ = true;
+        numPriVarsSwitchedSlot_ = 0;
+        reducedNumPriVarsSwitched_ = 0;
     }
 
     /*!
@@ -131,9 +135,12 @@ public:
     /*!
      * \brief Returns the number of degrees of freedom for which the
      *        interpretation has changed for the most recent iteration.
+     *
+     * If the global reductions are packed, this refers to the most recent iteration
+     * for which the reduction has been finished.
      */
     unsigned numPriVarsSwitched() const
-    { return numPriVarsSwitched_; }
+    { return this->packReductions_() ? reducedNumPriVarsSwitched_ : numPriVarsSwitched_; }
 
 protected:
     friend NewtonMethod<TypeTag>;
@@ -145,6 +152,7 @@ protected:
     void beginIteration_()
     {
         numPriVarsSwitched_ = 0;
+        updateSucceeded_ = true;
         ParentType::beginIteration_();
     }
 
@@ -154,6 +162,18 @@ protected:
     void endIteration_(SolutionVector& uCurrentIter,
                        const SolutionVector& uLastIter)
     {
+        if (this->packReductions_()) {
+            // the number of switched DOFs is only available once the reduction is
+            // finished. it is thus not reported in the message of the iteration.
+            auto& reduction = this->endIterationReduction_();
+            reduction.addSuccessFlag(updateSucceeded_);
+            numPriVarsSwitchedSlot_ =
+                reduction.add(numPriVarsSwitched_, PackedAllReduce::Operation::Sum);
+
+            ParentType::endIteration_(uCurrentIter, uLastIter);
+            return;
+        }
+
 #if HAVE_MPI
         // in the MPI enabled case we need to add up the number of DOF
         // for which the interpretation changed over all processes.
@@ -172,6 +192,15 @@ protected:
         ParentType::endIteration_(uCurrentIter, uLastIter);
     }
 
+    /*!
+     * \copydoc NewtonMethod::endIterationReductionFinished_
+     */
+    void endIterationReductionFinished_()
+    {
+        reducedNumPriVarsSwitched_ =
+            static_cast<int>(this->endIterationReduction_().result(numPriVarsSwitchedSlot_));
+    }
+
 public:
     void update_(SolutionVector& nextSolution,
                  const SolutionVector& currentSolution,
@@ -191,6 +220,14 @@ public:
         catch (...) {
             succeeded = 0;
         }
+
+        if (this->packReductions_()) {
+            // the flag and the number of switched DOFs are reduced at the end of the
+            // iteration
+            updateSucceeded_ = succeeded;
+            return;
+        }
+
         succeeded = comm.min(succeeded);
 
         if (!succeeded)
@@ -429,6 +466,11 @@ protected:
 private:
     int numPriVarsSwitched_;
 
+    // the state of the iteration if the global reductions are packed
+    bool updateSucceeded_;
+    unsigned numPriVarsSwitchedSlot_;
+    int reducedNumPriVarsSwitched_;
+
     Scalar priVarOscilationThreshold_;
     Scalar waterSaturationMax_;
     Scalar waterOnlyThreshold_;
@@ -0,0 +1,224 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::BlackOilPhaseConfig
+ */
+#ifndef EWOMS_BLACK_OIL_PHASE_CONFIG_HH
+#define EWOMS_BLACK_OIL_PHASE_CONFIG_HH
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Opm {
+
+/*!
+ * \ingroup BlackOilModel
+ *
+ * \brief The bits which describe the active phases and the phase transfer
+ *        mechanisms of a black-oil configuration.
+ */
+struct BlackOilConfigMask
+{
+    //! The configuration is determined by the fluid system at runtime
+    static constexpr int runtime = -1;
+
+    static constexpr int water = 1 << 0;
+    static constexpr int oil = 1 << 1;
+    static constexpr int gas = 1 << 2;
+
+    static constexpr int dissolvedGas = 1 << 3;
+    static constexpr int vaporizedOil = 1 << 4;
+    static constexpr int dissolvedGasInWater = 1 << 5;
+    static constexpr int vaporizedWater = 1 << 6;
+
+    // some common configurations
+    static constexpr int oilWater = water | oil;
+    static constexpr int deadOilThreePhase = water | oil | gas;
+    static constexpr int liveOilThreePhase = water | oil | gas | dissolvedGas;
+    static constexpr int liveOilWetGasThreePhase = liveOilThreePhase | vaporizedOil;
+};
+
+/*!
+ * \ingroup BlackOilModel
+ *
+ * \brief Answers the questions about the active phases and the phase transfer
+ *        mechanisms which the black-oil kernels ask for every cell and face.
+ *
+ * If the configuration mask is BlackOilConfigMask::runtime, the questions are
+ * forwarded to the fluid system. Otherwise the answers are compile time constants, so
+ * the compiler removes the branches for inactive phases and disabled mechanisms from
+ * the kernels. In this case, checkFluidSystem() ensures that the fluid system which
+ * is used at runtime matches the configuration.
+ */
+template <class FluidSystem, int configMask>
+class BlackOilPhaseConfig
+{
+    static constexpr bool isStatic = configMask != BlackOilConfigMask::runtime;
+
+    static constexpr bool hasBit_(int bit)
+    { return (configMask & bit) != 0; }
+
+public:
+    static bool phaseIsActive(unsigned phaseIdx)
+    {
+        if constexpr (isStatic) {
+            if (phaseIdx == FluidSystem::waterPhaseIdx)
+                return hasBit_(BlackOilConfigMask::water);
+            else if (phaseIdx == FluidSystem::oilPhaseIdx)
+                return hasBit_(BlackOilConfigMask::oil);
+            else
+                return hasBit_(BlackOilConfigMask::gas);
+        }
+        else
+            return FluidSystem::phaseIsActive(phaseIdx);
+    }
+
+    static bool enableDissolvedGas()
+    {
+        if constexpr (isStatic)
+            return hasBit_(BlackOilConfigMask::dissolvedGas);
+        else
+            return FluidSystem::enableDissolvedGas();
+    }
+
+    static bool enableVaporizedOil()
+    {
+        if constexpr (isStatic)
+            return hasBit_(BlackOilConfigMask::vaporizedOil);
+        else
+            return FluidSystem::enableVaporizedOil();
+    }
+
+    static bool enableDissolvedGasInWater()
+    {
+        if constexpr (isStatic)
+            return hasBit_(BlackOilConfigMask::dissolvedGasInWater);
+        else
+            return FluidSystem::enableDissolvedGasInWater();
+    }
+
+    static bool enableVaporizedWater()
+    {
+        if constexpr (isStatic)
+            return hasBit_(BlackOilConfigMask::vaporizedWater);
+        else
+            return FluidSystem::enableVaporizedWater();
+    }
+
+    /*!
+     * \brief Returns the configuration mask of the fluid system.
+     */
+    static int fluidSystemMask()
+    {
+        int mask = 0;
+        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx))
+            mask |= BlackOilConfigMask::water;
+        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx))
+            mask |= BlackOilConfigMask::oil;
+        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx))
+            mask |= BlackOilConfigMask::gas;
+        if (FluidSystem::enableDissolvedGas())
+            mask |= BlackOilConfigMask::dissolvedGas;
+        if (FluidSystem::enableVaporizedOil())
+            mask |= BlackOilConfigMask::vaporizedOil;
+        if (FluidSystem::enableDissolvedGasInWater())
+            mask |= BlackOilConfigMask::dissolvedGasInWater;
+        if (FluidSystem::enableVaporizedWater())
+            mask |= BlackOilConfigMask::vaporizedWater;
+        return mask;
+    }
+
+    /*!
+     * \brief Throws if the fluid system does not match the compile time
+     *        configuration.
+     *
+     * This needs to be called after the fluid system has been initialized.
+     */
+    static void checkFluidSystem()
+    {
+        if constexpr (isStatic) {
+            const int mask = fluidSystemMask();
+            if (mask != configMask)
+                throw std::logic_error("The black-oil kernels were compiled for the phase "
+                                       "configuration " + std::to_string(configMask) +
+                                       ", but the fluid system uses the configuration " +
+                                       std::to_string(mask));
+        }
+    }
+};
+
+/*!
+ * \ingroup BlackOilModel
+ *
+ * \brief Calls a function with the compile time configuration which matches a runtime
+ *        configuration mask.
+ *
+ * The function is called with a std::integral_constant which holds the first of the
+ * candidate masks that is equal to the runtime mask, or BlackOilConfigMask::runtime if
+ * none of them matches. This allows applications to instantiate their black-oil type
+ * tags for the most common configurations and to fall back to the generic kernels for
+ * all others:
+ *
+ * \code
+ * int mask = BlackOilPhaseConfig<FluidSystem, BlackOilConfigMask::runtime>::fluidSystemMask();
+ * return dispatchBlackOilConfig<BlackOilConfigMask::oilWater,
+ *                               BlackOilConfigMask::liveOilThreePhase>(mask, [&](auto config)
+ *     { return runSimulator<decltype(config)::value>(argc, argv); });
+ * \endcode
+ */
+template <int... candidateMasks, class Fn>
+decltype(auto) dispatchBlackOilConfig(int runtimeMask, Fn&& fn);
+
+namespace detail {
+
+template <int firstMask, int... otherMasks>
+struct BlackOilConfigDispatcher
+{
+    template <class Fn>
+    static decltype(auto) dispatch(int runtimeMask, Fn&& fn)
+    {
+        if (runtimeMask == firstMask)
+            return fn(std::integral_constant<int, firstMask>{});
+        return dispatchBlackOilConfig<otherMasks...>(runtimeMask, std::forward<Fn>(fn));
+    }
+};
+
+} // namespace detail
+
+template <int... candidateMasks, class Fn>
+decltype(auto) dispatchBlackOilConfig(int runtimeMask, Fn&& fn)
+{
+    if constexpr (sizeof...(candidateMasks) == 0)
+        return fn(std::integral_constant<int, BlackOilConfigMask::runtime>{});
+    else
+        return detail::BlackOilConfigDispatcher<candidateMasks...>::dispatch(runtimeMask,
+                                                                            std::forward<Fn>(fn));
+}
+
+} // namespace Opm
+
+#endif
@@ -224,8 +224,15 @@ public:
         if (std::is_same<Evaluation, Scalar>::value)
             return (*this)[varIdx] * scale; // finite differences
         else {
-            // automatic differentiation
-            if (timeIdx == linearizationType.time)
+            // automatic differentiation. the sequential linearization types only
+            // consider either pressure or all other variables to be unknown
+            bool isVariable = timeIdx == linearizationType.time;
+            if (linearizationType.type == LinearizationType::pressure)
+                isVariable = isVariable && varIdx == pressureSwitchIdx;
+            else if (linearizationType.type == LinearizationType::seqtransport)
+                isVariable = isVariable && varIdx != pressureSwitchIdx;
+
+            if (isVariable)
                 return Toolbox::createVariable((*this)[varIdx], varIdx) * scale;
             else
                 return Toolbox::createConstant((*this)[varIdx]) * scale;
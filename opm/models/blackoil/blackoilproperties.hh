@@ -72,6 +72,12 @@ template<class TypeTag, class MyTypeTag>
 struct EnableMICP { using type = UndefinedProperty; };
 
 
+//! The active phases and phase transfer mechanisms for which the black-oil kernels are
+//! compiled. This is a bit mask of the BlackOilConfigMask values; BlackOilConfigMask::runtime
+//! means that the configuration of the fluid system is queried at runtime.
+template<class TypeTag, class MyTypeTag>
+struct BlackOilPhaseConfiguration { using type = UndefinedProperty; };
+
 //! Allow the spatial and temporal domains to exhibit non-constant temperature
 //! in the black-oil model
 template<class TypeTag, class MyTypeTag>
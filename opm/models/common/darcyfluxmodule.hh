@@ -40,6 +40,14 @@
 #include <opm/models/common/multiphasebaseparameters.hh>
 #include <opm/models/common/multiphasebaseproperties.hh>
 #include <opm/models/common/quantitycallbacks.hh>
+#include <opm/models/discretization/common/fvbasegradientcalculator.hh>
+#include <opm/models/utils/allocationaudit.hh>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 namespace Opm {
 
@@ -74,10 +82,142 @@ struct DarcyFluxModule
  * \ingroup FluxModules
  * \brief Provides the defaults for the parameters required by the
  *        Darcy velocity approach.
+ *
+ * If the problem declares its spatial parameters to be time invariant by defining a
+ * method spatialParametersAreTimeInvariant() which returns true, the intrinsic
+ * permeabilities and the geometric quantities of all interior faces of the grid are
+ * computed once and are used by the Darcy extensive quantities afterwards. This
+ * requires the grid, the intrinsic permeabilities and the positions of the degrees of
+ * freedom to stay the same during the simulation.
  */
 template <class TypeTag>
 class DarcyBaseProblem
-{ };
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using Problem = GetPropType<TypeTag, Properties::Problem>;
+
+    enum { dimWorld = GridView::dimensionworld };
+
+    using DimVector = Dune::FieldVector<Scalar, dimWorld>;
+    using DimMatrix = Dune::FieldMatrix<Scalar, dimWorld, dimWorld>;
+
+public:
+    /*!
+     * \brief The time invariant quantities of an interior face.
+     */
+    struct FaceQuantities
+    {
+        //! the intrinsic permeability of the face
+        DimMatrix intrinsicPermeability;
+        //! the vectors from the integration point to the interior and the exterior
+        //! degree of freedom
+        DimVector distVecIn;
+        DimVector distVecEx;
+        //! the vector from the interior to the exterior degree of freedom divided by
+        //! its squared length
+        DimVector gradientDirection;
+    };
+
+    DarcyBaseProblem()
+        : faceQuantitiesSize_(0)
+    {}
+
+    /*!
+     * \brief Returns true if the intrinsic permeabilities and the grid do not change
+     *        over time.
+     *
+     * This is false by default and can be overwritten by the problem.
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return false; }
+
+    /*!
+     * \brief Returns the precomputed quantities of an interior face or nullptr if the
+     *        spatial parameters of the problem are not time invariant.
+     *
+     * The quantities are computed for all elements of the grid the first time this
+     * method is called unless updateDarcyFaceQuantities() was called before.
+     */
+    template <class Context>
+    const FaceQuantities* darcyFaceQuantities(const Context& context, unsigned faceIdx) const
+    {
+        if (!static_cast<const Problem&>(*this).spatialParametersAreTimeInvariant())
+            return nullptr;
+
+        updateDarcyFaceQuantities(context.simulator());
+
+        const unsigned elemIdx = context.model().elementMapper().index(context.element());
+        return &faceQuantities_[elementFaceOffsets_[elemIdx] + faceIdx];
+    }
+
+    /*!
+     * \brief Computes the quantities of all interior faces of the grid if the spatial
+     *        parameters of the problem are time invariant and if this has not been
+     *        done for the current grid yet.
+     *
+     * This is called by MultiPhaseBaseProblem::updateCaches().
+     */
+    template <class Simulator>
+    void updateDarcyFaceQuantities(const Simulator& simulator) const
+    {
+        if (!static_cast<const Problem&>(*this).spatialParametersAreTimeInvariant())
+            return;
+
+        const std::size_t numElements = simulator.gridView().size(/*codim=*/0);
+        if (faceQuantitiesSize_.load(std::memory_order_acquire) != numElements) {
+            std::lock_guard<std::mutex> lock(faceQuantitiesMutex_);
+            if (elementFaceOffsets_.size() != numElements)
+                createFaceQuantities_(simulator);
+            faceQuantitiesSize_.store(numElements, std::memory_order_release);
+        }
+    }
+
+private:
+    template <class Simulator>
+    void createFaceQuantities_(const Simulator& simulator) const
+    {
+        const auto& problem = static_cast<const Problem&>(*this);
+        const auto& gridView = simulator.gridView();
+        const auto& elementMapper = simulator.model().elementMapper();
+
+        elementFaceOffsets_.resize(gridView.size(/*codim=*/0));
+        faceQuantities_.clear();
+
+        ElementContext elemCtx(simulator);
+        for (const auto& elem : elements(gridView)) {
+            elemCtx.updateStencil(elem);
+            elementFaceOffsets_[elementMapper.index(elem)] = faceQuantities_.size();
+
+            const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+            for (unsigned faceIdx = 0; faceIdx < stencil.numInteriorFaces(); ++faceIdx) {
+                const auto& scvf = stencil.interiorFace(faceIdx);
+                const unsigned i = scvf.interiorIndex();
+                const unsigned j = scvf.exteriorIndex();
+
+                FaceQuantities& faceQuants = faceQuantities_.emplace_back();
+                problem.intersectionIntrinsicPermeability(faceQuants.intrinsicPermeability,
+                                                          elemCtx, faceIdx, /*timeIdx=*/0);
+
+                const DimVector posIn = elemCtx.pos(i, /*timeIdx=*/0);
+                const DimVector posEx = elemCtx.pos(j, /*timeIdx=*/0);
+                faceQuants.distVecIn = posIn;
+                faceQuants.distVecIn -= scvf.integrationPos();
+                faceQuants.distVecEx = posEx;
+                faceQuants.distVecEx -= scvf.integrationPos();
+                faceQuants.gradientDirection = posEx;
+                faceQuants.gradientDirection -= posIn;
+                faceQuants.gradientDirection /= faceQuants.gradientDirection.two_norm2();
+            }
+        }
+    }
+
+    mutable std::vector<std::size_t> elementFaceOffsets_;
+    mutable std::vector<FaceQuantities> faceQuantities_;
+    mutable std::atomic<std::size_t> faceQuantitiesSize_;
+    mutable std::mutex faceQuantitiesMutex_;
+};
 
 /*!
  * \ingroup FluxModules
@@ -130,6 +270,12 @@ class DarcyExtensiveQuantities
     using DimVector = Dune::FieldVector<Scalar, dimWorld>;
     using DimMatrix = Dune::FieldMatrix<Scalar, dimWorld, dimWorld>;
 
+    using Problem = GetPropType<TypeTag, Properties::Problem>;
+    using FaceQuantities = typename DarcyBaseProblem<TypeTag>::FaceQuantities;
+    static constexpr bool usesTwoPointGradients =
+        std::is_same_v<GetPropType<TypeTag, Properties::GradientCalculator>,
+                       FvBaseGradientCalculator<TypeTag>>;
+
 public:
     /*!
      * \brief Returns the intrinsic permeability tensor for a given
@@ -196,6 +342,10 @@ protected:
         exteriorDofIdx_ = static_cast<short>(j);
         unsigned focusDofIdx = elemCtx.focusDofIndex();
 
+        const FaceQuantities* faceQuants = nullptr;
+        if constexpr (std::is_base_of_v<DarcyBaseProblem<TypeTag>, Problem>)
+            faceQuants = elemCtx.problem().darcyFaceQuantities(elemCtx, faceIdx);
+
         // calculate the "raw" pressure gradient
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             if (!elemCtx.model().phaseIsConsidered(phaseIdx)) {
@@ -204,10 +354,25 @@ protected:
             }
 
             pressureCallback.setPhaseIndex(phaseIdx);
-            gradCalc.calculateGradient(potentialGrad_[phaseIdx],
-                                       elemCtx,
-                                       faceIdx,
-                                       pressureCallback);
+            if (usesTwoPointGradients && faceQuants) {
+                // this is the same as FvBaseGradientCalculator::calculateGradient(), but
+                // with the precomputed direction of the gradient
+                Evaluation deltaP;
+                if (i == focusDofIdx)
+                    deltaP = Toolbox::value(pressureCallback(j)) - pressureCallback(i);
+                else if (j == focusDofIdx)
+                    deltaP = pressureCallback(j) - Toolbox::value(pressureCallback(i));
+                else
+                    deltaP = Toolbox::value(pressureCallback(j)) - Toolbox::value(pressureCallback(i));
+
+                for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
+                    potentialGrad_[phaseIdx][dimIdx] = deltaP*faceQuants->gradientDirection[dimIdx];
+            }
+            else
+                gradCalc.calculateGradient(potentialGrad_[phaseIdx],
+                                           elemCtx,
+                                           faceIdx,
+                                           pressureCallback);
             Valgrind::CheckDefined(potentialGrad_[phaseIdx]);
         }
 
@@ -221,19 +386,30 @@ protected:
             const auto& intQuantsIn = elemCtx.intensiveQuantities(i, timeIdx);
             const auto& intQuantsEx = elemCtx.intensiveQuantities(j, timeIdx);
 
-            const auto& posIn = elemCtx.pos(i, timeIdx);
-            const auto& posEx = elemCtx.pos(j, timeIdx);
-            const auto& posFace = scvf.integrationPos();
-
-            // the distance between the centers of the control volumes
-            DimVector distVecIn(posIn);
-            DimVector distVecEx(posEx);
-            DimVector distVecTotal(posEx);
-
-            distVecIn -= posFace;
-            distVecEx -= posFace;
-            distVecTotal -= posIn;
-            Scalar absDistTotalSquared = distVecTotal.two_norm2();
+            // the distances between the centers of the control volumes and the
+            // integration point, and the direction of the hydrostatic gradient
+            DimVector distVecIn;
+            DimVector distVecEx;
+            DimVector gradientDirection;
+            if (faceQuants) {
+                distVecIn = faceQuants->distVecIn;
+                distVecEx = faceQuants->distVecEx;
+                gradientDirection = faceQuants->gradientDirection;
+            }
+            else {
+                const auto& posIn = elemCtx.pos(i, timeIdx);
+                const auto& posEx = elemCtx.pos(j, timeIdx);
+                const auto& posFace = scvf.integrationPos();
+
+                distVecIn = posIn;
+                distVecEx = posEx;
+                gradientDirection = posEx;
+
+                distVecIn -= posFace;
+                distVecEx -= posFace;
+                gradientDirection -= posIn;
+                gradientDirection /= gradientDirection.two_norm2();
+            }
             for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
                 if (!elemCtx.model().phaseIsConsidered(phaseIdx))
                     continue;
@@ -271,8 +447,8 @@ protected:
                 // gradient exhibitis the same direction as the vector between the two
                 // control volume centers and the length (pStaticExterior -
                 // pStaticInterior)/distanceInteriorToExterior
-                Dune::FieldVector<Evaluation, dimWorld> f(distVecTotal);
-                f *= (pStatEx - pStatIn)/absDistTotalSquared;
+                Dune::FieldVector<Evaluation, dimWorld> f(gradientDirection);
+                f *= (pStatEx - pStatIn);
 
                 // calculate the final potential gradient
                 for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
@@ -280,6 +456,8 @@ protected:
 
                 for (unsigned dimIdx = 0; dimIdx < potentialGrad_[phaseIdx].size(); ++dimIdx) {
                     if (!isfinite(potentialGrad_[phaseIdx][dimIdx])) {
+                        // building the message allocates memory
+                        AllocationAudit::SuspendGuard suspendAudit;
                         throw NumericalProblem("Non-finite potential gradient for phase '"
                                                + std::string(FluidSystem::phaseName(phaseIdx))+"'");
                     }
@@ -288,7 +466,10 @@ protected:
         }
 
         Valgrind::SetUndefined(K_);
-        elemCtx.problem().intersectionIntrinsicPermeability(K_, elemCtx, faceIdx, timeIdx);
+        if (faceQuants)
+            K_ = faceQuants->intrinsicPermeability;
+        else
+            elemCtx.problem().intersectionIntrinsicPermeability(K_, elemCtx, faceIdx, timeIdx);
         Valgrind::CheckDefined(K_);
 
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
@@ -399,6 +580,8 @@ protected:
                 Valgrind::CheckDefined(potentialGrad_[phaseIdx]);
                 for (unsigned dimIdx = 0; dimIdx < potentialGrad_[phaseIdx].size(); ++dimIdx) {
                     if (!isfinite(potentialGrad_[phaseIdx][dimIdx])) {
+                        // building the message allocates memory
+                        AllocationAudit::SuspendGuard suspendAudit;
                         throw NumericalProblem("Non-finite potential gradient for phase '"
                                                + std::string(FluidSystem::phaseName(phaseIdx))+"'");
                     }
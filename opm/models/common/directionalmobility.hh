@@ -31,7 +31,10 @@
 #include <opm/material/densead/Evaluation.hpp>
 
 #include <array>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <utility>
 
 namespace Opm {
 template <class TypeTag, class Evaluation>
@@ -64,5 +67,63 @@ struct DirectionalMobility {
     array_type mobilityY_;
     array_type mobilityZ_;
 };
+
+/*!
+ * \brief Optional directional mobilities which are stored inline.
+ *
+ * This provides the pointer-like interface which the intensive quantities and the
+ * problems use for the directional mobilities, but unlike a heap-allocated pointer,
+ * copying the intensive quantities never allocates memory.
+ */
+template <class TypeTag, class Evaluation>
+class DirectionalMobilityStorage
+{
+    using Mobility = DirectionalMobility<TypeTag, Evaluation>;
+
+public:
+    DirectionalMobilityStorage() = default;
+
+    //! Assign the directional mobilities from a heap-allocated object. Prefer emplace().
+    DirectionalMobilityStorage& operator=(std::unique_ptr<Mobility>&& other)
+    {
+        if (other)
+            value_.emplace(*other);
+        else
+            value_.reset();
+        return *this;
+    }
+
+    //! Create the directional mobilities in place
+    template <class... Args>
+    Mobility& emplace(Args&&... args)
+    { return value_.emplace(std::forward<Args>(args)...); }
+
+    void reset()
+    { value_.reset(); }
+
+    explicit operator bool() const
+    { return value_.has_value(); }
+
+    Mobility* get()
+    { return value_ ? &*value_ : nullptr; }
+
+    const Mobility* get() const
+    { return value_ ? &*value_ : nullptr; }
+
+    Mobility* operator->()
+    { return &*value_; }
+
+    const Mobility* operator->() const
+    { return &*value_; }
+
+    Mobility& operator*()
+    { return *value_; }
+
+    const Mobility& operator*() const
+    { return *value_; }
+
+private:
+    std::optional<Mobility> value_;
+};
 } // namespace Opm
 #endif
@@ -35,13 +35,20 @@
 #include <opm/common/Exceptions.hpp>
 
 #include <opm/models/discretization/common/fvbaseproperties.hh>
+#include <opm/models/utils/allocationaudit.hh>
 
 #include <opm/material/common/Valgrind.hpp>
 
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 namespace Opm {
 template <class TypeTag>
@@ -75,14 +82,27 @@ struct ForchheimerFluxModule
  * \ingroup FluxModules
  * \brief Provides the defaults for the parameters required by the
  *        Forchheimer velocity approach.
+ *
+ * The precomputed face quantities of the Darcy module are also used by the
+ * Forchheimer module.
  */
 template <class TypeTag>
-class ForchheimerBaseProblem
+class ForchheimerBaseProblem : public DarcyBaseProblem<TypeTag>
 {
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+
+    enum { dimWorld = GridView::dimensionworld };
+    enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
+
+    using DimVector = Dune::FieldVector<Scalar, dimWorld>;
 
 public:
+    ForchheimerBaseProblem()
+        : velocityCacheSize_(0)
+    {}
+
     /*!
      * \brief Returns the Ergun coefficient.
      *
@@ -119,6 +139,43 @@ public:
     {
         return 1.0 / context.intensiveQuantities(spaceIdx, timeIdx).fluidState().viscosity(phaseIdx);
     }
+
+    /*!
+     * \brief Returns the filter velocities of all phases at an interior face of an
+     *        element which were determined by the last evaluation of the Forchheimer
+     *        relation at this face.
+     *
+     * The velocities are used as the initial guess for the next evaluation. They are
+     * NaN if the face has not been evaluated yet. Each element must only be
+     * processed by a single thread at a time.
+     */
+    template <class Context>
+    DimVector* forchheimerVelocityCache(const Context& context, unsigned faceIdx) const
+    {
+        const std::size_t numElements = context.gridView().size(/*codim=*/0);
+        if (velocityCacheSize_.load(std::memory_order_acquire) != numElements) {
+            std::lock_guard<std::mutex> lock(velocityCacheMutex_);
+            if (velocityCache_.size() != numElements) {
+                velocityCache_.clear();
+                velocityCache_.resize(numElements);
+            }
+            velocityCacheSize_.store(numElements, std::memory_order_release);
+        }
+
+        const unsigned elemIdx = context.model().elementMapper().index(context.element());
+        auto& elemCache = velocityCache_[elemIdx];
+        const std::size_t numFaces = context.numInteriorFaces(/*timeIdx=*/0);
+        if (elemCache.size() < numFaces*numPhases)
+            elemCache.resize(numFaces*numPhases,
+                             DimVector(std::numeric_limits<Scalar>::quiet_NaN()));
+
+        return &elemCache[faceIdx*numPhases];
+    }
+
+private:
+    mutable std::vector<std::vector<DimVector>> velocityCache_;
+    mutable std::atomic<std::size_t> velocityCacheSize_;
+    mutable std::mutex velocityCacheMutex_;
 };
 
 /*!
@@ -383,6 +440,12 @@ protected:
                 (getValue(intQuantsI.ergunCoefficient()) +
                  getValue(intQuantsJ.ergunCoefficient())) / 2;
 
+        // the velocities of the last evaluation at this face are used as the initial
+        // guess
+        DimVector* cachedVelocities = nullptr;
+        if (timeIdx == 0)
+            cachedVelocities = elemCtx.problem().forchheimerVelocityCache(elemCtx, scvfIdx);
+
         ///////////////
         // calculate the weights of the upstream and the downstream control volumes
         ///////////////
@@ -393,7 +456,8 @@ protected:
                 continue;
             }
 
-            calculateForchheimerFlux_(phaseIdx);
+            calculateForchheimerFlux_(phaseIdx,
+                                      cachedVelocities ? &cachedVelocities[phaseIdx] : nullptr);
 
             this->volumeFlux_[phaseIdx] = 0.0;
             for (unsigned dimIdx = 0; dimIdx < dimWorld; ++ dimIdx)
@@ -422,7 +486,7 @@ protected:
                 continue;
             }
 
-            calculateForchheimerFlux_(phaseIdx);
+            calculateForchheimerFlux_(phaseIdx, /*cachedVelocity=*/nullptr);
 
             this->volumeFlux_[phaseIdx] = 0.0;
             for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
@@ -431,35 +495,96 @@ protected:
         }
     }
 
-    void calculateForchheimerFlux_(unsigned phaseIdx)
+    /*!
+     * \brief Calculate the filter velocity of a phase.
+     *
+     * The Forchheimer relation is first solved using only the values of the
+     * quantities involved, starting from the cached velocity of the last evaluation or
+     * the Darcy velocity if there is none. A single Newton step in full automatic
+     * differentiation arithmetic then yields the derivatives of the velocity.
+     */
+    void calculateForchheimerFlux_(unsigned phaseIdx, DimVector* cachedVelocity)
     {
-        // initial guess: filter velocity is zero
-        DimEvalVector& velocity = this->filterVelocity_[phaseIdx];
-        velocity = 0.0;
-
-        // the change of velocity between two consecutive Newton iterations
-        DimEvalVector deltaV(1e5);
-        // the function value that is to be minimized of the equation that is to be
-        // fulfilled
-        DimEvalVector residual;
-        // derivative of equation that is to be solved
-        DimEvalMatrix gradResid;
+        // the quantities of the Forchheimer relation without derivatives
+        const Scalar mobility = Toolbox::value(this->mobility_[phaseIdx]);
+        const Scalar alphaFactor =
+            Toolbox::value(density_[phaseIdx])
+            * Toolbox::value(mobilityPassabilityRatio_[phaseIdx])
+            * Toolbox::value(ergunCoefficient_);
+        DimVector darcyTerm;
+        for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
+            darcyTerm[dimIdx] =
+                mobility*Toolbox::value(this->potentialGrad_[phaseIdx][dimIdx])*this->K_[dimIdx][dimIdx];
+
+        // initial guess: the velocity of the last evaluation or the Darcy velocity
+        DimVector velocity;
+        if (cachedVelocity && !std::isnan((*cachedVelocity)[0]))
+            velocity = *cachedVelocity;
+        else {
+            velocity = darcyTerm;
+            velocity *= -1.0;
+        }
 
         // search by means of the Newton method for a root of Forchheimer equation
+        DimVector residual;
+        DimMatrix gradResid;
+        DimVector deltaV(1e5);
         unsigned newtonIter = 0;
         while (deltaV.one_norm() > 1e-11) {
-            if (newtonIter >= 50)
+            if (newtonIter >= 50) {
+                // building the message allocates memory
+                AllocationAudit::SuspendGuard suspendAudit;
                 throw NumericalProblem("Could not determine Forchheimer velocity within "
                                        + std::to_string(newtonIter)+" iterations");
+            }
             ++newtonIter;
 
-            // calculate the residual and its Jacobian matrix
-            gradForchheimerResid_(residual, gradResid, phaseIdx);
-
-            // newton method
+            forchheimerScalarResid_(residual, gradResid, velocity, darcyTerm, alphaFactor);
             gradResid.solve(deltaV, residual);
             velocity -= deltaV;
         }
+
+        if (cachedVelocity)
+            *cachedVelocity = velocity;
+
+        DimEvalVector& evalVelocity = this->filterVelocity_[phaseIdx];
+        for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
+            evalVelocity[dimIdx] = velocity[dimIdx];
+
+        if constexpr (!std::is_same_v<Evaluation, Scalar>) {
+            // the value of the residual vanishes, so a single Newton step using the
+            // Jacobian of the converged solution yields the derivatives of the velocity
+            // (implicit function theorem)
+            forchheimerScalarResid_(residual, gradResid, velocity, darcyTerm, alphaFactor);
+            gradResid.invert();
+
+            DimEvalVector evalResidual;
+            forchheimerResid_(evalResidual, phaseIdx);
+            for (unsigned i = 0; i < dimWorld; ++i)
+                for (unsigned j = 0; j < dimWorld; ++j)
+                    evalVelocity[i] -= gradResid[i][j]*evalResidual[j];
+        }
+    }
+
+    // the residual of the Forchheimer relation and its Jacobian matrix without the
+    // derivatives of the quantities involved
+    void forchheimerScalarResid_(DimVector& residual,
+                                 DimMatrix& gradResid,
+                                 const DimVector& velocity,
+                                 const DimVector& darcyTerm,
+                                 Scalar alphaFactor) const
+    {
+        const Scalar absVel = velocity.two_norm();
+        for (unsigned i = 0; i < dimWorld; ++i) {
+            residual[i] = velocity[i] + darcyTerm[i] + sqrtK_[i]*alphaFactor*absVel*velocity[i];
+
+            for (unsigned j = 0; j < dimWorld; ++j) {
+                gradResid[i][j] = 0.0;
+                if (absVel > 0.0)
+                    gradResid[i][j] = sqrtK_[i]*alphaFactor*velocity[i]*velocity[j]/absVel;
+            }
+            gradResid[i][i] += 1.0 + sqrtK_[i]*alphaFactor*absVel;
+        }
     }
 
     void forchheimerResid_(DimEvalVector& residual, unsigned phaseIdx) const
@@ -509,27 +634,6 @@ protected:
         Valgrind::CheckDefined(residual);
     }
 
-    void gradForchheimerResid_(DimEvalVector& residual,
-                               DimEvalMatrix& gradResid,
-                               unsigned phaseIdx)
-    {
-        // TODO (?) use AD for this.
-        DimEvalVector& velocity = this->filterVelocity_[phaseIdx];
-        forchheimerResid_(residual, phaseIdx);
-
-        Scalar eps = 1e-11;
-        DimEvalVector tmp;
-        for (unsigned i = 0; i < dimWorld; ++i) {
-            Scalar coordEps = std::max(eps, Toolbox::scalarValue(velocity[i]) * (1 + eps));
-            velocity[i] += coordEps;
-            forchheimerResid_(tmp, phaseIdx);
-            tmp -= residual;
-            tmp /= coordEps;
-            gradResid[i] = tmp;
-            velocity[i] -= coordEps;
-        }
-    }
-
     /*!
      * \brief Check whether all off-diagonal entries of a tensor are zero.
      *
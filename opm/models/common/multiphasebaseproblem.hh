@@ -37,6 +37,7 @@
 #include <opm/material/common/Means.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 
+#include <opm/models/common/darcyfluxmodule.hh>
 #include <opm/models/common/directionalmobility.hh>
 #include <opm/models/common/multiphasebaseparameters.hh>
 #include <opm/models/common/multiphasebaseproperties.hh>
@@ -46,6 +47,16 @@
 
 #include <opm/utility/CopyablePtr.hpp>
 
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
 namespace Opm {
 /*!
  * \ingroup Discretization
@@ -60,6 +71,7 @@ class MultiPhaseBaseProblem
 {
 //! \cond SKIP_THIS
     using ParentType = FvBaseProblem<TypeTag>;
+    using FluxBaseProblem = typename GetPropType<TypeTag, Properties::FluxModule>::FluxBaseProblem;
 
     using Implementation = GetPropType<TypeTag, Properties::Problem>;
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
@@ -70,7 +82,7 @@ class MultiPhaseBaseProblem
     using SolidEnergyLawParams = GetPropType<TypeTag, Properties::SolidEnergyLawParams>;
     using ThermalConductionLawParams = GetPropType<TypeTag, Properties::ThermalConductionLawParams>;
     using MaterialLawParams = typename GetPropType<TypeTag, Properties::MaterialLaw>::Params;
-    using DirectionalMobilityPtr = Opm::Utility::CopyablePtr<DirectionalMobility<TypeTag, Evaluation>>;
+    using DirectionalMobilityPtr = DirectionalMobilityStorage<TypeTag, Evaluation>;
 
     enum { dimWorld = GridView::dimensionworld };
     enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
@@ -114,8 +126,8 @@ public:
     {
         const auto& scvf = context.stencil(timeIdx).interiorFace(intersectionIdx);
 
-        const DimMatrix& K1 = asImp_().intrinsicPermeability(context, scvf.interiorIndex(), timeIdx);
-        const DimMatrix& K2 = asImp_().intrinsicPermeability(context, scvf.exteriorIndex(), timeIdx);
+        const DimMatrix& K1 = cachedIntrinsicPermeability(context, scvf.interiorIndex(), timeIdx);
+        const DimMatrix& K2 = cachedIntrinsicPermeability(context, scvf.exteriorIndex(), timeIdx);
 
         // entry-wise harmonic mean. this is almost certainly wrong if
         // you have off-main diagonal entries in your permeabilities!
@@ -124,6 +136,122 @@ public:
                 result[i][j] = harmonicMean(K1[i][j], K2[i][j]);
     }
 
+    /*!
+     * \brief Returns true if the spatial parameters of the problem do not change over
+     *        time.
+     *
+     * If this is true, the intrinsic permeability, the porosity and the material law
+     * parameters of each degree of freedom are only determined once by calling the
+     * respective context-based methods of the problem. The intensive quantities and
+     * the flux modules then use the cached values via cachedIntrinsicPermeability(),
+     * cachedPorosity() and cachedMaterialLawParams(). Since the permeabilities and the
+     * material law parameters are cached by address, their values may change, but the
+     * objects which are returned for a degree of freedom must stay the same. Also, the
+     * grid must not change. The Darcy and Forchheimer flux modules additionally
+     * precompute the quantities of the faces in this case. This is false by default
+     * and can be overwritten by the problem.
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return false; }
+
+    /*!
+     * \brief Create the caches of the time invariant spatial parameters and of the
+     *        face quantities of the Darcy flux module if they are not up to date.
+     *
+     * Otherwise, they are created when they are accessed for the first time.
+     */
+    void updateCaches() const
+    {
+        ParentType::updateCaches();
+
+        if (!asImp_().spatialParametersAreTimeInvariant())
+            return;
+
+        updateSpatialParameterCache_();
+        if constexpr (std::is_base_of_v<DarcyBaseProblem<TypeTag>, FluxBaseProblem>)
+            FluxBaseProblem::updateDarcyFaceQuantities(this->simulator());
+    }
+
+    /*!
+     * \brief The spatial parameters of a degree of freedom if the problem declares
+     *        them to be time invariant.
+     */
+    struct SpatialParameters
+    {
+        const DimMatrix* intrinsicPermeability;
+        const MaterialLawParams* materialLawParams;
+        Scalar porosity;
+    };
+
+    /*!
+     * \brief Returns the index of the spatial parameters of a degree of freedom in the
+     *        table of distinct parameters.
+     *
+     * This may only be called if spatialParametersAreTimeInvariant() is true.
+     */
+    unsigned spatialParameterIndex(unsigned globalDofIdx) const
+    {
+        updateSpatialParameterCache_();
+        return dofSpatialParameterIndex_[globalDofIdx];
+    }
+
+    /*!
+     * \brief Returns the spatial parameters which belong to an index.
+     *
+     * The number of distinct parameters is usually small, e.g., one entry per
+     * material of the domain.
+     */
+    const SpatialParameters& spatialParameters(unsigned spatialParameterIdx) const
+    { return spatialParameterTable_[spatialParameterIdx]; }
+
+    /*!
+     * \brief Returns the intrinsic permeability of a degree of freedom, using the
+     *        cached value if the spatial parameters are time invariant.
+     */
+    template <class Context>
+    const DimMatrix& cachedIntrinsicPermeability(const Context& context,
+                                                 unsigned spaceIdx,
+                                                 unsigned timeIdx) const
+    {
+        if (!asImp_().spatialParametersAreTimeInvariant())
+            return asImp_().intrinsicPermeability(context, spaceIdx, timeIdx);
+
+        const unsigned globalIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        return *spatialParameters(spatialParameterIndex(globalIdx)).intrinsicPermeability;
+    }
+
+    /*!
+     * \brief Returns the porosity of a degree of freedom, using the cached value if the
+     *        spatial parameters are time invariant.
+     */
+    template <class Context>
+    Scalar cachedPorosity(const Context& context,
+                          unsigned spaceIdx,
+                          unsigned timeIdx) const
+    {
+        if (!asImp_().spatialParametersAreTimeInvariant())
+            return asImp_().porosity(context, spaceIdx, timeIdx);
+
+        const unsigned globalIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        return spatialParameters(spatialParameterIndex(globalIdx)).porosity;
+    }
+
+    /*!
+     * \brief Returns the material law parameters of a degree of freedom, using the
+     *        cached value if the spatial parameters are time invariant.
+     */
+    template <class Context>
+    const MaterialLawParams& cachedMaterialLawParams(const Context& context,
+                                                     unsigned spaceIdx,
+                                                     unsigned timeIdx) const
+    {
+        if (!asImp_().spatialParametersAreTimeInvariant())
+            return asImp_().materialLawParams(context, spaceIdx, timeIdx);
+
+        const unsigned globalIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        return *spatialParameters(spatialParameterIndex(globalIdx)).materialLawParams;
+    }
+
     /*!
      * \name Problem parameters
      */
@@ -260,6 +388,32 @@ public:
                         [[maybe_unused]] unsigned globalSpaceIdx) const
     {}
 
+    /*!
+     * \brief Update the relative permeabilities using heap-allocated directional
+     *        mobilities.
+     *
+     * This overload is kept for code which still uses Opm::Utility::CopyablePtr for
+     * the directional mobilities. It forwards to the overload which uses
+     * DirectionalMobilityStorage and thus needs to copy the directional mobilities.
+     */
+    template <class FluidState>
+    void updateRelperms(std::array<Evaluation,numPhases>& mobility,
+                        Opm::Utility::CopyablePtr<DirectionalMobility<TypeTag, Evaluation>>& dirMob,
+                        FluidState& fluidState,
+                        unsigned globalSpaceIdx) const
+    {
+        DirectionalMobilityPtr dirMobStorage;
+        if (dirMob)
+            dirMobStorage.emplace(*dirMob);
+
+        asImp_().updateRelperms(mobility, dirMobStorage, fluidState, globalSpaceIdx);
+
+        if (dirMobStorage)
+            dirMob = std::make_unique<DirectionalMobility<TypeTag, Evaluation>>(*dirMobStorage);
+        else
+            dirMob = std::unique_ptr<DirectionalMobility<TypeTag, Evaluation>>();
+    }
+
     /*!
      * \brief Returns the temperature \f$\mathrm{[K]}\f$ within a control volume.
      *
@@ -402,6 +556,57 @@ private:
             gravity_[dimWorld-1]  = -9.81;
         }
     }
+
+    void updateSpatialParameterCache_() const
+    {
+        const std::size_t numDof = this->model().numGridDof();
+        if (spatialParametersSize_.load(std::memory_order_acquire) != numDof) {
+            std::lock_guard<std::mutex> lock(spatialParametersMutex_);
+            if (dofSpatialParameterIndex_.size() != numDof)
+                createSpatialParameterCache_();
+            spatialParametersSize_.store(numDof, std::memory_order_release);
+        }
+    }
+
+    // evaluate the spatial parameters of all degrees of freedom and store the distinct
+    // ones in a table. the parameters of a degree of freedom are assumed not to depend
+    // on the element from which they are requested.
+    void createSpatialParameterCache_() const
+    {
+        constexpr unsigned invalidIdx = std::numeric_limits<unsigned>::max();
+        using Key = std::tuple<const DimMatrix*, const MaterialLawParams*, Scalar>;
+
+        dofSpatialParameterIndex_.assign(this->model().numGridDof(), invalidIdx);
+        spatialParameterTable_.clear();
+
+        std::map<Key, unsigned> parameterIndex;
+        ElementContext elemCtx(this->simulator());
+        for (const auto& elem : elements(this->gridView())) {
+            elemCtx.updateStencil(elem);
+            for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
+                const unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                if (dofSpatialParameterIndex_[globalIdx] != invalidIdx)
+                    continue;
+
+                const SpatialParameters params {
+                    &asImp_().intrinsicPermeability(elemCtx, dofIdx, /*timeIdx=*/0),
+                    &asImp_().materialLawParams(elemCtx, dofIdx, /*timeIdx=*/0),
+                    asImp_().porosity(elemCtx, dofIdx, /*timeIdx=*/0)
+                };
+
+                const Key key(params.intrinsicPermeability, params.materialLawParams, params.porosity);
+                const auto [it, inserted] = parameterIndex.emplace(key, spatialParameterTable_.size());
+                if (inserted)
+                    spatialParameterTable_.push_back(params);
+                dofSpatialParameterIndex_[globalIdx] = it->second;
+            }
+        }
+    }
+
+    mutable std::vector<unsigned> dofSpatialParameterIndex_;
+    mutable std::vector<SpatialParameters> spatialParameterTable_;
+    mutable std::atomic<std::size_t> spatialParametersSize_{0};
+    mutable std::mutex spatialParametersMutex_;
 };
 
 } // namespace Opm
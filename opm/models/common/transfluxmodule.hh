@@ -397,9 +397,9 @@ protected:
                 // compute the phase mobility using the material law parameters of the
                 // interior element. \todo {this could probably be done more efficiently}
                 const auto& matParams =
-                    elemCtx.problem().materialLawParams(elemCtx,
-                                                        interiorDofIdx_,
-                                                        /*timeIdx=*/0);
+                    elemCtx.problem().cachedMaterialLawParams(elemCtx,
+                                                              interiorDofIdx_,
+                                                              /*timeIdx=*/0);
                 std::array<typename FluidState::Scalar,numPhases> kr;
                 MaterialLaw::relativePermeabilities(kr, matParams, exFluidState);
 
@@ -435,8 +435,8 @@ private:
 
         Scalar distSquaredIn = distVec0 * distVec0;
         Scalar distSquaredExt = distVec1 * distVec1;
-        const auto& K0mat = elemCtx.problem().intrinsicPermeability(elemCtx, face.interiorIndex(), timeIdx);
-        const auto& K1mat = elemCtx.problem().intrinsicPermeability(elemCtx, face.exteriorIndex(), timeIdx);
+        const auto& K0mat = elemCtx.problem().cachedIntrinsicPermeability(elemCtx, face.interiorIndex(), timeIdx);
+        const auto& K1mat = elemCtx.problem().cachedIntrinsicPermeability(elemCtx, face.exteriorIndex(), timeIdx);
         // the permeability per definition aligns with the grid
         // we only support diagonal permeability tensor
         // and can therefore neglect off-diagonal values
@@ -462,7 +462,7 @@ private:
         auto distVec0 = face.integrationPos() - interiorPos;
         Scalar ndotDistIn = face.normal() * distVec0;
         Scalar distSquaredIn = distVec0 * distVec0;
-        const auto& K0mat = elemCtx.problem().intrinsicPermeability(elemCtx, face.interiorIndex(), timeIdx);
+        const auto& K0mat = elemCtx.problem().cachedIntrinsicPermeability(elemCtx, face.interiorIndex(), timeIdx);
         // the permeability per definition aligns with the grid
         // we only support diagonal permeability tensor
         // and can therefore neglect off-diagonal values
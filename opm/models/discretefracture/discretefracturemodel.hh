@@ -128,6 +128,10 @@ public:
             throw std::runtime_error("The discrete fracture model does not work in conjunction "
                                      "with intensive quantities caching");
         }
+
+        // the fractures are specified in terms of the vertex indices of the grid, so
+        // they need to follow the reordering of the degrees of freedom
+        simulator.vanguard().fractureMapper().permute(this->vertexMapper().permutation());
     }
 
     /*!
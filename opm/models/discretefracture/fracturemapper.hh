@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <set>
+#include <utility>
 
 namespace Opm {
 
@@ -98,6 +99,34 @@ public:
         return fractureEdges_.count(tmp) > 0;
     }
 
+    /*!
+     * \brief Renumber the vertices of the fractures.
+     *
+     * This is required if the degrees of freedom of the model are reordered, because
+     * the fractures are specified using the vertex indices in grid order.
+     *
+     * \param permutation The new index of each vertex. If it is empty, the indices
+     *                    are not changed.
+     */
+    template <class IndexVector>
+    void permute(const IndexVector& permutation)
+    {
+        if (permutation.empty())
+            return;
+
+        std::set<FractureEdge> fractureEdges;
+        for (const auto& edge : fractureEdges_)
+            fractureEdges.insert(FractureEdge(static_cast<unsigned>(permutation[edge.i_]),
+                                              static_cast<unsigned>(permutation[edge.j_])));
+
+        std::set<unsigned> fractureVertices;
+        for (const unsigned vertexIdx : fractureVertices_)
+            fractureVertices.insert(static_cast<unsigned>(permutation[vertexIdx]));
+
+        fractureEdges_ = std::move(fractureEdges);
+        fractureVertices_ = std::move(fractureVertices);
+    }
+
 private:
     std::set<FractureEdge> fractureEdges_;
     std::set<unsigned> fractureVertices_;
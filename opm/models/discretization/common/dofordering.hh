@@ -0,0 +1,399 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Orderings of the degrees of freedom which improve the locality of the
+ *        memory accesses.
+ */
+#ifndef EWOMS_DOF_ORDERING_HH
+#define EWOMS_DOF_ORDERING_HH
+
+#include <dune/geometry/dimension.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief The orderings of the degrees of freedom which are available.
+ */
+enum class DofOrdering
+{
+    //! keep the order of the grid
+    none,
+    //! reverse Cuthill-McKee ordering of the connectivity graph
+    reverseCuthillMcKee,
+    //! the order along a Morton (Z-order) curve through the centers of the entities
+    morton
+};
+
+/*!
+ * \brief Parse an ordering of the degrees of freedom from a string.
+ *
+ * The supported values are "none", "rcm" and "morton".
+ */
+inline DofOrdering parseDofOrdering(const std::string& name)
+{
+    if (name == "none" || name.empty())
+        return DofOrdering::none;
+    else if (name == "rcm")
+        return DofOrdering::reverseCuthillMcKee;
+    else if (name == "morton")
+        return DofOrdering::morton;
+
+    throw std::invalid_argument("Unknown ordering of the degrees of freedom '" + name + "'");
+}
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief The graph of the connections between the degrees of freedom in compressed
+ *        row format.
+ *
+ * The neighbors of vertex i are neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1].
+ */
+struct DofGraph
+{
+    std::vector<std::size_t> offsets{0};
+    std::vector<unsigned> neighbors;
+
+    std::size_t numVertices() const
+    { return offsets.size() - 1; }
+
+    std::size_t degree(std::size_t vertexIdx) const
+    { return offsets[vertexIdx + 1] - offsets[vertexIdx]; }
+};
+
+/*!
+ * \brief Compute the reverse Cuthill-McKee ordering of a graph.
+ *
+ * Each connected component is numbered by a breadth first search which starts at a
+ * pseudo-peripheral vertex, and visits the neighbors of each vertex in the order of
+ * increasing degree. Returns the new index of each vertex.
+ */
+inline std::vector<unsigned> reverseCuthillMcKeeOrdering(const DofGraph& graph)
+{
+    const std::size_t numVertices = graph.numVertices();
+    std::vector<unsigned> order;
+    order.reserve(numVertices);
+
+    std::vector<int> level(numVertices, -1);
+    std::vector<bool> visited(numVertices, false);
+    std::vector<unsigned> queue;
+    queue.reserve(numVertices);
+
+    // breadth first search over the vertices which have not been numbered yet. returns
+    // the vertices of the last level.
+    const auto levelStructure = [&](unsigned root, std::vector<unsigned>& lastLevel)
+    {
+        queue.clear();
+        queue.push_back(root);
+        level[root] = 0;
+        for (std::size_t queueIdx = 0; queueIdx < queue.size(); ++queueIdx) {
+            const unsigned vertexIdx = queue[queueIdx];
+            for (std::size_t i = graph.offsets[vertexIdx]; i < graph.offsets[vertexIdx + 1]; ++i) {
+                const unsigned neighborIdx = graph.neighbors[i];
+                if (!visited[neighborIdx] && level[neighborIdx] < 0) {
+                    level[neighborIdx] = level[vertexIdx] + 1;
+                    queue.push_back(neighborIdx);
+                }
+            }
+        }
+
+        const int depth = level[queue.back()];
+        lastLevel.clear();
+        for (const unsigned vertexIdx : queue) {
+            if (level[vertexIdx] == depth)
+                lastLevel.push_back(vertexIdx);
+            level[vertexIdx] = -1;
+        }
+
+        return depth;
+    };
+
+    std::vector<unsigned> lastLevel;
+    for (unsigned startIdx = 0; startIdx < numVertices; ++startIdx) {
+        if (visited[startIdx])
+            continue;
+
+        // find a pseudo-peripheral vertex of the component, i.e., one with a large
+        // eccentricity
+        unsigned root = startIdx;
+        int depth = levelStructure(root, lastLevel);
+        for (int iterIdx = 0; iterIdx < 8; ++iterIdx) {
+            const unsigned candidate =
+                *std::min_element(lastLevel.begin(), lastLevel.end(),
+                                  [&graph](unsigned a, unsigned b)
+                                  { return graph.degree(a) < graph.degree(b); });
+            std::vector<unsigned> candidateLastLevel;
+            const int candidateDepth = levelStructure(candidate, candidateLastLevel);
+            if (candidateDepth <= depth)
+                break;
+
+            root = candidate;
+            depth = candidateDepth;
+            lastLevel = std::move(candidateLastLevel);
+        }
+
+        // Cuthill-McKee numbering of the component
+        const std::size_t componentBegin = order.size();
+        order.push_back(root);
+        visited[root] = true;
+        for (std::size_t orderIdx = componentBegin; orderIdx < order.size(); ++orderIdx) {
+            const unsigned vertexIdx = order[orderIdx];
+            const std::size_t neighborsBegin = order.size();
+            for (std::size_t i = graph.offsets[vertexIdx]; i < graph.offsets[vertexIdx + 1]; ++i) {
+                const unsigned neighborIdx = graph.neighbors[i];
+                if (!visited[neighborIdx]) {
+                    visited[neighborIdx] = true;
+                    order.push_back(neighborIdx);
+                }
+            }
+            std::stable_sort(order.begin() + neighborsBegin, order.end(),
+                             [&graph](unsigned a, unsigned b)
+                             { return graph.degree(a) < graph.degree(b); });
+        }
+    }
+
+    std::vector<unsigned> newIndex(numVertices);
+    for (std::size_t orderIdx = 0; orderIdx < numVertices; ++orderIdx)
+        newIndex[order[orderIdx]] = static_cast<unsigned>(numVertices - 1 - orderIdx);
+
+    return newIndex;
+}
+
+/*!
+ * \brief Compute the order of a set of points along a Morton curve.
+ *
+ * The coordinates are quantized within the bounding box of the points and the bits
+ * of the quantized coordinates are interleaved. Returns the new index of each point.
+ */
+template <class Point>
+std::vector<unsigned> mortonOrdering(const std::vector<Point>& points)
+{
+    const std::size_t numPoints = points.size();
+    std::vector<unsigned> newIndex(numPoints);
+    if (numPoints == 0)
+        return newIndex;
+
+    const int dim = static_cast<int>(points[0].size());
+    assert(dim > 0 && dim <= 3);
+    const int bitsPerDim = 63/dim;
+
+    std::vector<double> lower(dim, std::numeric_limits<double>::max());
+    std::vector<double> upper(dim, std::numeric_limits<double>::lowest());
+    for (const auto& point : points) {
+        for (int dimIdx = 0; dimIdx < dim; ++dimIdx) {
+            lower[dimIdx] = std::min<double>(lower[dimIdx], point[dimIdx]);
+            upper[dimIdx] = std::max<double>(upper[dimIdx], point[dimIdx]);
+        }
+    }
+
+    const double maxCoord = static_cast<double>((std::uint64_t(1) << bitsPerDim) - 1);
+    std::vector<std::pair<std::uint64_t, unsigned>> keys(numPoints);
+    for (std::size_t pointIdx = 0; pointIdx < numPoints; ++pointIdx) {
+        std::uint64_t key = 0;
+        for (int dimIdx = 0; dimIdx < dim; ++dimIdx) {
+            const double extent = upper[dimIdx] - lower[dimIdx];
+            const double relPos = extent > 0.0 ? (points[pointIdx][dimIdx] - lower[dimIdx])/extent : 0.0;
+            const auto coord = static_cast<std::uint64_t>(std::round(relPos*maxCoord));
+            for (int bitIdx = 0; bitIdx < bitsPerDim; ++bitIdx)
+                key |= ((coord >> bitIdx) & 1) << (bitIdx*dim + dimIdx);
+        }
+        keys[pointIdx] = {key, static_cast<unsigned>(pointIdx)};
+    }
+
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (std::size_t orderIdx = 0; orderIdx < numPoints; ++orderIdx)
+        newIndex[keys[orderIdx].second] = static_cast<unsigned>(orderIdx);
+
+    return newIndex;
+}
+
+/*!
+ * \brief Statistics of the distances between the indices of connected degrees of
+ *        freedom.
+ *
+ * The bandwidth is that of the matrix of the graph, the mean distance is a measure
+ * of how far apart the data of neighboring degrees of freedom is in memory.
+ */
+struct DofOrderingQuality
+{
+    std::size_t bandwidth = 0;
+    double meanDistance = 0.0;
+};
+
+/*!
+ * \brief Compute the quality of an ordering of the vertices of a graph.
+ *
+ * \param newIndex The new index of each vertex. If it is empty, the order of the
+ *                 graph is evaluated.
+ */
+inline DofOrderingQuality dofOrderingQuality(const DofGraph& graph,
+                                             const std::vector<unsigned>& newIndex = {})
+{
+    const auto index = [&newIndex](std::size_t vertexIdx)
+    { return newIndex.empty() ? vertexIdx : static_cast<std::size_t>(newIndex[vertexIdx]); };
+
+    DofOrderingQuality quality;
+    double distanceSum = 0.0;
+    for (std::size_t vertexIdx = 0; vertexIdx < graph.numVertices(); ++vertexIdx) {
+        const std::size_t rowIdx = index(vertexIdx);
+        for (std::size_t i = graph.offsets[vertexIdx]; i < graph.offsets[vertexIdx + 1]; ++i) {
+            const std::size_t colIdx = index(graph.neighbors[i]);
+            const std::size_t distance = rowIdx > colIdx ? rowIdx - colIdx : colIdx - rowIdx;
+            quality.bandwidth = std::max(quality.bandwidth, distance);
+            distanceSum += static_cast<double>(distance);
+        }
+    }
+
+    if (!graph.neighbors.empty())
+        quality.meanDistance = distanceSum/static_cast<double>(graph.neighbors.size());
+
+    return quality;
+}
+
+/*!
+ * \brief Build the graph of the elements of a grid view which share a face.
+ */
+template <class GridView, class Mapper>
+DofGraph elementDofGraph(const GridView& gridView, const Mapper& elementMapper)
+{
+    const std::size_t numElements = static_cast<std::size_t>(elementMapper.size());
+    std::vector<std::vector<unsigned>> neighbors(numElements);
+    for (const auto& elem : elements(gridView)) {
+        const unsigned elemIdx = static_cast<unsigned>(elementMapper.index(elem));
+        for (const auto& intersection : intersections(gridView, elem))
+            if (intersection.neighbor())
+                neighbors[elemIdx].push_back(static_cast<unsigned>(elementMapper.index(intersection.outside())));
+    }
+
+    DofGraph graph;
+    graph.offsets.resize(numElements + 1);
+    for (std::size_t elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        auto& elemNeighbors = neighbors[elemIdx];
+        std::sort(elemNeighbors.begin(), elemNeighbors.end());
+        elemNeighbors.erase(std::unique(elemNeighbors.begin(), elemNeighbors.end()), elemNeighbors.end());
+        graph.offsets[elemIdx + 1] = graph.offsets[elemIdx] + elemNeighbors.size();
+        graph.neighbors.insert(graph.neighbors.end(), elemNeighbors.begin(), elemNeighbors.end());
+    }
+
+    return graph;
+}
+
+/*!
+ * \brief Build the graph of the vertices of a grid view which share an element.
+ */
+template <class GridView, class Mapper>
+DofGraph vertexDofGraph(const GridView& gridView, const Mapper& vertexMapper)
+{
+    constexpr int dim = GridView::dimension;
+
+    const std::size_t numVertices = static_cast<std::size_t>(vertexMapper.size());
+    std::vector<std::vector<unsigned>> neighbors(numVertices);
+    std::vector<unsigned> elemVertices;
+    for (const auto& elem : elements(gridView)) {
+        elemVertices.clear();
+        const int numElemVertices = static_cast<int>(elem.subEntities(dim));
+        for (int localIdx = 0; localIdx < numElemVertices; ++localIdx)
+            elemVertices.push_back(static_cast<unsigned>(vertexMapper.subIndex(elem, localIdx, dim)));
+
+        for (const unsigned vertexIdx : elemVertices)
+            for (const unsigned neighborIdx : elemVertices)
+                if (neighborIdx != vertexIdx)
+                    neighbors[vertexIdx].push_back(neighborIdx);
+    }
+
+    DofGraph graph;
+    graph.offsets.resize(numVertices + 1);
+    for (std::size_t vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx) {
+        auto& vertexNeighbors = neighbors[vertexIdx];
+        std::sort(vertexNeighbors.begin(), vertexNeighbors.end());
+        vertexNeighbors.erase(std::unique(vertexNeighbors.begin(), vertexNeighbors.end()), vertexNeighbors.end());
+        graph.offsets[vertexIdx + 1] = graph.offsets[vertexIdx] + vertexNeighbors.size();
+        graph.neighbors.insert(graph.neighbors.end(), vertexNeighbors.begin(), vertexNeighbors.end());
+    }
+
+    return graph;
+}
+
+/*!
+ * \brief Compute an ordering of the entities of a codimension of a grid view.
+ *
+ * The mapper must not permute the indices yet. Returns the new index of each entity,
+ * or an empty vector for DofOrdering::none. If the quality argument is given, the
+ * quality of the connectivity graph before and after the reordering is stored in it.
+ */
+template <int codim, class GridView, class Mapper>
+std::vector<unsigned> computeDofOrdering(DofOrdering ordering,
+                                         const GridView& gridView,
+                                         const Mapper& mapper,
+                                         std::pair<DofOrderingQuality, DofOrderingQuality>* quality = nullptr)
+{
+    static_assert(codim == 0 || codim == GridView::dimension,
+                  "Only elements and vertices can be reordered");
+
+    if (ordering == DofOrdering::none)
+        return {};
+
+    DofGraph graph;
+    if constexpr (codim == 0)
+        graph = elementDofGraph(gridView, mapper);
+    else
+        graph = vertexDofGraph(gridView, mapper);
+
+    std::vector<unsigned> newIndex;
+    if (ordering == DofOrdering::reverseCuthillMcKee)
+        newIndex = reverseCuthillMcKeeOrdering(graph);
+    else {
+        using Point = typename GridView::template Codim<codim>::Entity::Geometry::GlobalCoordinate;
+        std::vector<Point> centers(graph.numVertices());
+        for (const auto& entity : entities(gridView, Dune::Codim<codim>()))
+            centers[mapper.index(entity)] = entity.geometry().center();
+        newIndex = mortonOrdering(centers);
+    }
+
+    if (quality)
+        *quality = {dofOrderingQuality(graph), dofOrderingQuality(graph, newIndex)};
+
+    return newIndex;
+}
+
+} // namespace Opm
+
+#endif
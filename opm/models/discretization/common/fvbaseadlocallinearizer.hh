@@ -39,6 +39,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+
 namespace Opm {
 // forward declaration
 template<class TypeTag>
@@ -138,6 +140,16 @@ public:
         simulatorPtr_ = &simulator;
         delete internalElemContext_;
         internalElemContext_ = new ElementContext(simulator);
+
+        // allocate the storage for the largest stencil of the grid up front, so that
+        // linearizing an element does not allocate memory
+        const size_t maxNumDof = simulator.model().maxNumStencilDof();
+        const size_t maxNumPrimaryDof = simulator.model().maxNumStencilPrimaryDof();
+        localResidual_.reserve(maxNumDof);
+        residual_.reserve(maxNumDof);
+        if (jacobian_.N() < maxNumDof || jacobian_.M() < maxNumPrimaryDof)
+            jacobian_.setSize(std::max<size_t>(jacobian_.N(), maxNumDof),
+                              std::max<size_t>(jacobian_.M(), maxNumPrimaryDof));
     }
 
     /*!
@@ -251,8 +263,12 @@ protected:
         size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
 
         residual_.resize(numDof);
-        if (jacobian_.N() != numDof || jacobian_.M() != numPrimaryDof)
-          jacobian_.setSize(numDof, numPrimaryDof);
+        // the local Jacobian is only ever enlarged because changing the size of a
+        // Dune::Matrix reallocates its storage. only the upper left part of it which
+        // corresponds to the current element is used.
+        if (jacobian_.N() < numDof || jacobian_.M() < numPrimaryDof)
+            jacobian_.setSize(std::max<size_t>(jacobian_.N(), numDof),
+                              std::max<size_t>(jacobian_.M(), numPrimaryDof));
     }
 
     /*!
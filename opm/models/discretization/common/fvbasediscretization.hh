@@ -38,6 +38,7 @@
 #include <opm/material/densead/Math.hpp>
 
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
+#include <opm/models/discretization/common/dofordering.hh>
 #include <opm/models/discretization/common/fvbaseadlocallinearizer.hh>
 #include <opm/models/discretization/common/fvbaseboundarycontext.hh>
 #include <opm/models/discretization/common/fvbaseconstraints.hh>
@@ -52,13 +53,17 @@
 #include <opm/models/discretization/common/fvbasenewtonmethod.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 #include <opm/models/discretization/common/fvbaseprimaryvariables.hh>
+#include <opm/models/discretization/common/nlddsubdomain.hh>
+#include <opm/models/discretization/common/permutedmapper.hh>
 
 #include <opm/models/io/vtkprimaryvarsmodule.hh>
 
 #include <opm/models/parallel/gridcommhandles.hh>
+#include <opm/models/parallel/numaplacement.hh>
 #include <opm/models/parallel/threadmanager.hh>
 
 #include <opm/models/utils/alignedallocator.hh>
+#include <opm/models/utils/allocationaudit.hh>
 #include <opm/models/utils/simulator.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
@@ -67,13 +72,19 @@
 #include <opm/simulators/linalg/nullborderlistmanager.hh>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <exception>
+#include <iostream>
 #include <limits>
 #include <list>
+#include <mutex>
+#include <numeric>
 #include <stdexcept>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -94,12 +105,12 @@ struct Simulator<TypeTag, TTag::FvBaseDiscretization>
 //! Mapper for the grid view's vertices.
 template<class TypeTag>
 struct VertexMapper<TypeTag, TTag::FvBaseDiscretization>
-{ using type = Dune::MultipleCodimMultipleGeomTypeMapper<GetPropType<TypeTag, Properties::GridView>>; };
+{ using type = PermutedMapper<GetPropType<TypeTag, Properties::GridView>>; };
 
 //! Mapper for the grid view's elements.
 template<class TypeTag>
 struct ElementMapper<TypeTag, TTag::FvBaseDiscretization>
-{ using type = Dune::MultipleCodimMultipleGeomTypeMapper<GetPropType<TypeTag, Properties::GridView>>; };
+{ using type = PermutedMapper<GetPropType<TypeTag, Properties::GridView>>; };
 
 //! marks the border indices (required for the algebraic overlap stuff)
 template<class TypeTag>
@@ -332,6 +343,7 @@ class FvBaseDiscretization
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementSeed = typename Element::EntitySeed;
 
     using Toolbox = MathToolbox<Evaluation>;
     using VectorBlock = Dune::FieldVector<Evaluation, numEq>;
@@ -402,6 +414,11 @@ public:
         , enableIntensiveQuantityCache_(Parameters::Get<Parameters::EnableIntensiveQuantityCache>())
         , enableStorageCache_(Parameters::Get<Parameters::EnableStorageCache>())
         , enableThermodynamicHints_(Parameters::Get<Parameters::EnableThermodynamicHints>())
+        , enableParallelStartup_(Parameters::Get<Parameters::EnableParallelStartup>())
+        , maxNumStencilDof_(0)
+        , maxNumStencilPrimaryDof_(0)
+        , maxNumStencilInteriorFaces_(0)
+        , maxNumStencilBoundaryFaces_(0)
     {
         bool isEcfv = std::is_same<Discretization, EcfvDiscretization<TypeTag> >::value;
         if (enableGridAdaptation_ && !isEcfv)
@@ -409,6 +426,15 @@ public:
                                         "element-centered finite volume discretization (is: "
                                         +Dune::className<Discretization>()+")");
 
+        dofOrdering_ = parseDofOrdering(Parameters::Get<Parameters::DofOrdering>());
+        if (dofOrdering_ != DofOrdering::none && enableGridAdaptation_)
+            throw std::invalid_argument("The degrees of freedom cannot be reordered if grid "
+                                        "adaptation is enabled");
+        if (NumaPlacement::enabled() && enableGridAdaptation_)
+            throw std::invalid_argument("NUMA aware initialization cannot be used if grid "
+                                        "adaptation is enabled");
+        updateDofOrdering_();
+
         PrimaryVariables::init();
         size_t numDof = asImp_().numGridDof();
         for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
@@ -453,6 +479,9 @@ public:
         // register runtime parameters of the output modules
         VtkPrimaryVarsModule<TypeTag>::registerParameters();
 
+        Parameters::Register<Parameters::DofOrdering>
+            ("The ordering of the degrees of freedom: 'none' to keep the one of the "
+             "grid, 'rcm' for reverse Cuthill-McKee, or 'morton' for a Morton curve");
         Parameters::Register<Parameters::EnableGridAdaptation>
             ("Enable adaptive grid refinement/coarsening");
         Parameters::Register<Parameters::EnableVtkOutput>
@@ -463,6 +492,10 @@ public:
             ("Turn on caching of intensive quantities");
         Parameters::Register<Parameters::EnableStorageCache>
             ("Store previous storage terms and avoid re-calculating them.");
+        Parameters::Register<Parameters::EnableParallelStartup>
+            ("Evaluate the initial solution and parse restart files using all threads. "
+             "This requires a thread-safe initial condition of the problem and "
+             "thread-safe deserializeEntity() methods of the model and the problem");
         Parameters::Register<Parameters::OutputDir>
             ("The directory to which result files are written");
     }
@@ -479,6 +512,10 @@ public:
 
         ElementContext elemCtx(simulator_);
         gridTotalVolume_ = 0.0;
+        maxNumStencilDof_ = 0;
+        maxNumStencilPrimaryDof_ = 0;
+        maxNumStencilInteriorFaces_ = 0;
+        maxNumStencilBoundaryFaces_ = 0;
 
         // iterate through the grid and evaluate the initial condition
         for (const auto& elem : elements(gridView_)) {
@@ -491,6 +528,13 @@ public:
             // deal with the current element
             elemCtx.updateStencil(elem);
             const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+            maxNumStencilDof_ = std::max<size_t>(maxNumStencilDof_, stencil.numDof());
+            maxNumStencilPrimaryDof_ = std::max<size_t>(maxNumStencilPrimaryDof_,
+                                                        stencil.numPrimaryDof());
+            maxNumStencilInteriorFaces_ = std::max<size_t>(maxNumStencilInteriorFaces_,
+                                                           stencil.numInteriorFaces());
+            maxNumStencilBoundaryFaces_ = std::max<size_t>(maxNumStencilBoundaryFaces_,
+                                                           stencil.numBoundaryFaces());
 
             // loop over all element vertices, i.e. sub control volumes
             for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); dofIdx++) {
@@ -533,15 +577,74 @@ public:
                 invalidateIntensiveQuantitiesCache(timeIdx);
         }
 
+        placeArraysNumaAware_();
+
         newtonMethod_.finishInit();
     }
 
+    /*!
+     * \brief Returns the largest number of degrees of freedom of the stencil of an
+     *        element in the interior of the local grid partition.
+     *
+     * This is zero before finishInit() has been called.
+     */
+    size_t maxNumStencilDof() const
+    { return maxNumStencilDof_; }
+
+    /*!
+     * \brief Returns the largest number of primary degrees of freedom of the stencil of
+     *        an element in the interior of the local grid partition.
+     *
+     * This is zero before finishInit() has been called.
+     */
+    size_t maxNumStencilPrimaryDof() const
+    { return maxNumStencilPrimaryDof_; }
+
+    /*!
+     * \brief Returns the largest number of interior faces of the stencil of an element
+     *        in the interior of the local grid partition.
+     *
+     * This is zero before finishInit() has been called.
+     */
+    size_t maxNumStencilInteriorFaces() const
+    { return maxNumStencilInteriorFaces_; }
+
+    /*!
+     * \brief Returns the largest number of boundary faces of the stencil of an element
+     *        in the interior of the local grid partition.
+     *
+     * This is zero before finishInit() has been called.
+     */
+    size_t maxNumStencilBoundaryFaces() const
+    { return maxNumStencilBoundaryFaces_; }
+
+    /*!
+     * \brief Returns the elements of the local grid partition ordered by the index of
+     *        their first primary degree of freedom.
+     *
+     * This is only available if NUMA aware initialization is enabled and empty
+     * otherwise. A loop over it which uses schedule(static) gives each thread the
+     * elements of the degrees of freedom whose pages were placed on its NUMA node, so
+     * it should be used instead of ThreadedEntityIterator by the loops which process
+     * the per-DOF arrays. For the vertex-centered scheme, the degrees of freedom shared
+     * by the elements of several threads are not matched exactly.
+     */
+    const std::vector<ElementSeed>& staticElementSeeds() const
+    { return staticElementSeeds_; }
+
     /*!
      * \brief Returns whether the grid ought to be adapted to the solution during the simulation.
      */
     bool enableGridAdaptation() const
     { return enableGridAdaptation_; }
 
+    /*!
+     * \brief Returns whether the initial solution is evaluated and restart files are
+     *        parsed using all threads.
+     */
+    bool enableParallelStartup() const
+    { return enableParallelStartup_; }
+
     /*!
      * \brief Applies the initial solution for all degrees of freedom to which the model
      *        applies.
@@ -552,29 +655,33 @@ public:
         SolutionVector& uCur = asImp_().solution(/*timeIdx=*/0);
         uCur = Scalar(0.0);
 
-        ElementContext elemCtx(simulator_);
-
-        // iterate through the grid and evaluate the initial condition
-        for (const auto& elem : elements(gridView_)) {
-            // ignore everything which is not in the interior if the
-            // current process' piece of the grid
-            if (elem.partitionType() != Dune::InteriorEntity)
-                continue;
+        if (enableParallelStartup_ && ThreadManager::maxThreads() > 1)
+            applyInitialSolutionParallel_(uCur);
+        else {
+            ElementContext elemCtx(simulator_);
 
-            // deal with the current element
-            elemCtx.updateStencil(elem);
+            // iterate through the grid and evaluate the initial condition
+            for (const auto& elem : elements(gridView_)) {
+                // ignore everything which is not in the interior if the
+                // current process' piece of the grid
+                if (elem.partitionType() != Dune::InteriorEntity)
+                    continue;
 
-            // loop over all element vertices, i.e. sub control volumes
-            for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); dofIdx++)
-            {
-                // map the local degree of freedom index to the global one
-                unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                // deal with the current element
+                elemCtx.updateStencil(elem);
 
-                // let the problem do the dirty work of nailing down
-                // the initial solution.
-                simulator_.problem().initial(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
-                asImp_().supplementInitialSolution_(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
-                uCur[globalIdx].checkDefined();
+                // loop over all element vertices, i.e. sub control volumes
+                for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); dofIdx++)
+                {
+                    // map the local degree of freedom index to the global one
+                    unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+
+                    // let the problem do the dirty work of nailing down
+                    // the initial solution.
+                    simulator_.problem().initial(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
+                    asImp_().supplementInitialSolution_(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
+                    uCur[globalIdx].checkDefined();
+                }
             }
         }
 
@@ -723,34 +830,22 @@ public:
     void invalidateAndUpdateIntensiveQuantities(unsigned timeIdx) const
     {
         invalidateIntensiveQuantitiesCache(timeIdx);
-
-        // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-        {
-            ElementContext elemCtx(simulator_);
-            ElementIterator elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
-            }
-        }
+        updateIntensiveQuantities_(timeIdx);
     }
 
     template <class GridViewType>
     void invalidateAndUpdateIntensiveQuantities(unsigned timeIdx, const GridViewType& gridView) const
     {
+        simulator_.problem().updateCaches();
+
         // loop over all elements...
         ThreadedEntityIterator<GridViewType, /*codim=*/0> threadedElemIt(gridView);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
-
             ElementContext elemCtx(simulator_);
+            NoAllocationRegion noAllocationRegion("FvBaseDiscretization::updateIntensiveQuantities");
             auto elemIt = threadedElemIt.beginParallel();
             for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
                 if (elemIt->partitionType() != Dune::InteriorEntity) {
@@ -770,6 +865,36 @@ public:
         }
     }
 
+    /*!
+     * \brief Invalidate and recompute the intensive quantities of the degrees of freedom
+     *        of a subdomain of the nonlinear domain decomposition.
+     *
+     * Only the calling thread is used, so subdomains which do not share any degrees of
+     * freedom or neighbors may be updated concurrently.
+     *
+     * \param timeIdx The index used by the time discretization.
+     * \param domain The subdomain
+     * \param elemCtx The element context of the calling thread
+     */
+    template <class ElementSeed>
+    void invalidateAndUpdateIntensiveQuantities(unsigned timeIdx,
+                                                const NlddSubDomain<ElementSeed>& domain,
+                                                ElementContext& elemCtx) const
+    {
+        if (!storeIntensiveQuantities())
+            return;
+
+        for (const int dofIdx : domain.cells)
+            setIntensiveQuantitiesCacheEntryValidity(dofIdx, timeIdx, false);
+
+        // the elements of the subdomain cover all of its degrees of freedom. the
+        // intensive quantities of the others are taken from the cache.
+        for (const auto& seed : domain.elements) {
+            elemCtx.updatePrimaryStencil(gridView_.grid().entity(seed));
+            elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
+        }
+    }
+
     /*!
      * \brief Move the intensive quantities for a given time index to the back.
      *
@@ -1365,7 +1490,19 @@ public:
         // previous time step so that we can start the next
         // update at a physically meaningful solution.
         solution(/*timeIdx=*/0) = solution(/*timeIdx=*/1);
-        invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+        if (previousIntensiveQuantitiesCached_()) {
+            // the cached intensive quantities of the previous time step belong to exactly
+            // this solution, so they only need to be recomputed for the degrees of freedom
+            // for which they are not up to date
+            intensiveQuantityCache_[/*timeIdx=*/0] = intensiveQuantityCache_[/*timeIdx=*/1];
+            intensiveQuantityCacheUpToDate_[/*timeIdx=*/0] = intensiveQuantityCacheUpToDate_[/*timeIdx=*/1];
+
+            const auto& upToDate = intensiveQuantityCacheUpToDate_[/*timeIdx=*/0];
+            if (std::find(upToDate.begin(), upToDate.end(), 0) != upToDate.end())
+                updateIntensiveQuantities_(/*timeIdx=*/0);
+        }
+        else
+            invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
 
 #ifndef NDEBUG
         for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
@@ -1675,15 +1812,24 @@ public:
      */
     void prepareOutputFields() const
     {
+        // only consider the modules which actually write something. the remaining
+        // ones neither need their buffers allocated nor any of the elements
+        activeOutputModules_.clear();
         bool needFullContextUpdate = false;
-        auto modIt = outputModules_.begin();
-        const auto& modEndIt = outputModules_.end();
-        for (; modIt != modEndIt; ++modIt) {
-            (*modIt)->allocBuffers();
-            needFullContextUpdate = needFullContextUpdate || (*modIt)->needExtensiveQuantities();
+        for (auto* mod : outputModules_) {
+            if (!mod->isActive())
+                continue;
+
+            activeOutputModules_.push_back(mod);
+            mod->allocBuffers();
+            needFullContextUpdate = needFullContextUpdate || mod->needExtensiveQuantities();
         }
 
-        // iterate over grid
+        if (activeOutputModules_.empty())
+            return;
+
+        // iterate over grid. the element contexts take the intensive quantities from
+        // the cache of the model if it is enabled.
         ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
 #ifdef _OPENMP
 #pragma omp parallel
@@ -1704,12 +1850,8 @@ public:
                     elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
                 }
 
-                // we cannot reuse the "modIt" variable here because the code here might
-                // be threaded and "modIt" is is the same for all threads, i.e., if a
-                // given thread modifies it, the changes affect all threads.
-                auto modIt2 = outputModules_.begin();
-                for (; modIt2 != modEndIt; ++modIt2)
-                    (*modIt2)->processElement(elemCtx);
+                for (auto* mod : activeOutputModules_)
+                    mod->processElement(elemCtx);
             }
         }
     }
@@ -1720,10 +1862,8 @@ public:
      */
     void appendOutputFields(BaseOutputWriter& writer) const
     {
-        auto modIt = outputModules_.begin();
-        const auto& modEndIt = outputModules_.end();
-        for (; modIt != modEndIt; ++modIt)
-            (*modIt)->commitBuffers(writer);
+        for (auto* mod : activeOutputModules_)
+            mod->commitBuffers(writer);
     }
 
     /*!
@@ -1830,6 +1970,78 @@ public:
     }
 
 protected:
+    // renumber the elements and the vertices. the mappers must not be permuted yet,
+    // i.e., this must be called after they were created or updated.
+    void updateDofOrdering_()
+    {
+        if (dofOrdering_ == DofOrdering::none)
+            return;
+
+        std::pair<DofOrderingQuality, DofOrderingQuality> elementQuality;
+        std::pair<DofOrderingQuality, DofOrderingQuality> vertexQuality;
+        elementMapper_.setPermutation(computeDofOrdering</*codim=*/0>(dofOrdering_,
+                                                                      gridView_,
+                                                                      elementMapper_,
+                                                                      &elementQuality));
+        vertexMapper_.setPermutation(computeDofOrdering<GridView::dimension>(dofOrdering_,
+                                                                             gridView_,
+                                                                             vertexMapper_,
+                                                                             &vertexQuality));
+
+        if (verbose_()) {
+            const auto printQuality = [](const std::string& entityName, const auto& quality)
+            {
+                std::cout << "Reordered the " << entityName << ": bandwidth "
+                          << quality.first.bandwidth << " -> " << quality.second.bandwidth
+                          << ", mean index distance of neighbors "
+                          << quality.first.meanDistance << " -> " << quality.second.meanDistance
+                          << "\n";
+            };
+            printQuality("elements", elementQuality);
+            printQuality("vertices", vertexQuality);
+        }
+    }
+
+    // distribute the pages of the per-DOF arrays like the loops over the degrees of
+    // freedom which use schedule(static) and determine the order of the elements for
+    // the loops over the elements which process them
+    void placeArraysNumaAware_()
+    {
+        if (!NumaPlacement::enabled())
+            return;
+
+        std::vector<std::pair<unsigned, ElementSeed>> elementsByDof;
+        elementsByDof.reserve(gridView_.size(/*codim=*/0));
+        ElementContext elemCtx(simulator_);
+        for (const auto& elem : elements(gridView_)) {
+            elemCtx.updatePrimaryStencil(elem);
+            unsigned firstDofIdx = elemCtx.globalSpaceIndex(/*dofIdx=*/0, /*timeIdx=*/0);
+            for (unsigned dofIdx = 1; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx)
+                firstDofIdx = std::min(firstDofIdx, elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0));
+            elementsByDof.emplace_back(firstDofIdx, elem.seed());
+        }
+        std::stable_sort(elementsByDof.begin(), elementsByDof.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        staticElementSeeds_.clear();
+        staticElementSeeds_.reserve(elementsByDof.size());
+        for (const auto& entry : elementsByDof)
+            staticElementSeeds_.push_back(entry.second);
+
+        for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
+            const auto& sol = solution(timeIdx);
+            if (sol.size() > 0)
+                NumaPlacement::placeArray(&sol[0], sol.size());
+
+            if (enableStorageCache_ && storageCache_[timeIdx].size() > 0)
+                NumaPlacement::placeArray(&storageCache_[timeIdx][0], storageCache_[timeIdx].size());
+
+            if (storeIntensiveQuantities())
+                NumaPlacement::placeArray(intensiveQuantityCache_[timeIdx].data(),
+                                          intensiveQuantityCache_[timeIdx].size());
+        }
+    }
+
     void resizeAndResetIntensiveQuantitiesCache_()
     {
         // allocate the storage cache
@@ -1850,6 +2062,144 @@ protected:
             }
         }
     }
+    // compute the intensive quantities of all degrees of freedom for which the cache is
+    // not up to date
+    void updateIntensiveQuantities_(unsigned timeIdx) const
+    {
+        // the lazily computed data of the problem must not be created concurrently
+        simulator_.problem().updateCaches();
+
+        // use the partition of the elements which matches the placement of the pages of
+        // the cache
+        if (!staticElementSeeds_.empty()) {
+            const int numElems = static_cast<int>(staticElementSeeds_.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                ElementContext elemCtx(simulator_);
+                NoAllocationRegion noAllocationRegion("FvBaseDiscretization::updateIntensiveQuantities");
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+                for (int elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                    const auto& elem = gridView_.grid().entity(staticElementSeeds_[elemIdx]);
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
+                }
+            }
+            return;
+        }
+
+        // loop over all elements...
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+            NoAllocationRegion noAllocationRegion("FvBaseDiscretization::updateIntensiveQuantities");
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                elemCtx.updatePrimaryStencil(elem);
+                elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
+            }
+        }
+    }
+
+    // returns true if the intensive quantity cache of the previous time step is
+    // maintained by shiftIntensiveQuantityCache()
+    bool previousIntensiveQuantitiesCached_() const
+    {
+        if (!storeIntensiveQuantities())
+            return false;
+
+        if (enableStorageCache() && simulator_.problem().recycleFirstIterationStorage())
+            return false;
+
+        return intensiveQuantityCache_[/*timeIdx=*/1].size() == intensiveQuantityCache_[/*timeIdx=*/0].size();
+    }
+
+    // evaluate the initial condition using all threads. each degree of freedom is
+    // initialized by the last interior element which contains it, so that the result
+    // is the same as the one of the sequential loop
+    void applyInitialSolutionParallel_(SolutionVector& uCur)
+    {
+        static constexpr unsigned invalidIdx = std::numeric_limits<unsigned>::max();
+
+        // determine the element which initializes each degree of freedom
+        std::vector<ElementSeed> elementSeeds;
+        std::vector<std::pair<unsigned, unsigned>> dofOwners(uCur.size(), {invalidIdx, 0});
+        {
+            ElementContext elemCtx(simulator_);
+            for (const auto& elem : elements(gridView_)) {
+                if (elem.partitionType() != Dune::InteriorEntity)
+                    continue;
+
+                elemCtx.updatePrimaryStencil(elem);
+                const unsigned elemIdx = static_cast<unsigned>(elementSeeds.size());
+                for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx)
+                    dofOwners[elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0)] = {elemIdx, dofIdx};
+                elementSeeds.push_back(elem.seed());
+            }
+        }
+
+        // invert this into the list of local degrees of freedom of each element
+        std::vector<std::size_t> dofOffsets(elementSeeds.size() + 1, 0);
+        for (const auto& owner : dofOwners)
+            if (owner.first != invalidIdx)
+                ++dofOffsets[owner.first + 1];
+        std::partial_sum(dofOffsets.begin(), dofOffsets.end(), dofOffsets.begin());
+
+        std::vector<unsigned> localDofIndices(dofOffsets.back());
+        std::vector<std::size_t> insertPos(dofOffsets.begin(), dofOffsets.end() - 1);
+        for (const auto& owner : dofOwners)
+            if (owner.first != invalidIdx)
+                localDofIndices[insertPos[owner.first]++] = owner.second;
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed = false;
+
+        const int numElems = static_cast<int>(elementSeeds.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+#ifdef _OPENMP
+#pragma omp for schedule(guided)
+#endif
+            for (int elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                if (failed || dofOffsets[elemIdx] == dofOffsets[elemIdx + 1])
+                    continue;
+
+                try {
+                    const auto& elem = gridView_.grid().entity(elementSeeds[elemIdx]);
+                    elemCtx.updateStencil(elem);
+
+                    for (std::size_t i = dofOffsets[elemIdx]; i < dofOffsets[elemIdx + 1]; ++i) {
+                        const unsigned dofIdx = localDofIndices[i];
+                        const unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+
+                        simulator_.problem().initial(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
+                        asImp_().supplementInitialSolution_(uCur[globalIdx], elemCtx, dofIdx, /*timeIdx=*/0);
+                        uCur[globalIdx].checkDefined();
+                    }
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
     template <class Context>
     void supplementInitialSolution_(PrimaryVariables&,
                                     const Context&,
@@ -1924,6 +2274,9 @@ protected:
     mutable std::array< std::unique_ptr< DiscreteFunction >, historySize > solution_;
 
     std::list<BaseOutputModule<TypeTag>*> outputModules_;
+    // the output modules which write at least one field, determined by
+    // prepareOutputFields()
+    mutable std::vector<BaseOutputModule<TypeTag>*> activeOutputModules_;
 
     Scalar gridTotalVolume_;
     std::vector<Scalar> dofTotalVolume_;
@@ -1931,10 +2284,25 @@ protected:
 
     mutable GlobalEqVector storageCache_[historySize];
 
+    // the elements in the order of their degrees of freedom if NUMA aware
+    // initialization is enabled
+    std::vector<ElementSeed> staticElementSeeds_;
+
+    DofOrdering dofOrdering_;
     bool enableGridAdaptation_;
     bool enableIntensiveQuantityCache_;
     bool enableStorageCache_;
     bool enableThermodynamicHints_;
+
+    // evaluate the initial solution and parse restart files using all threads
+    bool enableParallelStartup_;
+
+    // the sizes of the largest element stencil, used to allocate the storage of the
+    // element contexts and of the local linearizers up front
+    size_t maxNumStencilDof_;
+    size_t maxNumStencilPrimaryDof_;
+    size_t maxNumStencilInteriorFaces_;
+    size_t maxNumStencilBoundaryFaces_;
 };
 
 /*!
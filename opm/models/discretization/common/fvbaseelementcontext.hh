@@ -98,8 +98,18 @@ public:
         // remember the simulator object
         simulatorPtr_ = &simulator;
         enableStorageCache_ = Parameters::Get<Parameters::EnableStorageCache>();
+        storageCacheIsReadOnly_ = false;
         stashedDofIdx_ = -1;
         focusDofIdx_ = -1;
+        numStorageAllocations_ = 0;
+
+        // allocate the storage for the largest stencil of the grid up front. (this is
+        // only known after the model has been initialized.)
+        const auto& model = simulator.model();
+        stencil_.reserve(model.maxNumStencilDof(),
+                         model.maxNumStencilInteriorFaces(),
+                         model.maxNumStencilBoundaryFaces());
+        reserveStorage_(model.maxNumStencilDof(), model.maxNumStencilInteriorFaces());
     }
 
     static void *operator new(size_t size)
@@ -138,9 +148,10 @@ public:
         // enables them
         stencil_.update(elem);
 
-        // resize the arrays containing the flux and the volume variables
-        dofVars_.resize(stencil_.numDof());
-        extensiveQuantities_.resize(stencil_.numInteriorFaces());
+        // make sure that the arrays containing the flux and the volume variables are
+        // large enough. they are never shrunk, so that the objects stored therein are
+        // not destroyed and re-created for each element.
+        reserveStorage_(stencil_.numDof(), stencil_.numInteriorFaces());
     }
 
     /*!
@@ -157,7 +168,7 @@ public:
         // update the finite element geometry
         stencil_.updatePrimaryTopology(elem);
 
-        dofVars_.resize(stencil_.numPrimaryDof());
+        reserveStorage_(stencil_.numPrimaryDof(), /*numFaces=*/0);
     }
 
     /*!
@@ -225,6 +236,30 @@ public:
     void updateIntensiveQuantities(const PrimaryVariables& priVars, unsigned dofIdx, unsigned timeIdx)
     { asImp_().updateSingleIntQuants_(priVars, dofIdx, timeIdx); }
 
+    /*!
+     * \brief Compute the intensive quantities of all sub-control volumes of the current
+     *        element for a single time index using an arbitrary global solution.
+     *
+     * In contrast to updateIntensiveQuantities(timeIdx), the solution of the model and
+     * the cache of the intensive quantities are neither used nor modified, so this
+     * method can be called concurrently to anything which only reads the model.
+     *
+     * \param globalSol The global solution from which the primary variables are taken.
+     *                  It must stay alive as long as the context is used.
+     * \param timeIdx The index of the solution vector used by the time discretization.
+     */
+    void updateIntensiveQuantities(const SolutionVector& globalSol, unsigned timeIdx)
+    { updateUncachedIntensiveQuantities_(globalSol, timeIdx, numDof(timeIdx)); }
+
+    /*!
+     * \brief Compute the intensive quantities of the primary sub-control volumes of the
+     *        current element for a single time index using an arbitrary global solution.
+     *
+     * \copydetails updateIntensiveQuantities(const SolutionVector&, unsigned)
+     */
+    void updatePrimaryIntensiveQuantities(const SolutionVector& globalSol, unsigned timeIdx)
+    { updateUncachedIntensiveQuantities_(globalSol, timeIdx, numPrimaryDof(timeIdx)); }
+
     /*!
      * \brief Compute the extensive quantities of all sub-control volume
      *        faces of the current element for all time indices.
@@ -532,6 +567,32 @@ public:
     void setEnableStorageCache(bool yesno)
     { enableStorageCache_ = yesno; }
 
+    /*!
+     * \brief Returns true iff the cached storage term must only be read by this context.
+     *
+     * This is the case for contexts which are not used to linearize the current
+     * solution, e.g., those of the matrix-free linear operator. Otherwise, the local
+     * residual updates the cache during the first Newton iteration of a time step.
+     */
+    bool storageCacheIsReadOnly() const
+    { return storageCacheIsReadOnly_; }
+
+    /*!
+     * \brief Specifies if the cached storage term must only be read by this context.
+     */
+    void setStorageCacheReadOnly(bool yesno)
+    { storageCacheIsReadOnly_ = yesno; }
+
+    /*!
+     * \brief Returns the number of times the storage for the intensive and extensive
+     *        quantities had to be enlarged since the context was created.
+     *
+     * If the storage is allocated for the largest stencil of the grid, this is at most
+     * one.
+     */
+    unsigned numStorageAllocations() const
+    { return numStorageAllocations_; }
+
 private:
     Implementation& asImp_()
     { return *static_cast<Implementation*>(this); }
@@ -540,6 +601,19 @@ private:
     { return *static_cast<const Implementation*>(this); }
 
 protected:
+    // enlarge the storage for the intensive and the extensive quantities if needed
+    void reserveStorage_(size_t numDof, size_t numFaces)
+    {
+        if (dofVars_.size() >= numDof && extensiveQuantities_.size() >= numFaces)
+            return;
+
+        ++numStorageAllocations_;
+        if (dofVars_.size() < numDof)
+            dofVars_.resize(numDof);
+        if (extensiveQuantities_.size() < numFaces)
+            extensiveQuantities_.resize(numFaces);
+    }
+
     /*!
      * \brief Update the first 'n' intensive quantities objects from the primary variables.
      *
@@ -572,6 +646,24 @@ protected:
         }
     }
 
+    /*!
+     * \brief Update the first 'n' intensive quantities objects from the primary variables
+     *        of a given global solution.
+     *
+     * This method does not consider the intensive quantities cache.
+     */
+    void updateUncachedIntensiveQuantities_(const SolutionVector& globalSol,
+                                            unsigned timeIdx,
+                                            size_t numDof)
+    {
+        for (unsigned dofIdx = 0; dofIdx < numDof; dofIdx++) {
+            unsigned globalIdx = globalSpaceIndex(dofIdx, timeIdx);
+            dofVars_[dofIdx].thermodynamicHint[timeIdx] =
+                model().thermodynamicHint(globalIdx, timeIdx);
+            updateSingleIntQuants_(globalSol[globalIdx], dofIdx, timeIdx);
+        }
+    }
+
     void updateSingleIntQuants_(const PrimaryVariables& priVars, unsigned dofIdx, unsigned timeIdx)
     {
 #ifndef NDEBUG
@@ -591,6 +683,7 @@ protected:
 
     std::vector<DofStore_, aligned_allocator<DofStore_, alignof(DofStore_)> > dofVars_;
     std::vector<ExtensiveQuantities, aligned_allocator<ExtensiveQuantities, alignof(ExtensiveQuantities)> > extensiveQuantities_;
+    unsigned numStorageAllocations_;
 
     const Simulator *simulatorPtr_;
     const Element *elemPtr_;
@@ -600,6 +693,7 @@ protected:
     int stashedDofIdx_;
     int focusDofIdx_;
     bool enableStorageCache_;
+    bool storageCacheIsReadOnly_;
 };
 
 } // namespace Opm
@@ -39,18 +39,28 @@
 #include <opm/models/parallel/threadmanager.hh>
 #include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
+#include <opm/models/discretization/common/nlddsubdomain.hh>
+#include <opm/models/utils/allocationaudit.hh>
+
+#include <opm/simulators/linalg/linalgproperties.hh>
 
 #include <dune/common/version.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <type_traits>
 #include <iostream>
+#include <utility>
 #include <vector>
 #include <thread>
 #include <set>
 #include <exception>   // current_exception, rethrow_exception
 #include <mutex>
+#include <stdexcept>
 
 namespace Opm {
 // forward declarations
@@ -90,11 +100,13 @@ class FvBaseLinearizer
     using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
 
     using GridCommHandleFactory = GetPropType<TypeTag, Properties::GridCommHandleFactory>;
+    using LinearSolverBackend = GetPropType<TypeTag, Properties::LinearSolverBackend>;
 
     using Toolbox = MathToolbox<Evaluation>;
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementSeed = typename Element::EntitySeed;
 
     using Vector = GlobalEqVector;
 
@@ -153,6 +165,11 @@ public:
         }
         elementCtx_.resize(0);
         fullDomain_ = std::make_unique<FullDomain>(simulator.gridView());
+
+        // the grid may have changed
+        domainPatternOffsets_.clear();
+        domainPatternColumns_.clear();
+        elementColors_.clear();
     }
 
     /*!
@@ -161,6 +178,9 @@ public:
      *
      * This method is usally called if the sparsity pattern has changed for some
      * reason. (e.g. by modifications of the grid or changes of the auxiliary equations.)
+     * The part of the sparsity pattern which stems from the stencils of the grid
+     * elements is kept until the linearizer is re-initialized, so changing the
+     * auxiliary equations does not require to iterate over the grid again.
      */
     void eraseMatrix()
     {
@@ -197,7 +217,8 @@ public:
         linearizeDomain(*fullDomain_);
     }
 
-    template <class SubDomainType>
+    template <class SubDomainType,
+              std::enable_if_t<!IsNlddSubDomain<SubDomainType>::value, int> = 0>
     void linearizeDomain(const SubDomainType& domain)
     {
         OPM_TIMEBLOCK(linearizeDomain);
@@ -240,6 +261,34 @@ public:
             throw NumericalProblem("A process did not succeed in linearizing the system");
     }
 
+    /*!
+     * \brief Linearize the part of the non-linear system of equations that is associated
+     *        with a subdomain of the nonlinear domain decomposition.
+     *
+     * Only the residual and the Jacobian rows of the degrees of freedom of the subdomain
+     * are reset and recomputed. Since each process solves its subdomains independently,
+     * errors are not communicated to the other processes.
+     *
+     * The subdomains are solved concurrently, so the elements of a subdomain are
+     * linearized by the calling thread alone. The constraints must have been determined
+     * by a preceding linearization of the whole domain.
+     */
+    template <class SubDomainType,
+              std::enable_if_t<IsNlddSubDomain<SubDomainType>::value, int> = 0>
+    void linearizeDomain(const SubDomainType& domain)
+    {
+        OPM_TIMEBLOCK(linearizeDomain);
+        assert(jacobian_);
+
+        resetSystem_(domain);
+
+        NoAllocationRegion noAllocationRegion("FvBaseLinearizer::linearizeDomain");
+        for (const auto& seed : domain.elements)
+            linearizeElement_(gridView_().grid().entity(seed));
+
+        applyConstraintsToLinearization_(domain.cells);
+    }
+
     void finalize()
     { jacobian_->finalize(); }
 
@@ -301,6 +350,19 @@ public:
         return linearizationType_;
     };
 
+    /*!
+     * \brief Keep the Jacobian matrix of the previous linearization.
+     *
+     * If enabled, the linearization only recomputes the residual and leaves the
+     * Jacobian as it is. This is used by the Newton method when the Jacobian of a
+     * previous iteration is good enough.
+     */
+    void setReuseJacobian(bool yesno)
+    { reuseJacobian_ = yesno; }
+
+    bool reuseJacobian() const
+    { return reuseJacobian_; }
+
     void updateDiscretizationParameters()
     {
         // This linearizer stores no such parameters.
@@ -339,7 +401,19 @@ public:
     const auto& getFloresInfo() const
     {return floresInfo_;}
 
-    template <class SubDomainType>
+    template <class SubDomainType,
+              std::enable_if_t<IsNlddSubDomain<SubDomainType>::value, int> = 0>
+    void resetSystem_(const SubDomainType& domain)
+    {
+        for (const int globI : domain.cells) {
+            residual_[globI] = 0.0;
+            if (!reuseJacobian_)
+                jacobian_->clearRow(globI, 0.0);
+        }
+    }
+
+    template <class SubDomainType,
+              std::enable_if_t<!IsNlddSubDomain<SubDomainType>::value, int> = 0>
     void resetSystem_(const SubDomainType& domain)
     {
         if (!jacobian_) {
@@ -368,7 +442,8 @@ public:
                 {
                     unsigned globI = elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
                     residual_[globI] = 0.0;
-                    jacobian_->clearRow(globI, 0.0);
+                    if (!reuseJacobian_)
+                        jacobian_->clearRow(globI, 0.0);
                 }
             }
         }
@@ -399,6 +474,10 @@ private:
     const DofMapper& dofMapper_() const
     { return model_().dofMapper(); }
 
+    // returns true if the linear solver needs the off-diagonal blocks of the Jacobian
+    static constexpr bool assembleOffDiagonalBlocks_()
+    { return Linear::NeedsOffDiagonalBlocks<LinearSolverBackend>::value; }
+
     void initFirstIteration_()
     {
         // initialize the BCRS matrix for the Jacobian of the residual function
@@ -418,29 +497,45 @@ private:
     void createMatrix_()
     {
         const auto& model = model_();
-        Stencil stencil(gridView_(), model_().dofMapper());
 
         // for the main model, find out the global indices of the neighboring degrees of
         // freedom of each primary degree of freedom
+        if (assembleOffDiagonalBlocks_() &&
+            domainPatternOffsets_.size() != model.numGridDof() + 1)
+            createDomainPattern_();
+
         sparsityPattern_.clear();
         sparsityPattern_.resize(model.numTotalDof());
 
-        for (const auto& elem : elements(gridView_())) {
-            stencil.update(elem);
-
-            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
-                unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+        size_t numAuxMod = model.numAuxiliaryModules();
+        if (!assembleOffDiagonalBlocks_()) {
+            // the linear solver computes the Jacobian-vector products on its own and
+            // only needs the diagonal blocks
+            if (numAuxMod > 0)
+                throw std::logic_error("Linear solvers which do not use the off-diagonal blocks "
+                                       "of the Jacobian do not support auxiliary equations");
+
+            for (unsigned rowIdx = 0; rowIdx < sparsityPattern_.size(); ++rowIdx)
+                sparsityPattern_[rowIdx].insert(rowIdx);
+
+            jacobian_.reset(new SparseMatrixAdapter(simulator_()));
+            jacobian_->reserve(sparsityPattern_);
+            return;
+        }
 
-                for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
-                    unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
-                    sparsityPattern_[myIdx].insert(neighborIdx);
-                }
-            }
+        const int numRows = static_cast<int>(domainPatternOffsets_.size()) - 1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            // the columns are sorted, so inserting them at the end is cheap
+            auto& row = sparsityPattern_[rowIdx];
+            for (std::size_t i = domainPatternOffsets_[rowIdx]; i < domainPatternOffsets_[rowIdx + 1]; ++i)
+                row.insert(row.end(), domainPatternColumns_[i]);
         }
 
         // add the additional neighbors and degrees of freedom caused by the auxiliary
         // equations
-        size_t numAuxMod = model.numAuxiliaryModules();
         for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
             model.auxiliaryModule(auxModIdx)->addNeighbors(sparsityPattern_);
 
@@ -451,12 +546,85 @@ private:
         jacobian_->reserve(sparsityPattern_);
     }
 
+    // determine the sparsity pattern of the spatial domain in compressed row format. the
+    // element stencils are evaluated in parallel and each thread records the pairs of
+    // degrees of freedom it encounters, which are merged into the rows afterwards.
+    void createDomainPattern_()
+    {
+        const std::size_t numGridDof = model_().numGridDof();
+        std::vector<std::vector<std::pair<unsigned, unsigned>>> threadEntries(ThreadManager::maxThreads());
+
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            auto& entries = threadEntries[ThreadManager::threadId()];
+            Stencil stencil(gridView_(), model_().dofMapper());
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                stencil.update(*elemIt);
+
+                for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                    unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+                    for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx)
+                        entries.emplace_back(myIdx, stencil.globalSpaceIndex(dofIdx));
+                }
+            }
+        }
+
+        // bucket the entries by row
+        domainPatternOffsets_.assign(numGridDof + 1, 0);
+        for (const auto& entries : threadEntries)
+            for (const auto& entry : entries)
+                ++domainPatternOffsets_[entry.first + 1];
+        for (std::size_t rowIdx = 0; rowIdx < numGridDof; ++rowIdx)
+            domainPatternOffsets_[rowIdx + 1] += domainPatternOffsets_[rowIdx];
+
+        domainPatternColumns_.resize(domainPatternOffsets_.back());
+        std::vector<std::size_t> fillPos(domainPatternOffsets_.begin(), domainPatternOffsets_.end() - 1);
+        for (auto& entries : threadEntries) {
+            for (const auto& [rowIdx, colIdx] : entries)
+                domainPatternColumns_[fillPos[rowIdx]++] = colIdx;
+            entries = {};
+        }
+
+        // sort the rows and remove the duplicates which stem from DOFs shared by
+        // multiple elements
+        const int numRows = static_cast<int>(numGridDof);
+        std::vector<std::size_t> rowSize(numGridDof);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            auto rowBegin = domainPatternColumns_.begin() + domainPatternOffsets_[rowIdx];
+            auto rowEnd = domainPatternColumns_.begin() + domainPatternOffsets_[rowIdx + 1];
+            std::sort(rowBegin, rowEnd);
+            rowSize[rowIdx] = std::unique(rowBegin, rowEnd) - rowBegin;
+        }
+
+        // compact the rows
+        std::size_t pos = 0;
+        for (std::size_t rowIdx = 0; rowIdx < numGridDof; ++rowIdx) {
+            const std::size_t rowBegin = domainPatternOffsets_[rowIdx];
+            std::move(domainPatternColumns_.begin() + rowBegin,
+                      domainPatternColumns_.begin() + rowBegin + rowSize[rowIdx],
+                      domainPatternColumns_.begin() + pos);
+            domainPatternOffsets_[rowIdx] = pos;
+            pos += rowSize[rowIdx];
+        }
+        domainPatternOffsets_[numGridDof] = pos;
+        domainPatternColumns_.resize(pos);
+        domainPatternColumns_.shrink_to_fit();
+    }
+
     // reset the global linear system of equations.
     void resetSystem_()
     {
         residual_ = 0.0;
         // zero all matrix entries
-        jacobian_->clear();
+        if (!reuseJacobian_)
+            jacobian_->clear();
     }
 
     // query the problem for all constraint degrees of freedom. note that this method is
@@ -523,6 +691,27 @@ private:
 
         applyConstraintsToSolution_();
 
+        // the lazily computed data of the problem must not be created concurrently
+        problem_().updateCaches();
+
+        // if the elements share primary degrees of freedom, the full domain is
+        // linearized color by color, so that no locking is required
+        if constexpr (std::is_same_v<SubDomainType, FullDomain>) {
+            if (getPropValue<TypeTag, Properties::UseLinearizationLock>()) {
+                linearizeColored_();
+                applyConstraintsToLinearization_();
+                return;
+            }
+
+            // if the per-DOF arrays were placed on the NUMA nodes, the elements are
+            // partitioned statically in the same way
+            if (!model_().staticElementSeeds().empty()) {
+                linearizeStatic_();
+                applyConstraintsToLinearization_();
+                return;
+            }
+        }
+
         // to avoid a race condition if two threads handle an exception at the same time,
         // we use an explicit lock to control access to the exception storage object
         // amongst thread-local handlers
@@ -539,6 +728,7 @@ private:
 #pragma omp parallel
 #endif
         {
+            NoAllocationRegion noAllocationRegion("FvBaseLinearizer::linearize_");
             auto elemIt = threadedElemIt.beginParallel();
             auto nextElemIt = elemIt;
             try {
@@ -590,9 +780,148 @@ private:
     }
 
 
+    // partition the elements which need to be linearized into sets of elements which
+    // do not share any primary degree of freedom. this uses a greedy coloring, i.e.,
+    // each element gets the smallest color which is not used by any of the elements
+    // that were already colored and share one of its primary degrees of freedom.
+    void createElementColors_()
+    {
+        const std::size_t numGridDof = model_().numGridDof();
+        Stencil stencil(gridView_(), model_().dofMapper());
+
+        std::vector<ElementSeed> seeds;
+        std::vector<std::size_t> dofOffsets(1, 0);
+        std::vector<unsigned> primaryDofs;
+        for (const auto& elem : elements(gridView_())) {
+            if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            stencil.update(elem);
+            seeds.push_back(elem.seed());
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx)
+                primaryDofs.push_back(stencil.globalSpaceIndex(primaryDofIdx));
+            dofOffsets.push_back(primaryDofs.size());
+        }
+
+        // the colors of the elements which were colored so far for each degree of
+        // freedom
+        std::vector<std::vector<bool>> dofUsesColor(numGridDof);
+        std::vector<bool> colorIsTaken;
+        elementColors_.clear();
+        for (std::size_t elemIdx = 0; elemIdx < seeds.size(); ++elemIdx) {
+            colorIsTaken.assign(elementColors_.size(), false);
+            for (std::size_t i = dofOffsets[elemIdx]; i < dofOffsets[elemIdx + 1]; ++i) {
+                const auto& usedColors = dofUsesColor[primaryDofs[i]];
+                for (std::size_t colorIdx = 0; colorIdx < usedColors.size(); ++colorIdx)
+                    if (usedColors[colorIdx])
+                        colorIsTaken[colorIdx] = true;
+            }
+
+            const std::size_t colorIdx =
+                std::find(colorIsTaken.begin(), colorIsTaken.end(), false) - colorIsTaken.begin();
+            if (colorIdx == elementColors_.size())
+                elementColors_.emplace_back();
+            elementColors_[colorIdx].push_back(seeds[elemIdx]);
+
+            for (std::size_t i = dofOffsets[elemIdx]; i < dofOffsets[elemIdx + 1]; ++i) {
+                auto& usedColors = dofUsesColor[primaryDofs[i]];
+                if (usedColors.size() <= colorIdx)
+                    usedColors.resize(colorIdx + 1, false);
+                usedColors[colorIdx] = true;
+            }
+        }
+    }
+
+    // linearize the full domain without locking by processing the elements of one
+    // color concurrently at a time
+    void linearizeColored_()
+    {
+        if (elementColors_.empty())
+            createElementColors_();
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed = false;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            NoAllocationRegion noAllocationRegion("FvBaseLinearizer::linearize_");
+            for (const auto& colorSeeds : elementColors_) {
+                const int numElems = static_cast<int>(colorSeeds.size());
+#ifdef _OPENMP
+#pragma omp for schedule(guided)
+#endif
+                for (int elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                    if (failed)
+                        continue;
+
+                    try {
+                        const auto& elem = gridView_().grid().entity(colorSeeds[elemIdx]);
+                        linearizeElement_(elem, /*useLock=*/false);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> take(exceptionLock);
+                        exceptionPtr = std::current_exception();
+                        failed = true;
+                    }
+                }
+                // the implicit barrier of the worksharing loop ensures that the next color
+                // is only started after all elements of the current one are finished
+            }
+        } // parallel block
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
+    // linearize the full domain using the static partition of the elements which
+    // matches the NUMA placement of the per-DOF arrays of the model
+    void linearizeStatic_()
+    {
+        const auto& elementSeeds = model_().staticElementSeeds();
+        const int numElems = static_cast<int>(elementSeeds.size());
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed = false;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            NoAllocationRegion noAllocationRegion("FvBaseLinearizer::linearize_");
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                if (failed)
+                    continue;
+
+                try {
+                    const auto& elem = gridView_().grid().entity(elementSeeds[elemIdx]);
+                    if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                        continue;
+
+                    linearizeElement_(elem);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+        } // parallel block
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
     // linearize an element in the interior of the process' grid partition
     template <class ElementType>
-    void linearizeElement_(const ElementType& elem)
+    void linearizeElement_(const ElementType& elem,
+                           bool useLock = getPropValue<TypeTag, Properties::UseLinearizationLock>())
     {
         unsigned threadId = ThreadManager::threadId();
 
@@ -603,7 +932,7 @@ private:
         localLinearizer.linearize(*elementCtx, elem);
 
         // update the right hand side and the Jacobian matrix
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.lock();
 
         size_t numPrimaryDof = elementCtx->numPrimaryDof(/*timeIdx=*/0);
@@ -613,15 +942,20 @@ private:
             // update the right hand side
             residual_[globI] += localLinearizer.residual(primaryDofIdx);
 
+            if (reuseJacobian_)
+                continue;
+
             // update the global Jacobian matrix
             for (unsigned dofIdx = 0; dofIdx < elementCtx->numDof(/*timeIdx=*/0); ++ dofIdx) {
                 unsigned globJ = elementCtx->globalSpaceIndex(/*spaceIdx=*/dofIdx, /*timeIdx=*/0);
+                if (!assembleOffDiagonalBlocks_() && globJ != globI)
+                    continue;
 
                 jacobian_->addToBlock(globJ, globI, localLinearizer.jacobian(dofIdx, primaryDofIdx));
             }
         }
 
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.unlock();
     }
 
@@ -665,6 +999,21 @@ private:
         }
     }
 
+    // apply the constraints to the linearization of some degrees of freedom
+    void applyConstraintsToLinearization_(const std::vector<int>& dofIndices)
+    {
+        if (!enableConstraints_())
+            return;
+
+        for (const int dofIdx : dofIndices) {
+            if (constraintsMap_.count(static_cast<unsigned>(dofIdx)) == 0)
+                continue;
+
+            jacobian_->clearRow(dofIdx, Scalar(1.0));
+            residual_[dofIdx] = 0.0;
+        }
+    }
+
     static bool enableConstraints_()
     { return getPropValue<TypeTag, Properties::EnableConstraints>(); }
 
@@ -692,11 +1041,20 @@ private:
     GlobalEqVector residual_;
 
     LinearizationType linearizationType_;
+    bool reuseJacobian_ = false;
 
     std::mutex globalMatrixMutex_;
 
     std::vector<std::set<unsigned int>> sparsityPattern_;
 
+    // the part of the sparsity pattern which is caused by the element stencils in
+    // compressed row format
+    std::vector<std::size_t> domainPatternOffsets_;
+    std::vector<unsigned> domainPatternColumns_;
+
+    // the elements grouped by the color of the lock-free linearization schedule
+    std::vector<std::vector<ElementSeed>> elementColors_;
+
     struct FullDomain
     {
         explicit FullDomain(const GridView& v) : view (v) {}
@@ -99,6 +99,15 @@ public:
     static void registerParameters()
     { }
 
+    /*!
+     * \brief Allocate the internal storage for the residual of a stencil with a given
+     *        number of degrees of freedom up front.
+     *
+     * \param numDof The largest number of degrees of freedom of an element stencil
+     */
+    void reserve(size_t numDof)
+    { internalResidual_.reserve(numDof); }
+
     /*!
      * \brief Return the result of the eval() call using internal
      *        storage.
@@ -536,7 +545,8 @@ protected:
                 const auto& model = elemCtx.model();
                 unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
                 if (model.newtonMethod().numIterations() == 0 &&
-                    !elemCtx.haveStashedIntensiveQuantities())
+                    !elemCtx.haveStashedIntensiveQuantities() &&
+                    !elemCtx.storageCacheIsReadOnly())
                 {
                     if (!elemCtx.problem().recycleFirstIterationStorage()) {
                         // we re-calculate the storage term for the solution of the
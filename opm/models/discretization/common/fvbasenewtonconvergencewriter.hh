@@ -97,12 +97,16 @@ public:
     void beginIteration()
     {
         ++ iteration_;
-        if (!vtkMultiWriter_)
+        if (!vtkMultiWriter_) {
             vtkMultiWriter_ =
                 new VtkMultiWriter(/*async=*/false,
                                    newtonMethod_.problem().gridView(),
                                    newtonMethod_.problem().outputDir(),
                                    "convergence");
+            const auto& model = newtonMethod_.problem().model();
+            vtkMultiWriter_->setPermutations(model.elementMapper().permutation(),
+                                             model.vertexMapper().permutation());
+        }
         vtkMultiWriter_->beginWrite(timeStepIdx_ + iteration_ / 100.0);
     }
 
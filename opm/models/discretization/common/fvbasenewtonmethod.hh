@@ -29,9 +29,31 @@
 #define EWOMS_FV_BASE_NEWTON_METHOD_HH
 
 #include "fvbasenewtonconvergencewriter.hh"
+#include "nlddsubdomain.hh"
+
+#include <opm/common/Exceptions.hpp>
 
 #include <opm/models/nonlinear/newtonmethod.hh>
+#include <opm/models/nonlinear/newtonmethodparameters.hh>
+#include <opm/models/utils/parametersystem.hpp>
 #include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/timer.hh>
+
+#include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/nlddlocalsystem.hh>
+
+#include <dune/common/exceptions.hh>
+#include <dune/grid/common/partitionset.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace Opm {
 
@@ -78,6 +100,17 @@ namespace Opm {
  *
  * This class is sufficient for most models which use an Element or a
  * Vertex Centered Finite Volume discretization.
+ *
+ * Optionally, the degrees of freedom of each process are partitioned into subdomains
+ * and the nonlinear problem of each subdomain is solved by a local Newton method
+ * before the global update is computed ("nonlinear domain decomposition"). The
+ * unknowns outside of the subdomain are kept fixed for this. The subdomains are
+ * colored such that the subdomains of a color neither share degrees of freedom nor
+ * neighbors. The colors are visited one after the other, so each subdomain sees the
+ * solutions of the subdomains of the previous colors, and the subdomains of a color
+ * are solved concurrently by the threads of the process. Since this resolves most of
+ * the local nonlinearities, the global Newton method usually requires less
+ * iterations.
  */
 template <class TypeTag>
 class FvBaseNewtonMethod : public NewtonMethod<TypeTag>
@@ -88,17 +121,67 @@ class FvBaseNewtonMethod : public NewtonMethod<TypeTag>
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using Model = GetPropType<TypeTag, Properties::Model>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
     using Linearizer = GetPropType<TypeTag, Properties::Linearizer>;
     using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
     using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
     using EqVector = GetPropType<TypeTag, Properties::EqVector>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using Stencil = GetPropType<TypeTag, Properties::Stencil>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+    using LinearSolverBackend = GetPropType<TypeTag, Properties::LinearSolverBackend>;
+    using IstlMatrix = typename SparseMatrixAdapter::IstlMatrix;
 
+    using ElementSeed = typename GridView::template Codim<0>::Entity::EntitySeed;
+    using SubDomain = NlddSubDomain<ElementSeed>;
+    using LocalSystem = Linear::NlddLocalSystem<IstlMatrix, GlobalEqVector>;
 
 public:
     FvBaseNewtonMethod(Simulator& simulator)
         : ParentType(simulator)
-    { }
+    {
+        numSubDomains_ = std::max(0, Parameters::Get<Parameters::NewtonNumSubDomains>());
+        maxSubDomainIterations_ = Parameters::Get<Parameters::NewtonMaxSubDomainIterations>();
+        subDomainLinearReduction_ = Parameters::Get<Parameters::NewtonSubDomainLinearReduction<Scalar>>();
+    }
+
+    /*!
+     * \brief Register all run-time parameters for the Newton method.
+     */
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        Parameters::Register<Parameters::NewtonNumSubDomains>
+            ("The number of subdomains per process whose nonlinear problems are solved "
+             "before each global Newton update. 0 disables the domain decomposition");
+        Parameters::Register<Parameters::NewtonMaxSubDomainIterations>
+            ("The maximum number of local Newton iterations per subdomain and global "
+             "iteration");
+        Parameters::Register<Parameters::NewtonSubDomainLinearReduction<Scalar>>
+            ("The reduction of the residual required by the linear solver of a "
+             "subdomain");
+    }
+
+    /*!
+     * \brief Returns the number of local Newton iterations of all subdomains so far.
+     */
+    long numSubDomainIterations() const
+    { return numSubDomainIterations_; }
+
+    /*!
+     * \brief Returns how often the local Newton method of a subdomain failed so far.
+     */
+    long numFailedSubDomainSolves() const
+    { return numFailedSubDomainSolves_; }
+
+    /*!
+     * \brief Returns the timer for solving the nonlinear problems of the subdomains.
+     */
+    const Timer& subDomainTimer() const
+    { return subDomainTimer_; }
 
 protected:
     friend class NewtonMethod<TypeTag>;
@@ -147,6 +230,83 @@ protected:
         ParentType::beginIteration_();
     }
 
+    /*!
+     * \brief Solve the nonlinear problems of the subdomains of this process.
+     *
+     * The global system must have been linearized for the current solution. Subdomains
+     * whose local Newton method fails keep their initial solution. Returns true if the
+     * domain decomposition is enabled, i.e., if the solution may have been changed.
+     */
+    bool solveSubDomains_(SolutionVector& nextSolution)
+    {
+        // the local systems of the subdomains are extracted from the Jacobian, so they
+        // are not available if only its diagonal blocks are assembled
+        if (numSubDomains_ == 0 || model_().numAuxiliaryModules() > 0 ||
+            !Linear::NeedsOffDiagonalBlocks<LinearSolverBackend>::value)
+            return false;
+
+        auto& linearizer = model_().linearizer();
+        const IstlMatrix& jacobian = linearizer.jacobian().istlMatrix();
+        if (subDomains_.empty() || subDomainNumDof_ != model_().numGridDof())
+            createSubDomains_(jacobian);
+        if (localSystemMatrix_ != &jacobian)
+            createLocalSystems_(jacobian);
+
+        Timer timer;
+        timer.start();
+
+        std::atomic<int> numLocalIterations = 0;
+        std::atomic<int> numFailedSubDomains = 0;
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> exceptionCaught = false;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext& elemCtx = *subDomainElemCtx_[ThreadManager::threadId()];
+            for (const auto& colorDomains : subDomainColors_) {
+                const int numColorDomains = static_cast<int>(colorDomains.size());
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                for (int i = 0; i < numColorDomains; ++i) {
+                    if (exceptionCaught)
+                        continue;
+
+                    try {
+                        bool failed = false;
+                        numLocalIterations += solveSubDomain_(colorDomains[i], nextSolution, elemCtx, failed);
+                        if (failed)
+                            ++numFailedSubDomains;
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> take(exceptionLock);
+                        exceptionPtr = std::current_exception();
+                        exceptionCaught = true;
+                    }
+                }
+                // the implicit barrier of the worksharing loop ensures that the next color
+                // is only started after all subdomains of the current one are solved
+            }
+        } // parallel block
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+
+        timer.stop();
+        subDomainTimer_ += timer;
+        numSubDomainIterations_ += numLocalIterations;
+        numFailedSubDomainSolves_ += numFailedSubDomains;
+
+        this->endIterMsg() << ", subdomain iterations=" << numLocalIterations
+                           << " (" << numFailedSubDomains << " of " << subDomains_.size()
+                           << " subdomains failed, " << timer.realTimeElapsed() << " seconds)";
+
+        return true;
+    }
+
     /*!
      * \brief Returns a reference to the model.
      */
@@ -160,11 +320,196 @@ protected:
     { return ParentType::model(); }
 
 private:
+    // partition the degrees of freedom which are only attached to interior elements.
+    // the others are not changed by the local solves, so the solutions of the
+    // processes stay consistent.
+    void createSubDomains_(const IstlMatrix& jacobian)
+    {
+        const auto& gridView = model_().gridView();
+        const std::size_t numGridDof = model_().numGridDof();
+        Stencil stencil(gridView, model_().dofMapper());
+
+        std::vector<bool> active(jacobian.N(), false);
+        std::vector<bool> excluded(jacobian.N(), false);
+        for (const auto& elem : elements(gridView)) {
+            stencil.update(elem);
+            const bool isInterior = elem.partitionType() == Dune::InteriorEntity;
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                const unsigned globalIdx = stencil.globalSpaceIndex(primaryDofIdx);
+                if (isInterior)
+                    active[globalIdx] = true;
+                else
+                    excluded[globalIdx] = true;
+            }
+        }
+        for (std::size_t dofIdx = 0; dofIdx < active.size(); ++dofIdx)
+            active[dofIdx] = active[dofIdx] && !excluded[dofIdx];
+
+        const std::vector<int> domainOfDof = partitionMatrixGraph(jacobian, active, numSubDomains_);
+        int numDomains = 0;
+        for (const int domainIdx : domainOfDof)
+            numDomains = std::max(numDomains, domainIdx + 1);
+
+        subDomains_.clear();
+        subDomains_.resize(numDomains);
+        for (std::size_t domainIdx = 0; domainIdx < subDomains_.size(); ++domainIdx)
+            subDomains_[domainIdx].index = domainIdx;
+        for (std::size_t dofIdx = 0; dofIdx < domainOfDof.size(); ++dofIdx)
+            if (domainOfDof[dofIdx] >= 0)
+                subDomains_[domainOfDof[dofIdx]].cells.push_back(dofIdx);
+
+        // each element contributes to the subdomains of all its primary degrees of
+        // freedom
+        std::vector<int> elemDomains;
+        for (const auto& elem : elements(gridView, Dune::Partitions::interior)) {
+            stencil.update(elem);
+            elemDomains.clear();
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                const int domainIdx = domainOfDof[stencil.globalSpaceIndex(primaryDofIdx)];
+                if (domainIdx >= 0 &&
+                    std::find(elemDomains.begin(), elemDomains.end(), domainIdx) == elemDomains.end())
+                    elemDomains.push_back(domainIdx);
+            }
+            for (const int domainIdx : elemDomains)
+                subDomains_[domainIdx].elements.push_back(elem.seed());
+        }
+
+        subDomainColors_ = colorSubDomains(jacobian, domainOfDof, numDomains);
+
+        subDomainBackups_.resize(subDomains_.size());
+        for (std::size_t domainIdx = 0; domainIdx < subDomains_.size(); ++domainIdx)
+            subDomainBackups_[domainIdx].resize(subDomains_[domainIdx].cells.size());
+
+        if (subDomainElemCtx_.empty())
+            for (unsigned threadId = 0; threadId < ThreadManager::maxThreads(); ++threadId)
+                subDomainElemCtx_.push_back(std::make_unique<ElementContext>(this->simulator_));
+
+        subDomainNumDof_ = numGridDof;
+        localSystemMatrix_ = nullptr;
+    }
+
+    // the local systems refer to the blocks of the global matrix, so they need to be
+    // recreated whenever the global matrix is
+    void createLocalSystems_(const IstlMatrix& jacobian)
+    {
+        std::vector<int> globalToLocal(jacobian.N(), -1);
+        localSystems_.clear();
+        for (const auto& domain : subDomains_)
+            localSystems_.push_back(std::make_unique<LocalSystem>(jacobian, domain.cells, globalToLocal));
+
+        subDomainUpdate_.resize(jacobian.N());
+        localSystemMatrix_ = &jacobian;
+    }
+
+    // the maximum weighted residual of the degrees of freedom of a subdomain
+    Scalar subDomainError_(const SubDomain& domain, const GlobalEqVector& residual) const
+    {
+        Scalar error = 0.0;
+        for (const int dofIdx : domain.cells) {
+            if (model_().dofTotalVolume(dofIdx) <= 0.0)
+                continue;
+
+            const auto& r = residual[dofIdx];
+            for (unsigned eqIdx = 0; eqIdx < r.size(); ++eqIdx)
+                error = std::max<Scalar>(std::abs(r[eqIdx]*model_().eqWeight(dofIdx, eqIdx)), error);
+        }
+        return error;
+    }
+
+    // run the local Newton method of a subdomain. returns the number of iterations.
+    // if the method diverges, the initial solution of the subdomain is restored.
+    int solveSubDomain_(int domainIdx,
+                        SolutionVector& nextSolution,
+                        ElementContext& elemCtx,
+                        bool& failed)
+    {
+        const SubDomain& domain = subDomains_[domainIdx];
+        LocalSystem& localSystem = *localSystems_[domainIdx];
+        auto& linearizer = model_().linearizer();
+
+        auto& backup = subDomainBackups_[domainIdx];
+        for (std::size_t i = 0; i < domain.cells.size(); ++i)
+            backup[i] = nextSolution[domain.cells[i]];
+
+        failed = false;
+        int iterIdx = 0;
+        try {
+            Scalar initialError = 0.0;
+            for (; iterIdx <= maxSubDomainIterations_; ++iterIdx) {
+                linearizer.linearizeDomain(domain);
+                const GlobalEqVector& residual = linearizer.residual();
+
+                const Scalar error = subDomainError_(domain, residual);
+                if (iterIdx == 0)
+                    initialError = error;
+                if (!std::isfinite(error) || error > initialError) {
+                    failed = true;
+                    break;
+                }
+                if (error <= this->tolerance() || iterIdx == maxSubDomainIterations_)
+                    break;
+
+                localSystem.assemble(residual);
+                if (!localSystem.solve(subDomainUpdate_, subDomainLinearReduction_, /*maxIterations=*/200)) {
+                    failed = true;
+                    break;
+                }
+
+                {
+                    // the implementation may count e.g. the switched primary variables,
+                    // so the updates are done by one thread at a time
+                    std::lock_guard<std::mutex> lock(subDomainUpdateMutex_);
+                    for (const int dofIdx : domain.cells) {
+                        const PrimaryVariables currentValue = nextSolution[dofIdx];
+                        asImp_().updatePrimaryVariables_(dofIdx,
+                                                         nextSolution[dofIdx],
+                                                         currentValue,
+                                                         subDomainUpdate_[dofIdx],
+                                                         residual[dofIdx]);
+                    }
+                }
+                model_().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0, domain, elemCtx);
+            }
+        }
+        catch (const Dune::Exception&) {
+            failed = true;
+        }
+        catch (const NumericalProblem&) {
+            failed = true;
+        }
+
+        if (failed) {
+            for (std::size_t i = 0; i < domain.cells.size(); ++i)
+                nextSolution[domain.cells[i]] = backup[i];
+            model_().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0, domain, elemCtx);
+        }
+
+        return iterIdx;
+    }
+
     Implementation& asImp_()
     { return *static_cast<Implementation*>(this); }
 
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
+
+    int numSubDomains_;
+    int maxSubDomainIterations_;
+    Scalar subDomainLinearReduction_;
+
+    std::vector<SubDomain> subDomains_;
+    std::vector<std::vector<int>> subDomainColors_;
+    std::size_t subDomainNumDof_ = 0;
+    std::vector<std::unique_ptr<LocalSystem>> localSystems_;
+    const IstlMatrix* localSystemMatrix_ = nullptr;
+    GlobalEqVector subDomainUpdate_;
+    std::vector<std::vector<PrimaryVariables>> subDomainBackups_;
+    std::vector<std::unique_ptr<ElementContext>> subDomainElemCtx_;
+    std::mutex subDomainUpdateMutex_;
+
+    Timer subDomainTimer_;
+    long numSubDomainIterations_ = 0;
+    long numFailedSubDomainSolves_ = 0;
 };
 } // namespace Opm
 
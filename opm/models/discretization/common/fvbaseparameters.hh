@@ -41,14 +41,23 @@ namespace Opm::Parameters {
  */
 struct ContinueOnConvergenceError { static constexpr bool value = false; };
 
+/*!
+ * \brief The ordering of the degrees of freedom.
+ *
+ * Possible values are 'none' (use the order of the grid), 'rcm' (reverse
+ * Cuthill-McKee) and 'morton' (Morton space-filling curve).
+ */
+struct DofOrdering { static constexpr auto value = "none"; };
+
 /*!
  * \brief Determines if the VTK output is written to disk asynchronously
  *
  * I.e. written to disk using a separate thread. This has only an effect if
- * EnableVtkOutput is true and if the simulation is run sequentially. The reasons for
- * this not being used for MPI-parallel simulations are that Dune's VTK output code does
- * not support multi-threaded multi-process VTK output and even if it would, the result
- * would be slower than when using synchronous output.
+ * EnableVtkOutput is true and if the simulation is run sequentially or the native VTK
+ * writer is used. The reasons for this not being used for MPI-parallel simulations with
+ * Dune's VTK writer are that Dune's VTK output code does not support multi-threaded
+ * multi-process VTK output and even if it would, the result would be slower than when
+ * using synchronous output.
  */
 struct EnableAsyncVtkOutput { static constexpr bool value = true; };
 
@@ -71,6 +80,24 @@ struct EnableGridAdaptation { static constexpr bool value = false; };
  */
 struct EnableIntensiveQuantityCache { static constexpr bool value = false; };
 
+/*!
+ * \brief Determines if the VTK files are written using the native writer.
+ *
+ * The native writer always writes raw binary appended data and extracts all data
+ * before the output is written, so it can also be used asynchronously for MPI-parallel
+ * simulations. If disabled, Dune's VTK writer is used with the format given by the
+ * VtkOutputFormat property.
+ */
+struct EnableNativeVtkOutput { static constexpr bool value = false; };
+
+/*!
+ * \brief Evaluate the initial solution and parse the restart files using all threads.
+ *
+ * This requires that the initial() method of the problem and the deserializeEntity()
+ * methods of the model and of the problem are thread-safe.
+ */
+struct EnableParallelStartup { static constexpr bool value = false; };
+
 /*!
  * \brief Specify whether the storage terms for previous solutions should be cached.
  *
@@ -97,6 +124,21 @@ struct EnableThermodynamicHints { static constexpr bool value = false; };
  */
 struct EnableVtkOutput { static constexpr bool value = true; };
 
+/*!
+ * \brief Determines if the data written by the native VTK writer is compressed.
+ *
+ * This requires zlib. If it is not available, the data is written uncompressed.
+ */
+struct EnableVtkOutputCompression { static constexpr bool value = false; };
+
+/*!
+ * \brief The number of threads which compress the data of the native VTK writer.
+ *
+ * With asynchronous output, the data is compressed while the simulation continues, so
+ * only a single thread is used by default.
+ */
+struct VtkOutputCompressionThreads { static constexpr int value = 1; };
+
 /*!
  * \brief Specify the maximum size of a time integration [s].
  *
@@ -119,14 +161,53 @@ struct MaxTimeStepDivisions { static constexpr unsigned value = 10; };
 template<class Scalar>
 struct MinTimeStepSize { static constexpr Scalar value = 0.0; };
 
+/*!
+ * \brief Place the pages of the large per-DOF arrays and of the Jacobian on the NUMA
+ *        nodes of the threads which process them.
+ */
+struct NumaAwareInitialization { static constexpr bool value = false; };
+
 /*!
  * \brief The directory to which simulation output ought to be written to.
  */
 struct OutputDir { static constexpr auto value = ""; };
 
+//! \brief Bind each thread to a CPU of the process, offset by the node-local MPI rank.
+struct PinThreads { static constexpr bool value = false; };
+
 //! \brief Number of threads per process.
 struct ThreadsPerProcess { static constexpr int value = 1; };
 
+/*!
+ * \brief The controller used to determine the size of the next time step.
+ *
+ * Possible values are 'newton' (use the heuristic of the Newton method),
+ * 'iterationcount' (target the number of Newton iterations given by
+ * NewtonTargetIterations) and 'pid' (target a relative change of the solution).
+ */
+struct TimeStepController { static constexpr auto value = "newton"; };
+
+/*!
+ * \brief The factor by which the time step size is reduced by the 'iterationcount'
+ *        time step controller if too many Newton iterations were required.
+ */
+template<class Scalar>
+struct TimeStepControllerDecayRate { static constexpr Scalar value = 0.75; };
+
+/*!
+ * \brief The maximum factor by which the time step size is increased by the
+ *        'iterationcount' and 'pid' time step controllers.
+ */
+template<class Scalar>
+struct TimeStepControllerGrowthRate { static constexpr Scalar value = 1.25; };
+
+/*!
+ * \brief The relative change of the solution per time step targeted by the 'pid' time
+ *        step controller.
+ */
+template<class Scalar>
+struct TimeStepControllerTolerance { static constexpr Scalar value = 0.1; };
+
 } // namespace Opm::Parameters
 
 #endif
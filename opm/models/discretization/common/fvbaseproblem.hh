@@ -35,10 +35,19 @@
 #include <opm/models/io/restart.hh>
 #include <opm/models/discretization/common/restrictprolong.hh>
 
+#include <opm/models/nonlinear/newtonmethodparameters.hh>
+
+#include <opm/models/utils/timestepcontroller.hh>
+
 #include <dune/common/fvector.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include <sys/stat.h>
@@ -122,6 +131,9 @@ public:
         , boundingBoxMax_(-std::numeric_limits<double>::max())
         , simulator_(simulator)
         , defaultVtkWriter_(0)
+        , suggestedTimeStepSize_(0.0)
+        , numNewtonIterations_(0)
+        , numWastedNewtonIterations_(0)
     {
         // calculate the bounding box of the local partition of the grid view
         VertexIterator vIt = gridView_.template begin<dim>();
@@ -139,24 +151,50 @@ public:
             boundingBoxMax_[i] = gridView_.comm().max(boundingBoxMax_[i]);
         }
 
+        // number the elements and vertices like the model
+        elementMapper_.setPermutation(simulator.model().elementMapper().permutation());
+        vertexMapper_.setPermutation(simulator.model().vertexMapper().permutation());
+
         if (enableVtkOutput_()) {
+            // the native VTK writer extracts all data before it is written, so it can
+            // be used asynchronously in parallel and for adaptive grids
+            bool nativeVtkOutput = Parameters::Get<Parameters::EnableNativeVtkOutput>();
             bool asyncVtkOutput =
-                simulator_.gridView().comm().size() == 1 &&
+                (simulator_.gridView().comm().size() == 1 || nativeVtkOutput) &&
                 Parameters::Get<Parameters::EnableAsyncVtkOutput>();
 
             // asynchonous VTK output currently does not work in conjunction with grid
             // adaptivity because the async-IO code assumes that the grid stays
             // constant. complain about that case.
             bool enableGridAdaptation = Parameters::Get<Parameters::EnableGridAdaptation>();
-            if (asyncVtkOutput && enableGridAdaptation)
+            if (asyncVtkOutput && !nativeVtkOutput && enableGridAdaptation)
                 throw std::runtime_error("Asynchronous VTK output currently cannot be used "
                                          "at the same time as grid adaptivity");
 
             std::string outputDir = asImp_().outputDir();
 
             defaultVtkWriter_ =
-                new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name());
+                new VtkMultiWriter(asyncVtkOutput, gridView_, outputDir, asImp_().name(),
+                                   /*multiFileName=*/"",
+                                   nativeVtkOutput,
+                                   Parameters::Get<Parameters::EnableVtkOutputCompression>(),
+                                   Parameters::Get<Parameters::VtkOutputCompressionThreads>());
+            defaultVtkWriter_->setPermutations(elementMapper_.permutation(),
+                                               vertexMapper_.permutation());
         }
+
+        const std::string controllerType = Parameters::Get<Parameters::TimeStepController>();
+        if (controllerType == "iterationcount")
+            timeStepController_ = std::make_unique<IterationCountTimeStepController<Scalar>>
+                (Parameters::Get<Parameters::NewtonTargetIterations>(),
+                 Parameters::Get<Parameters::TimeStepControllerDecayRate<Scalar>>(),
+                 Parameters::Get<Parameters::TimeStepControllerGrowthRate<Scalar>>());
+        else if (controllerType == "pid")
+            timeStepController_ = std::make_unique<PidTimeStepController<Scalar>>
+                (Parameters::Get<Parameters::TimeStepControllerTolerance<Scalar>>(),
+                 Parameters::Get<Parameters::TimeStepControllerGrowthRate<Scalar>>());
+        else if (controllerType != "newton")
+            throw std::invalid_argument("Unknown time step controller '" + controllerType + "'");
     }
 
     ~FvBaseProblem()
@@ -178,10 +216,30 @@ public:
              "before the simulation bails out");
         Parameters::Register<Parameters::EnableAsyncVtkOutput>
             ("Dispatch a separate thread to write the VTK output");
+        Parameters::Register<Parameters::EnableNativeVtkOutput>
+            ("Write the VTK output using raw binary appended data instead of using "
+             "Dune's VTK writer");
+        Parameters::Register<Parameters::EnableVtkOutputCompression>
+            ("Compress the VTK output written by the native VTK writer");
+        Parameters::Register<Parameters::VtkOutputCompressionThreads>
+            ("The number of threads which compress the VTK output of the native VTK "
+             "writer");
         Parameters::Register<Parameters::ContinueOnConvergenceError>
             ("Continue with a non-converged solution instead of giving up "
              "if we encounter a time step size smaller than the minimum time "
              "step size.");
+        Parameters::Register<Parameters::TimeStepController>
+            ("The controller used to determine the size of the next time step. Possible "
+             "values are 'newton', 'iterationcount' and 'pid'");
+        Parameters::Register<Parameters::TimeStepControllerDecayRate<Scalar>>
+            ("The factor by which the time step size is reduced by the 'iterationcount' "
+             "controller if too many Newton iterations were required");
+        Parameters::Register<Parameters::TimeStepControllerGrowthRate<Scalar>>
+            ("The maximum factor by which the time step size is increased by the "
+             "'iterationcount' and 'pid' controllers");
+        Parameters::Register<Parameters::TimeStepControllerTolerance<Scalar>>
+            ("The relative change of the solution per time step targeted by the 'pid' "
+             "controller");
     }
 
     /*!
@@ -287,6 +345,15 @@ public:
     void finishInit()
     { }
 
+    /*!
+     * \brief Create the lazily computed data of the problem which is not up to date.
+     *
+     * This is called by the model and by the linearizer before the elements are
+     * processed concurrently, so that the data is not created within these loops.
+     */
+    void updateCaches() const
+    { }
+
     /*!
      * \brief Allows to improve the performance by prefetching all data which is
      *        associated with a given element.
@@ -476,6 +543,18 @@ public:
         Scalar updateTime = simulator().updateTimer().realTimeElapsed();
         unsigned numProcesses = static_cast<unsigned>(this->gridView().comm().size());
         unsigned threadsPerProcess = ThreadManager::maxThreads();
+
+        Scalar outputMegaBytes = 0.0;
+        Scalar outputWriteTime = 0.0;
+        Scalar outputWaitTime = 0.0;
+        if (defaultVtkWriter_) {
+            defaultVtkWriter_->waitForPendingOutput();
+            const auto& comm = gridView().comm();
+            outputMegaBytes = comm.sum(static_cast<Scalar>(defaultVtkWriter_->numBytesWritten()))/(1024*1024);
+            outputWriteTime = comm.max(static_cast<Scalar>(defaultVtkWriter_->writeTime()));
+            outputWaitTime = comm.max(static_cast<Scalar>(defaultVtkWriter_->waitTime()));
+        }
+
         if (gridView().comm().rank() == 0) {
             std::cout << std::setprecision(3)
                       << "Simulation of problem '" << asImp_().name() << "' finished.\n"
@@ -495,6 +574,12 @@ public:
                       << ", " << prePostProcessTime/executionTime*100 << "%\n"
                       << "    Output write time: "  << writeTime << " seconds" << Simulator::humanReadableTime(writeTime)
                       << ", " << writeTime/executionTime*100 << "%\n"
+                      << "    Output bandwidth: " << outputMegaBytes/std::max(outputWriteTime, Scalar(1e-10)) << " MB/s"
+                      << " (" << outputMegaBytes << " MB written in " << outputWriteTime << " seconds"
+                      << ", simulation blocked for " << outputWaitTime << " seconds)\n"
+                      << "Newton iterations: " << numNewtonIterations_
+                      << " (" << numWastedNewtonIterations_ << " wasted by failed time steps"
+                      << ", " << wastedNewtonIterationsPerYear() << " per simulated year)\n"
                       << "First process' simulation CPU time: "  << localCpuTime << " seconds" <<  Simulator::humanReadableTime(localCpuTime) << "\n"
                       << "Number of processes: " << numProcesses << "\n"
                       << "Threads per processes: " << threadsPerProcess << "\n"
@@ -517,9 +602,13 @@ public:
         std::string errorMessage;
         for (unsigned i = 0; i < maxFails; ++i) {
             bool converged = model().update();
+            numNewtonIterations_ += newtonMethod().numLastIterations();
             if (converged)
                 return;
 
+            // all iterations of a failed attempt are lost
+            numWastedNewtonIterations_ += newtonMethod().numLastIterations();
+
             Scalar dt = simulator().timeStepSize();
             Scalar nextDt = dt / 2.0;
             if (dt < minTimeStepSize*(1 + 1e-9)) {
@@ -556,6 +645,31 @@ public:
         throw std::runtime_error(errorMessage);
     }
 
+    /*!
+     * \brief Returns the total number of Newton iterations done by the time integration.
+     */
+    unsigned numNewtonIterations() const
+    { return numNewtonIterations_; }
+
+    /*!
+     * \brief Returns the number of Newton iterations spent on time integrations which
+     *        did not converge and thus had to be repeated with a smaller time step.
+     */
+    unsigned numWastedNewtonIterations() const
+    { return numWastedNewtonIterations_; }
+
+    /*!
+     * \brief Returns the number of wasted Newton iterations per simulated year.
+     */
+    Scalar wastedNewtonIterationsPerYear() const
+    {
+        Scalar simulatedTime = simulator().time() - simulator().startTime();
+        if (simulatedTime <= 0.0)
+            return 0.0;
+
+        return numWastedNewtonIterations_/(simulatedTime/(365.25*24*60*60));
+    }
+
     /*!
      * \brief Returns the minimum allowable size of a time step.
      */
@@ -593,8 +707,15 @@ public:
         if (nextTimeStepSize_ > 0.0)
             return nextTimeStepSize_;
 
+        // fall back to the heuristic of the Newton method if the time step controller
+        // has not been asked for a suggestion yet
+        Scalar suggestedDt =
+            (timeStepController_ && suggestedTimeStepSize_ > 0.0)
+            ? std::max(asImp_().minTimeStepSize(), suggestedTimeStepSize_)
+            : newtonMethod().suggestTimeStepSize(simulator().timeStepSize());
+
         Scalar dtNext = std::min(Parameters::Get<Parameters::MaxTimeStepSize<Scalar>>(),
-                                 newtonMethod().suggestTimeStepSize(simulator().timeStepSize()));
+                                 suggestedDt);
 
         if (dtNext < simulator().maxTimeStepSize()
             && simulator().maxTimeStepSize() < dtNext*2)
@@ -636,7 +757,15 @@ public:
      *        model should be prepared to do the next time integration.
      */
     void advanceTimeLevel()
-    { model().advanceTimeLevel(); }
+    {
+        // the time step controller needs the solution of the previous time step, so
+        // the next time step size must be determined before it is overwritten. this is
+        // done here rather than in timeIntegration() because the latter is often
+        // overridden.
+        suggestTimeStepSize_();
+
+        model().advanceTimeLevel();
+    }
 
     /*!
      * \brief The problem name.
@@ -805,12 +934,60 @@ public:
      *        to write the default ouput after each time step to disk.
      */
     VtkMultiWriter& defaultVtkWriter() const
-    { return defaultVtkWriter_; }
+    { return *defaultVtkWriter_; }
 
 protected:
     Scalar nextTimeStepSize_;
 
 private:
+    // ask the time step controller for the size of the next time step
+    void suggestTimeStepSize_()
+    {
+        if (!timeStepController_)
+            return;
+
+        Scalar relativeChange = 0.0;
+        if (timeStepController_->needRelativeChange())
+            relativeChange = relativeSolutionChange_();
+
+        suggestedTimeStepSize_ =
+            timeStepController_->suggestTimeStepSize(simulator().timeStepSize(),
+                                                     newtonMethod().numIterations(),
+                                                     relativeChange);
+    }
+
+    // the relative change of the solution over the current time step. for each primary
+    // variable, the L2 norm of its change is divided by the L2 norm of its new value
+    // and the maximum over all primary variables is returned.
+    Scalar relativeSolutionChange_() const
+    {
+        constexpr unsigned numPv = PrimaryVariables::dimension;
+        std::array<Scalar, 2*numPv> norms;
+        norms.fill(0.0);
+
+        const auto& curSol = model().solution(/*timeIdx=*/0);
+        const auto& oldSol = model().solution(/*timeIdx=*/1);
+        size_t numDof = model().numGridDof();
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            if (!model().isLocalDof(dofIdx))
+                continue;
+
+            for (unsigned pvIdx = 0; pvIdx < numPv; ++pvIdx) {
+                Scalar delta = curSol[dofIdx][pvIdx] - oldSol[dofIdx][pvIdx];
+                norms[pvIdx] += delta*delta;
+                norms[numPv + pvIdx] += curSol[dofIdx][pvIdx]*curSol[dofIdx][pvIdx];
+            }
+        }
+        gridView().comm().sum(norms.data(), norms.size());
+
+        Scalar result = 0.0;
+        for (unsigned pvIdx = 0; pvIdx < numPv; ++pvIdx) {
+            if (norms[numPv + pvIdx] > 0.0)
+                result = std::max(result, std::sqrt(norms[pvIdx]/norms[numPv + pvIdx]));
+        }
+        return result;
+    }
+
     bool enableVtkOutput_() const
     { return Parameters::Get<Parameters::EnableVtkOutput>(); }
 
@@ -832,6 +1009,12 @@ private:
     // Attributes required for the actual simulation
     Simulator& simulator_;
     mutable VtkMultiWriter *defaultVtkWriter_;
+
+    // time step control
+    std::unique_ptr<BaseTimeStepController<Scalar>> timeStepController_;
+    Scalar suggestedTimeStepSize_;
+    unsigned numNewtonIterations_;
+    unsigned numWastedNewtonIterations_;
 };
 
 } // namespace Opm
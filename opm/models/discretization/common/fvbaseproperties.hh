@@ -173,10 +173,11 @@ struct GridCommHandleFactory { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct ThreadManager { using type = UndefinedProperty; };
 
-//! use locking to prevent race conditions when linearizing the global system of
-//! equations in multi-threaded mode. (setting this property to true is always save, but
-//! it may slightly deter performance in multi-threaded simlations and some
-//! discretizations do not need this.)
+//! specifies whether the elements may share primary degrees of freedom, so that race
+//! conditions need to be prevented when linearizing the global system of equations in
+//! multi-threaded mode. (setting this property to true is always save. the full domain is
+//! then linearized using a colored element schedule, and locking is only used for
+//! sub-domains. some discretizations do not need this.)
 template<class TypeTag, class MyTypeTag>
 struct UseLinearizationLock { using type = UndefinedProperty; };
 
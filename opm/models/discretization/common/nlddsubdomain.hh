@@ -0,0 +1,195 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::NlddSubDomain
+ */
+#ifndef EWOMS_NLDD_SUBDOMAIN_HH
+#define EWOMS_NLDD_SUBDOMAIN_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief A subdomain of the local grid partition for the nonlinear domain
+ *        decomposition.
+ *
+ * The residual and the Jacobian rows of the degrees of freedom in "cells" are
+ * complete if all elements in "elements" are linearized. The TpfaLinearizer only uses
+ * the cells, the FvBaseLinearizer only the elements.
+ */
+template <class ElementSeed>
+struct NlddSubDomain
+{
+    unsigned index = 0;
+    std::vector<int> cells;
+    std::vector<ElementSeed> elements;
+};
+
+template <class SubDomainType>
+struct IsNlddSubDomain : public std::false_type
+{};
+
+template <class ElementSeed>
+struct IsNlddSubDomain<NlddSubDomain<ElementSeed> > : public std::true_type
+{};
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Partition the graph of a sparse matrix into subdomains of similar size.
+ *
+ * The active rows are visited in breadth-first order and the visited rows are
+ * assigned to the subdomains one after the other, so that the rows of a subdomain are
+ * usually connected. Returns the index of the subdomain of each row, or -1 if the row
+ * is not active. At most numDomains subdomains are created.
+ */
+template <class Matrix>
+std::vector<int> partitionMatrixGraph(const Matrix& matrix,
+                                      const std::vector<bool>& active,
+                                      unsigned numDomains)
+{
+    const std::size_t numRows = matrix.N();
+    assert(active.size() == numRows);
+    assert(numDomains > 0);
+
+    std::vector<int> domainOfRow(numRows, -1);
+    const std::size_t numActive = std::count(active.begin(), active.end(), true);
+    if (numActive == 0)
+        return domainOfRow;
+
+    const std::size_t targetSize = (numActive + numDomains - 1)/numDomains;
+
+    std::vector<bool> visited(numRows, false);
+    std::vector<std::size_t> queue;
+    queue.reserve(numRows);
+
+    int domainIdx = 0;
+    std::size_t domainSize = 0;
+    for (std::size_t startIdx = 0; startIdx < numRows; ++startIdx) {
+        if (!active[startIdx] || visited[startIdx])
+            continue;
+
+        queue.clear();
+        queue.push_back(startIdx);
+        visited[startIdx] = true;
+        for (std::size_t queueIdx = 0; queueIdx < queue.size(); ++queueIdx) {
+            const std::size_t rowIdx = queue[queueIdx];
+            if (domainSize == targetSize) {
+                ++domainIdx;
+                domainSize = 0;
+            }
+            domainOfRow[rowIdx] = domainIdx;
+            ++domainSize;
+
+            const auto& row = matrix[rowIdx];
+            const auto colEndIt = row.end();
+            for (auto colIt = row.begin(); colIt != colEndIt; ++colIt) {
+                const std::size_t colIdx = colIt.index();
+                if (active[colIdx] && !visited[colIdx]) {
+                    visited[colIdx] = true;
+                    queue.push_back(colIdx);
+                }
+            }
+        }
+    }
+
+    return domainOfRow;
+}
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief Color the subdomains such that the subdomains of a color can be solved
+ *        concurrently.
+ *
+ * Two subdomains get different colors if any row of the matrix is connected to both
+ * of them, i.e., if they are neighbors or have a common neighbor. The local Newton
+ * methods of such subdomains would access the same intensive quantities and rows of
+ * the linearized system. Returns the indices of the subdomains of each color.
+ */
+template <class Matrix>
+std::vector<std::vector<int>> colorSubDomains(const Matrix& matrix,
+                                              const std::vector<int>& domainOfRow,
+                                              int numDomains)
+{
+    assert(domainOfRow.size() == matrix.N());
+
+    std::vector<std::vector<int>> conflicts(numDomains);
+    std::vector<int> rowDomains;
+    for (std::size_t rowIdx = 0; rowIdx < matrix.N(); ++rowIdx) {
+        rowDomains.clear();
+        if (domainOfRow[rowIdx] >= 0)
+            rowDomains.push_back(domainOfRow[rowIdx]);
+
+        const auto& row = matrix[rowIdx];
+        const auto colEndIt = row.end();
+        for (auto colIt = row.begin(); colIt != colEndIt; ++colIt) {
+            const int domainIdx = domainOfRow[colIt.index()];
+            if (domainIdx >= 0 &&
+                std::find(rowDomains.begin(), rowDomains.end(), domainIdx) == rowDomains.end())
+                rowDomains.push_back(domainIdx);
+        }
+
+        for (std::size_t i = 0; i < rowDomains.size(); ++i) {
+            for (std::size_t j = i + 1; j < rowDomains.size(); ++j) {
+                conflicts[rowDomains[i]].push_back(rowDomains[j]);
+                conflicts[rowDomains[j]].push_back(rowDomains[i]);
+            }
+        }
+    }
+
+    // greedy coloring: each subdomain gets the first color which none of the
+    // conflicting subdomains has
+    std::vector<int> colorOfDomain(numDomains, -1);
+    std::vector<std::vector<int>> colors;
+    std::vector<bool> colorUsed;
+    for (int domainIdx = 0; domainIdx < numDomains; ++domainIdx) {
+        colorUsed.assign(colors.size(), false);
+        for (const int otherIdx : conflicts[domainIdx])
+            if (colorOfDomain[otherIdx] >= 0)
+                colorUsed[colorOfDomain[otherIdx]] = true;
+
+        const auto colorIt = std::find(colorUsed.begin(), colorUsed.end(), false);
+        const std::size_t colorIdx = colorIt - colorUsed.begin();
+        if (colorIdx == colors.size())
+            colors.emplace_back();
+
+        colorOfDomain[domainIdx] = static_cast<int>(colorIdx);
+        colors[colorIdx].push_back(domainIdx);
+    }
+
+    return colors;
+}
+
+} // namespace Opm
+
+#endif
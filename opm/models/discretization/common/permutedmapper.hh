@@ -0,0 +1,137 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::PermutedMapper
+ */
+#ifndef EWOMS_PERMUTED_MAPPER_HH
+#define EWOMS_PERMUTED_MAPPER_HH
+
+#include <dune/common/version.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup FiniteVolumeDiscretizations
+ *
+ * \brief A mapper for the entities of a grid view whose indices are permuted.
+ *
+ * The indices of the underlying Dune mapper are renumbered by a permutation which
+ * maps each of them to its new index. Without a permutation, the mapper behaves
+ * exactly like the Dune mapper. Updating the mapper after the grid has changed
+ * discards the permutation.
+ *
+ * The methods of the Dune mapper are not virtual, i.e., the permutation is only
+ * applied if the mapper is used through this class. The Dune mapper is thus a private
+ * base class, so that passing a PermutedMapper where a Dune mapper is expected does
+ * not compile instead of silently using the indices in grid order.
+ */
+template <class GridView>
+class PermutedMapper : private Dune::MultipleCodimMultipleGeomTypeMapper<GridView>
+{
+    using ParentType = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+    using Element = typename GridView::template Codim<0>::Entity;
+
+public:
+    using Index = typename ParentType::Index;
+
+    using ParentType::ParentType;
+    using ParentType::size;
+
+    /*!
+     * \brief Renumber the indices of the mapper.
+     *
+     * \param permutation The new index of each index of the Dune mapper. If it is
+     *                    empty, the indices are not permuted.
+     */
+    template <class IndexVector>
+    void setPermutation(const IndexVector& permutation)
+    {
+        assert(permutation.empty() || permutation.size() == static_cast<std::size_t>(this->size()));
+        permutation_.assign(permutation.begin(), permutation.end());
+    }
+
+    /*!
+     * \brief Returns the new index of each index of the Dune mapper.
+     *
+     * The vector is empty if the indices are not permuted.
+     */
+    const std::vector<Index>& permutation() const
+    { return permutation_; }
+
+    template <class EntityType>
+    Index index(const EntityType& entity) const
+    { return permute_(ParentType::index(entity)); }
+
+    Index subIndex(const Element& element, int subEntityIdx, unsigned int codim) const
+    { return permute_(ParentType::subIndex(element, subEntityIdx, codim)); }
+
+    template <class EntityType>
+    bool contains(const EntityType& entity, Index& result) const
+    {
+        if (!ParentType::contains(entity, result))
+            return false;
+
+        result = permute_(result);
+        return true;
+    }
+
+    bool contains(const Element& element, int subEntityIdx, int codim, Index& result) const
+    {
+        if (!ParentType::contains(element, subEntityIdx, codim, result))
+            return false;
+
+        result = permute_(result);
+        return true;
+    }
+
+#if DUNE_VERSION_NEWER(DUNE_GRID, 2, 8)
+    void update(const GridView& gridView)
+    {
+        ParentType::update(gridView);
+        permutation_.clear();
+    }
+#else
+    void update()
+    {
+        ParentType::update();
+        permutation_.clear();
+    }
+#endif
+
+private:
+    Index permute_(Index idx) const
+    { return permutation_.empty() ? idx : permutation_[idx]; }
+
+    std::vector<Index> permutation_;
+};
+
+} // namespace Opm
+
+#endif
@@ -43,11 +43,16 @@
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 #include <opm/models/discretization/common/linearizationtype.hh>
+#include <opm/models/parallel/numaplacement.hh>
+#include <opm/models/utils/allocationaudit.hh>
+
+#include <opm/simulators/linalg/linalgproperties.hh>
 
 #include <exception>   // current_exception, rethrow_exception
 #include <iostream>
 #include <numeric>
 #include <set>
+#include <stdexcept>
 #include <type_traits>
 #include <vector>
 
@@ -91,6 +96,7 @@ class TpfaLinearizer
     using Stencil = GetPropType<TypeTag, Properties::Stencil>;
     using LocalResidual = GetPropType<TypeTag, Properties::LocalResidual>;
     using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
+    using LinearSolverBackend = GetPropType<TypeTag, Properties::LinearSolverBackend>;
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
@@ -305,6 +311,18 @@ public:
         return linearizationType_;
     };
 
+    /*!
+     * \brief Keep the Jacobian matrix of the previous linearization.
+     *
+     * If enabled, the linearization only recomputes the residual and leaves the
+     * Jacobian as it is.
+     */
+    void setReuseJacobian(bool yesno)
+    { reuseJacobian_ = yesno; }
+
+    bool reuseJacobian() const
+    { return reuseJacobian_; }
+
     /*!
      * \brief Return constant reference to the flowsInfo.
      *
@@ -374,7 +392,8 @@ public:
         }
         for (int globI : domain.cells) {
             residual_[globI] = 0.0;
-            jacobian_->clearRow(globI, 0.0);
+            if (!reuseJacobian_)
+                jacobian_->clearRow(globI, 0.0);
         }
     }
 
@@ -405,11 +424,17 @@ private:
         // initialize the Jacobian matrix and the vector for the residual function
         residual_.resize(model_().numTotalDof());
         resetSystem_();
+        if (residual_.size() > 0)
+            NumaPlacement::placeArray(&residual_[0], residual_.size());
 
         // initialize the sparse tables for Flows and Flores
         createFlows_();
     }
 
+    // returns true if the linear solver needs the off-diagonal blocks of the Jacobian
+    static constexpr bool assembleOffDiagonalBlocks_()
+    { return Linear::NeedsOffDiagonalBlocks<LinearSolverBackend>::value; }
+
     // Construct the BCRS matrix for the Jacobian of the residual function
     void createMatrix_()
     {
@@ -439,7 +464,8 @@ private:
 
                 for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
                     unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
-                    sparsityPattern[myIdx].insert(neighborIdx);
+                    if (dofIdx == 0 || assembleOffDiagonalBlocks_())
+                        sparsityPattern[myIdx].insert(neighborIdx);
                     if (dofIdx > 0) {
                         const Scalar trans = problem_().transmissibility(myIdx, neighborIdx);
                         const auto scvfIdx = dofIdx - 1;
@@ -503,6 +529,9 @@ private:
         // add the additional neighbors and degrees of freedom caused by the auxiliary
         // equations
         size_t numAuxMod = model.numAuxiliaryModules();
+        if (!assembleOffDiagonalBlocks_() && numAuxMod > 0)
+            throw std::logic_error("Linear solvers which do not use the off-diagonal blocks "
+                                   "of the Jacobian do not support auxiliary equations");
         for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
             model.auxiliaryModule(auxModIdx)->addNeighbors(sparsityPattern);
 
@@ -514,11 +543,19 @@ private:
         for (unsigned globI = 0; globI < numCells; globI++) {
             const auto& nbInfos = neighborInfo_[globI];
             diagMatAddress_[globI] = jacobian_->blockAddress(globI, globI);
+            // if only the diagonal blocks are assembled, the addresses of the
+            // off-diagonal ones stay null
+            if (!assembleOffDiagonalBlocks_())
+                continue;
             for (auto& nbInfo : nbInfos) {
                 nbInfo.matBlockAddress = jacobian_->blockAddress(nbInfo.neighbor, globI);
             }
         }
 
+        // the rows are assembled by the threads of the static partition of linearize_()
+        NumaPlacement::placeMatrix(jacobian_->istlMatrix());
+        NumaPlacement::placeArray(diagMatAddress_.data(), diagMatAddress_.size());
+
         // Create dummy full domain.
         fullDomain_.cells.resize(numCells);
         std::iota(fullDomain_.cells.begin(), fullDomain_.cells.end(), 0);
@@ -529,7 +566,8 @@ private:
     {
         residual_ = 0.0;
         // zero all matrix entries
-        jacobian_->clear();
+        if (!reuseJacobian_)
+            jacobian_->clear();
     }
 
     // Initialize the flows, flores, and velocity sparse tables
@@ -728,11 +766,13 @@ private:
         const unsigned int numCells = domain.cells.size();
         const bool on_full_domain = (numCells == model_().numTotalDof());
 
+        // the static schedule matches the partition used by NumaPlacement
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
 #endif
         for (unsigned ii = 0; ii < numCells; ++ii) {
             OPM_TIMEBLOCK_LOCAL(linearizationForEachCell);
+            NoAllocationRegion noAllocationRegion("TpfaLinearizer::linearize_");
             const unsigned globI = domain.cells[ii];
             const auto& nbInfos = neighborInfo_[globI];
             VectorBlock res(0.0);
@@ -763,11 +803,15 @@ private:
                 }
                 setResAndJacobi(res, bMat, adres);
                 residual_[globI] += res;
-                //SparseAdapter syntax:  jacobian_->addToBlock(globI, globI, bMat);
-                *diagMatAddress_[globI] += bMat;
-                bMat *= -1.0;
-                //SparseAdapter syntax: jacobian_->addToBlock(globJ, globI, bMat);
-                *nbInfo.matBlockAddress += bMat;
+                if (!reuseJacobian_) {
+                    //SparseAdapter syntax:  jacobian_->addToBlock(globI, globI, bMat);
+                    *diagMatAddress_[globI] += bMat;
+                    if (assembleOffDiagonalBlocks_()) {
+                        bMat *= -1.0;
+                        //SparseAdapter syntax: jacobian_->addToBlock(globJ, globI, bMat);
+                        *nbInfo.matBlockAddress += bMat;
+                    }
+                }
                 ++loc;
             }
             }
@@ -804,7 +848,7 @@ private:
                         }
                     } else {
                         Dune::FieldVector<Scalar, numEq> tmp;
-                        IntensiveQuantities intQuantOld = model_().intensiveQuantities(globI, 1);
+                        const IntensiveQuantities& intQuantOld = model_().intensiveQuantities(globI, 1);
                         LocalResidual::computeStorage(tmp, intQuantOld);
                         model_().updateCachedStorage(globI, /*timeIdx=*/1, tmp);
                     }
@@ -813,7 +857,8 @@ private:
             } else {
                 OPM_TIMEBLOCK_LOCAL(computeStorage0);
                 Dune::FieldVector<Scalar, numEq> tmp;
-                IntensiveQuantities intQuantOld = model_().intensiveQuantities(globI, 1);
+                // bind to a reference: copying the intensive quantities is expensive
+                const IntensiveQuantities& intQuantOld = model_().intensiveQuantities(globI, 1);
                 LocalResidual::computeStorage(tmp, intQuantOld);
                 // assume volume do not change
                 res -= tmp;
@@ -822,7 +867,8 @@ private:
             bMat *= storefac;
             residual_[globI] += res;
             //SparseAdapter syntax: jacobian_->addToBlock(globI, globI, bMat);
-            *diagMatAddress_[globI] += bMat;
+            if (!reuseJacobian_)
+                *diagMatAddress_[globI] += bMat;
 
             // Cell-wise source terms.
             // This will include well sources if SeparateSparseSourceTerms is false.
@@ -838,12 +884,25 @@ private:
             setResAndJacobi(res, bMat, adres);
             residual_[globI] += res;
             //SparseAdapter syntax: jacobian_->addToBlock(globI, globI, bMat);
-            *diagMatAddress_[globI] += bMat;
+            if (!reuseJacobian_)
+                *diagMatAddress_[globI] += bMat;
         } // end of loop for cell globI.
 
         // Add sparse source terms. For now only wells.
         if (separateSparseSourceTerms_) {
-            problem_().wellModel().addReservoirSourceTerms(residual_, diagMatAddress_);
+            if (reuseJacobian_) {
+                // the contributions to the Jacobian are written to scratch blocks which
+                // are discarded
+                if (discardedDiagBlocks_.size() != diagMatAddress_.size()) {
+                    discardedDiagBlocks_.resize(diagMatAddress_.size());
+                    discardedDiagAddress_.resize(diagMatAddress_.size());
+                    for (std::size_t i = 0; i < discardedDiagBlocks_.size(); ++i)
+                        discardedDiagAddress_[i] = &discardedDiagBlocks_[i];
+                }
+                problem_().wellModel().addReservoirSourceTerms(residual_, discardedDiagAddress_);
+            }
+            else
+                problem_().wellModel().addReservoirSourceTerms(residual_, diagMatAddress_);
         }
 
         // Boundary terms. Only looping over cells with nontrivial bcs.
@@ -861,7 +920,8 @@ private:
             setResAndJacobi(res, bMat, adres);
             residual_[globI] += res;
             ////SparseAdapter syntax: jacobian_->addToBlock(globI, globI, bMat);
-            *diagMatAddress_[globI] += bMat;
+            if (!reuseJacobian_)
+                *diagMatAddress_[globI] += bMat;
         }
     }
 
@@ -896,6 +956,7 @@ private:
     GlobalEqVector residual_;
 
     LinearizationType linearizationType_;
+    bool reuseJacobian_ = false;
 
     using ResidualNBInfo = typename LocalResidual::ResidualNBInfo;
     struct NeighborInfo
@@ -906,6 +967,8 @@ private:
     };
     SparseTable<NeighborInfo> neighborInfo_;
     std::vector<MatrixBlock*> diagMatAddress_;
+    std::vector<MatrixBlock> discardedDiagBlocks_;
+    std::vector<MatrixBlock*> discardedDiagAddress_;
 
     struct FlowInfo
     {
@@ -56,7 +56,8 @@ namespace Opm {
 template <class Scalar,
           class GridView,
           bool needFaceIntegrationPos = true,
-          bool needFaceNormal = true>
+          bool needFaceNormal = true,
+          class ElementMapperType = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>>
 class EcfvStencil
 {
     enum { dimWorld = GridView::dimensionworld };
@@ -65,7 +66,7 @@ class EcfvStencil
     using Intersection = typename GridView::Intersection;
     using Element = typename GridView::template Codim<0>::Entity;
 
-    using ElementMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+    using ElementMapper = ElementMapperType;
 
     using GlobalPosition = Dune::FieldVector<CoordScalar, dimWorld>;
 
@@ -261,6 +262,20 @@ public:
         assert(int(gridView.size(/*codim=*/0)) == int(elementMapper_.size()));
     }
 
+    /*!
+     * \brief Allocate the storage for a stencil of the given size up front.
+     *
+     * The stencil does not need to be updated with a larger element afterwards, i.e.,
+     * updating it does not allocate memory.
+     */
+    void reserve(size_t numDof, size_t numInteriorFaces, size_t numBoundaryFaces)
+    {
+        elements_.reserve(numDof);
+        subControlVolumes_.reserve(numDof);
+        interiorFaces_.reserve(numInteriorFaces);
+        boundaryFaces_.reserve(numBoundaryFaces);
+    }
+
     void updateTopology(const Element& element)
     {
         auto isIt = gridView_.ibegin(element);
@@ -60,9 +60,10 @@ struct Stencil<TypeTag, TTag::VcfvDiscretization>
 private:
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using CoordScalar = typename GridView::ctype;
+    using VertexMapper = GetPropType<TypeTag, Properties::VertexMapper>;
 
 public:
-    using type = VcfvStencil<CoordScalar, GridView>;
+    using type = VcfvStencil<CoordScalar, GridView, VertexMapper>;
 };
 
 //! Mapper for the degrees of freedoms.
@@ -462,7 +462,9 @@ VcfvScvGeometries<Scalar, /*dim=*/3, ElementType::cube>::scvGeoms_[
  * are constructed by connecting the element's center with each edge
  * of the element.
  */
-template <class Scalar, class GridView>
+template <class Scalar,
+          class GridView,
+          class VertexMapperType = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>>
 class VcfvStencil
 {
     enum{dim = GridView::dimension};
@@ -722,7 +724,7 @@ private:
 
 public:
     //! exported Mapper type
-    using Mapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+    using Mapper = VertexMapperType;
 
     class ScvGeometry
     {
@@ -828,6 +830,15 @@ public:
         }
     }
 
+    /*!
+     * \brief Allocate the storage for a stencil of the given size up front.
+     *
+     * The sub-control volumes and faces of the vertex-centered stencil are stored in
+     * fixed size arrays, so there is nothing to do here.
+     */
+    void reserve(size_t, size_t, size_t)
+    { }
+
     /*!
      * \brief Update the non-geometric part of the stencil.
      *
@@ -1379,9 +1390,9 @@ private:
 };
 
 #if HAVE_DUNE_LOCALFUNCTIONS
-template<class Scalar, class GridView>
-typename VcfvStencil<Scalar, GridView>::LocalFiniteElementCache
-VcfvStencil<Scalar, GridView>::feCache_;
+template<class Scalar, class GridView, class VertexMapperType>
+typename VcfvStencil<Scalar, GridView, VertexMapperType>::LocalFiniteElementCache
+VcfvStencil<Scalar, GridView, VertexMapperType>::feCache_;
 #endif // HAVE_DUNE_LOCALFUNCTIONS
 
 } // namespace Opm
@@ -98,7 +98,7 @@ public:
         // material law parameters
         const auto& problem = elemCtx.problem();
         const typename MaterialLaw::Params& materialParams =
-            problem.materialLawParams(elemCtx, dofIdx, timeIdx);
+            problem.cachedMaterialLawParams(elemCtx, dofIdx, timeIdx);
         const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
         Opm::Valgrind::CheckDefined(priVars);
 
@@ -138,10 +138,10 @@ public:
         }
 
         // porosity
-        porosity_ = problem.porosity(elemCtx, dofIdx, timeIdx);
+        porosity_ = problem.cachedPorosity(elemCtx, dofIdx, timeIdx);
 
         // intrinsic permeability
-        intrinsicPerm_ = problem.intrinsicPermeability(elemCtx, dofIdx, timeIdx);
+        intrinsicPerm_ = problem.cachedIntrinsicPermeability(elemCtx, dofIdx, timeIdx);
 
         // energy related quantities
         EnergyIntensiveQuantities::update_(fluidState_, paramCache, elemCtx, dofIdx, timeIdx);
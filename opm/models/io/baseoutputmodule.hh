@@ -138,6 +138,17 @@ public:
     virtual bool needExtensiveQuantities() const
     { return false; }
 
+    /*!
+     * \brief Returns true iff the module writes at least one field.
+     *
+     * Inactive modules neither get their buffers allocated nor are they called for
+     * the elements of the grid when the output fields are prepared. Since this
+     * method returns 'true' by default, a module that does not override it always
+     * gets processed.
+     */
+    virtual bool isActive() const
+    { return true; }
+
 protected:
     enum BufferType {
         //! Buffer contains data associated with the degrees of freedom
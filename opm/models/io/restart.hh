@@ -27,10 +27,19 @@
 #ifndef EWOMS_RESTART_HH
 #define EWOMS_RESTART_HH
 
+#include <opm/models/utils/timer.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace Opm {
 
@@ -88,6 +97,34 @@ class Restart
     }
 
 public:
+    /*!
+     * \brief Specify whether the entities are decoded using all threads.
+     *
+     * If enabled, the lines of the restart file are read in chunks which are then
+     * decoded in parallel. This requires that the deserializer can decode different
+     * entities concurrently.
+     */
+    void setParallelDeserialization(bool yesno)
+    { parallelDeserialization_ = yesno; }
+
+    /*!
+     * \brief Returns the wall clock time [s] which was spent reading the entity data
+     *        from the restart file.
+     *
+     * This is only measured separately if the entities are deserialized in parallel.
+     * Otherwise, reading and decoding are interleaved and the time is attributed to
+     * decoding.
+     */
+    double entityReadTime() const
+    { return readTimer_.realTimeElapsed(); }
+
+    /*!
+     * \brief Returns the wall clock time [s] which was spent decoding the entity data of
+     *        the restart file.
+     */
+    double entityDecodeTime() const
+    { return decodeTimer_.realTimeElapsed(); }
+
     /*!
      * \brief Returns the name of the file which is (de-)serialized.
      */
@@ -240,20 +277,28 @@ public:
         std::string cookie = oss.str();
         deserializeSectionBegin(cookie);
 
-        std::string curLine;
-
-        // read entity data
-        using Iterator = typename GridView::template Codim<codim>::Iterator;
-        Iterator it = gridView.template begin<codim>();
-        const Iterator& endIt = gridView.template end<codim>();
-        for (; it != endIt; ++it) {
-            if (!inStream_.good()) {
-                throw std::runtime_error("Restart file is corrupted");
+        if (parallelDeserialization_)
+            deserializeEntitiesParallel_<codim>(deserializer, gridView);
+        else {
+            decodeTimer_.start();
+
+            std::string curLine;
+
+            // read entity data
+            using Iterator = typename GridView::template Codim<codim>::Iterator;
+            Iterator it = gridView.template begin<codim>();
+            const Iterator& endIt = gridView.template end<codim>();
+            for (; it != endIt; ++it) {
+                if (!inStream_.good()) {
+                    throw std::runtime_error("Restart file is corrupted");
+                }
+
+                std::getline(inStream_, curLine);
+                std::istringstream curLineStream(curLine);
+                deserializer.deserializeEntity(curLineStream, *it);
             }
 
-            std::getline(inStream_, curLine);
-            std::istringstream curLineStream(curLine);
-            deserializer.deserializeEntity(curLineStream, *it);
+            decodeTimer_.stop();
         }
 
         deserializeSectionEnd();
@@ -266,9 +311,73 @@ public:
     { inStream_.close(); }
 
 private:
+    // read the lines of the entities in chunks and decode each chunk using all threads
+    template <int codim, class Deserializer, class GridView>
+    void deserializeEntitiesParallel_(Deserializer& deserializer, const GridView& gridView)
+    {
+        static constexpr std::size_t chunkSize = 65536;
+
+        using EntitySeed = typename GridView::template Codim<codim>::Entity::EntitySeed;
+
+        // the entities are stored in the order of the grid view's iterator
+        std::vector<EntitySeed> seeds;
+        seeds.reserve(gridView.size(codim));
+        using Iterator = typename GridView::template Codim<codim>::Iterator;
+        Iterator it = gridView.template begin<codim>();
+        const Iterator& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it)
+            seeds.push_back(it->seed());
+
+        std::vector<std::string> lines(std::min(chunkSize, seeds.size()));
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed = false;
+        for (std::size_t chunkBegin = 0; chunkBegin < seeds.size(); chunkBegin += chunkSize) {
+            const int numLines = static_cast<int>(std::min(chunkSize, seeds.size() - chunkBegin));
+
+            readTimer_.start();
+            for (int lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+                if (!inStream_.good()) {
+                    throw std::runtime_error("Restart file is corrupted");
+                }
+
+                std::getline(inStream_, lines[lineIdx]);
+            }
+            readTimer_.stop();
+
+            decodeTimer_.start();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+                if (failed)
+                    continue;
+
+                try {
+                    std::istringstream lineStream(lines[lineIdx]);
+                    const auto& entity = gridView.grid().entity(seeds[chunkBegin + lineIdx]);
+                    deserializer.deserializeEntity(lineStream, entity);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+            decodeTimer_.stop();
+
+            if (exceptionPtr)
+                std::rethrow_exception(exceptionPtr);
+        }
+    }
+
     std::string fileName_;
     std::ifstream inStream_;
     std::ofstream outStream_;
+
+    bool parallelDeserialization_ = false;
+    Timer readTimer_;
+    Timer decodeTimer_;
 };
 } // namespace Opm
 
@@ -191,6 +191,20 @@ public:
             this->commitPhaseBuffer_(baseWriter, "enthalpy_%s", fluidEnthalpies_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        if (!enableEnergy)
+            return false;
+
+        return rockInternalEnergyOutput_() ||
+            totalThermalConductivityOutput_() ||
+            fluidInternalEnergiesOutput_() ||
+            fluidEnthalpiesOutput_();
+    }
+
 private:
     static bool rockInternalEnergyOutput_()
     {
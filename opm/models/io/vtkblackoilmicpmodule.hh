@@ -199,6 +199,21 @@ public:
 
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        if (!enableMICP)
+            return false;
+
+        return microbialConcentrationOutput_() ||
+            oxygenConcentrationOutput_() ||
+            ureaConcentrationOutput_() ||
+            biofilmConcentrationOutput_() ||
+            calciteConcentrationOutput_();
+    }
+
 private:
     static bool microbialConcentrationOutput_()
     {
@@ -302,6 +302,24 @@ public:
         }
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return gasDissolutionFactorOutput_() ||
+            oilVaporizationFactorOutput_() ||
+            oilFormationVolumeFactorOutput_() ||
+            gasFormationVolumeFactorOutput_() ||
+            waterFormationVolumeFactorOutput_() ||
+            oilSaturationPressureOutput_() ||
+            gasSaturationPressureOutput_() ||
+            saturatedOilGasDissolutionFactorOutput_() ||
+            saturatedGasOilVaporizationFactorOutput_() ||
+            saturationRatiosOutput_() ||
+            primaryVarsMeaningOutput_();
+    }
+
 private:
     static bool gasDissolutionFactorOutput_()
     {
@@ -219,6 +219,22 @@ public:
             this->commitScalarBuffer_(baseWriter, "water viscosity correction", waterViscosityCorrection_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        if (!enablePolymer)
+            return false;
+
+        return polymerConcentrationOutput_() ||
+            polymerDeadPoreVolumeOutput_() ||
+            polymerRockDensityOutput_() ||
+            polymerAdsorptionOutput_() ||
+            polymerViscosityCorrectionOutput_() ||
+            waterViscosityCorrectionOutput_();
+    }
+
 private:
     static bool polymerConcentrationOutput_()
     {
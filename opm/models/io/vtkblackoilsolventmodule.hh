@@ -200,6 +200,21 @@ public:
             this->commitScalarBuffer_(baseWriter, "mobility_solvent", solventMobility_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        if (!enableSolvent)
+            return false;
+
+        return solventSaturationOutput_() ||
+            solventRswOutput_() ||
+            solventDensityOutput_() ||
+            solventViscosityOutput_() ||
+            solventMobilityOutput_();
+    }
+
 private:
     static bool solventSaturationOutput_()
     {
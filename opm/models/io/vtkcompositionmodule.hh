@@ -226,6 +226,20 @@ public:
             this->commitPhaseComponentBuffer_(baseWriter, "fugacityCoeff_%s^%s", fugacityCoeff_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return massFracOutput_() ||
+            moleFracOutput_() ||
+            totalMassFracOutput_() ||
+            totalMoleFracOutput_() ||
+            molarityOutput_() ||
+            fugacityOutput_() ||
+            fugacityCoeffOutput_();
+    }
+
 private:
     static bool massFracOutput_()
     {
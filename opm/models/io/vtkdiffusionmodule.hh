@@ -165,6 +165,16 @@ public:
                                               effectiveDiffusionCoefficient_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return tortuosityOutput_() ||
+            diffusionCoefficientOutput_() ||
+            effectiveDiffusionCoefficientOutput_();
+    }
+
 private:
     static bool tortuosityOutput_()
     {
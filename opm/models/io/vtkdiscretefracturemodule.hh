@@ -287,6 +287,20 @@ public:
         }
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return saturationOutput_() ||
+            mobilityOutput_() ||
+            relativePermeabilityOutput_() ||
+            porosityOutput_() ||
+            intrinsicPermeabilityOutput_() ||
+            volumeFractionOutput_() ||
+            velocityOutput_();
+    }
+
 private:
     static bool saturationOutput_()
     {
@@ -173,6 +173,17 @@ public:
             this->commitPhaseBuffer_(baseWriter, "internalEnergy_%s", internalEnergy_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return solidInternalEnergyOutput_() ||
+            thermalConductivityOutput_() ||
+            enthalpyOutput_() ||
+            internalEnergyOutput_();
+    }
+
 private:
     static bool solidInternalEnergyOutput_()
     {
@@ -372,6 +372,25 @@ public:
         return velocityOutput_() || potentialGradientOutput_();
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return extrusionFactorOutput_() ||
+            pressureOutput_() ||
+            densityOutput_() ||
+            saturationOutput_() ||
+            mobilityOutput_() ||
+            relativePermeabilityOutput_() ||
+            viscosityOutput_() ||
+            averageMolarMassOutput_() ||
+            porosityOutput_() ||
+            intrinsicPermeabilityOutput_() ||
+            velocityOutput_() ||
+            potentialGradientOutput_();
+    }
+
 private:
     static bool extrusionFactorOutput_()
     {
@@ -32,8 +32,11 @@
 #include "vtkvectorfunction.hh"
 #include "vtktensorfunction.hh"
 
+#include <opm/models/discretization/common/permutedmapper.hh>
 #include <opm/models/io/baseoutputwriter.hh>
+#include <opm/models/io/vtunativewriter.hh>
 #include <opm/models/parallel/tasklets.hh>
+#include <opm/models/utils/timer.hh>
 
 #include <opm/material/common/Valgrind.hpp>
 
@@ -46,12 +49,19 @@
 #include <mpi.h>
 #endif
 
+#include <array>
 #include <filesystem>
+#include <future>
+#include <iomanip>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <limits>
 #include <sstream>
 #include <fstream>
+#include <utility>
+#include <vector>
 
 namespace Opm {
 /*!
@@ -60,49 +70,145 @@ namespace Opm {
  * This class automatically keeps the meta file up to date and
  * simplifies writing datasets consisting of multiple files. (i.e.
  * multiple time steps or grid refinements within a time step.)
+ *
+ * The data is either written using Dune::VTKWriter with the format specified by the
+ * vtkFormat template argument, or using VtuNativeWriter which always writes raw binary
+ * appended data that is optionally compressed. Two sets of output buffers are used
+ * alternately, so that the simulation only needs to wait for the output of a time step
+ * to be written if the output of the time step before is still outstanding, too.
  */
 template <class GridView, int vtkFormat>
 class VtkMultiWriter : public BaseOutputWriter
 {
+    using VertexMapper = PermutedMapper<GridView>;
+    using ElementMapper = PermutedMapper<GridView>;
+
+    using NativeWriter = VtuNativeWriter<GridView, ElementMapper>;
+    using DuneVtkWriter = Dune::VTKWriter<GridView>;
+
+    // everything which is required by a single output until it has been written to disk
+    struct OutputSlot
+    {
+        DuneVtkWriter* writer = nullptr;
+        std::unique_ptr<NativeWriter> nativeWriter;
+        double time = 0.0;
+        std::string outFileName;
+
+        std::list<ScalarBuffer *> managedScalarBuffers;
+        std::list<VectorBuffer *> managedVectorBuffers;
+
+        // becomes ready as soon as the data of the slot has been written
+        std::future<void> written;
+    };
+
     class WriteDataTasklet : public TaskletInterface
     {
     public:
-        WriteDataTasklet(VtkMultiWriter& multiWriter)
+        WriteDataTasklet(VtkMultiWriter& multiWriter, OutputSlot& slot)
             : multiWriter_(multiWriter)
-        { }
+            , slot_(slot)
+        { slot_.written = writtenPromise_.get_future(); }
 
         void run() final
+        {
+            try {
+                Timer writeTimer;
+                writeTimer.start();
+
+                std::size_t numBytes = 0;
+                std::string fileName;
+                if (slot_.nativeWriter)
+                    fileName = writeNative_(numBytes);
+                else
+                    fileName = writeDune_(numBytes);
+                writeTimer.stop();
+
+                // determine name to write into the multi-file for the
+                // current time step
+                // The file names in the pvd file are relative, the path should therefore be stripped.
+                const std::filesystem::path fullPath{fileName};
+                const std::string localFileName = fullPath.filename();
+                multiWriter_.addDataSet_(slot_.time, localFileName, numBytes, writeTimer.realTimeElapsed());
+            }
+            catch (...) {
+                writtenPromise_.set_exception(std::current_exception());
+                throw;
+            }
+
+            writtenPromise_.set_value();
+        }
+
+    private:
+        std::string writeDune_(std::size_t& numBytes)
         {
             std::string fileName;
             // write the actual data as vtu or vtp (plus the pieces file in the parallel case)
             if (multiWriter_.commSize_ > 1)
-                fileName = multiWriter_.curWriter_->pwrite(/*name=*/multiWriter_.curOutFileName_,
-                                                           /*path=*/multiWriter_.outputDir_,
-                                                           /*extendPath=*/"",
-                                                           static_cast<Dune::VTK::OutputType>(vtkFormat));
-            else
-                fileName = multiWriter_.curWriter_->write(/*name=*/multiWriter_.outputDir_ + "/" + multiWriter_.curOutFileName_,
-                                                          static_cast<Dune::VTK::OutputType>(vtkFormat));
-
-            // determine name to write into the multi-file for the
-            // current time step
-            // The file names in the pvd file are relative, the path should therefore be stripped.
-            const std::filesystem::path fullPath{fileName};
-            const std::string localFileName = fullPath.filename();
-            multiWriter_.multiFile_.precision(16);
-            multiWriter_.multiFile_ << "   <DataSet timestep=\"" << multiWriter_.curTime_ << "\" file=\""
-                                    << localFileName << "\"/>\n";
+                fileName = slot_.writer->pwrite(/*name=*/slot_.outFileName,
+                                                /*path=*/multiWriter_.outputDir_,
+                                                /*extendPath=*/"",
+                                                static_cast<Dune::VTK::OutputType>(vtkFormat));
+            else {
+                fileName = slot_.writer->write(/*name=*/multiWriter_.outputDir_ + "/" + slot_.outFileName,
+                                               static_cast<Dune::VTK::OutputType>(vtkFormat));
+
+                // the size of the pieces written by the parallel Dune writer is not
+                // known, so only the sequential case is accounted for
+                numBytes = std::filesystem::file_size(fileName);
+            }
+
+            return fileName;
+        }
+
+        std::string writeNative_(std::size_t& numBytes)
+        {
+            const auto& outputDir = multiWriter_.outputDir_;
+            int commSize = multiWriter_.commSize_;
+            int commRank = multiWriter_.commRank_;
+
+            std::string fileName;
+            if (commSize > 1) {
+                // use the same naming scheme for the pieces as Dune::VTKWriter
+                std::vector<std::string> pieceFileNames;
+                for (int rank = 0; rank < commSize; ++rank)
+                    pieceFileNames.push_back(pieceFileName_(rank));
+
+                numBytes += slot_.nativeWriter->write(outputDir + "/" + pieceFileNames[commRank]);
+
+                std::ostringstream oss;
+                oss << "s" << std::setw(4) << std::setfill('0') << commSize << "-"
+                    << slot_.outFileName << ".pvtu";
+                fileName = outputDir + "/" + oss.str();
+                if (commRank == 0)
+                    numBytes += slot_.nativeWriter->writeParallelHeader(fileName, pieceFileNames);
+            }
+            else {
+                fileName = outputDir + "/" + slot_.outFileName + ".vtu";
+                numBytes += slot_.nativeWriter->write(fileName);
+            }
+
+            // the data is not needed anymore
+            slot_.nativeWriter.reset();
+
+            return fileName;
+        }
+
+        std::string pieceFileName_(int rank) const
+        {
+            std::ostringstream oss;
+            oss << "s" << std::setw(4) << std::setfill('0') << multiWriter_.commSize_
+                << "-p" << std::setw(4) << std::setfill('0') << rank
+                << "-" << slot_.outFileName << ".vtu";
+            return oss.str();
         }
 
-    private:
         VtkMultiWriter& multiWriter_;
+        OutputSlot& slot_;
+        std::promise<void> writtenPromise_;
     };
 
     enum { dim = GridView::dimension };
 
-    using VertexMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
-    using ElementMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
-
 public:
     using Scalar = BaseOutputWriter::Scalar;
     using Vector = BaseOutputWriter::Vector;
@@ -114,16 +220,37 @@ public:
     using VtkWriter = Dune::VTKWriter<GridView>;
     using FunctionPtr = std::shared_ptr< Dune::VTKFunction< GridView > >;
 
+    /*!
+     * \brief The constructor.
+     *
+     * \param asyncWriting Write the data to disk using a separate thread
+     * \param gridView The grid view for which the data is written
+     * \param outputDir The directory to which the files are written
+     * \param simName The prefix of the names of the files
+     * \param multiFileName The name of the .pvd file. If empty, it is derived from simName
+     * \param nativeOutput Use VtuNativeWriter instead of Dune::VTKWriter
+     * \param compressOutput Compress the data written by VtuNativeWriter
+     * \param numCompressionThreads The number of threads used to compress the data
+     */
     VtkMultiWriter(bool asyncWriting,
                    const GridView& gridView,
                    const std::string& outputDir,
                    const std::string& simName = "",
-                   std::string multiFileName = "")
+                   std::string multiFileName = "",
+                   bool nativeOutput = false,
+                   bool compressOutput = false,
+                   int numCompressionThreads = 1)
         : gridView_(gridView)
         , elementMapper_(gridView, Dune::mcmgElementLayout())
         , vertexMapper_(gridView, Dune::mcmgVertexLayout())
-        , curWriter_(nullptr)
+        , nativeOutput_(nativeOutput)
+        , compressOutput_(compressOutput)
+        , numCompressionThreads_(numCompressionThreads)
+        , curSlotIdx_(0)
         , curWriterNum_(0)
+        , numBytesWritten_(0)
+        , writeTime_(0.0)
+        , waitTime_(0.0)
         , taskletRunner_(/*numThreads=*/asyncWriting?1:0)
     {
         outputDir_ = outputDir;
@@ -142,7 +269,8 @@ public:
     ~VtkMultiWriter()
     {
         taskletRunner_.barrier();
-        releaseBuffers_();
+        for (auto& slot : slots_)
+            releaseBuffers_(slot);
         finishMultiFile_();
 
         if (commRank_ == 0)
@@ -173,6 +301,21 @@ public:
 #endif
     }
 
+    /*!
+     * \brief Number the elements and vertices like the model.
+     *
+     * The attached data is indexed by the indices of the degrees of freedom of the
+     * model, so if the model permutes them, the writer must use the same permutations.
+     * They are discarded by gridChanged().
+     */
+    template <class IndexVector>
+    void setPermutations(const IndexVector& elementPermutation,
+                         const IndexVector& vertexPermutation)
+    {
+        elementMapper_.setPermutation(elementPermutation);
+        vertexMapper_.setPermutation(vertexPermutation);
+    }
+
     /*!
      * \brief Called whenever a new time step must be written.
      */
@@ -182,15 +325,25 @@ public:
             startMultiFile_(multiFileName_);
         }
 
-        // make sure that all previous output has been written and no other thread
-        // accesses the memory used as the target for the extracted quantities
-        taskletRunner_.barrier();
-        releaseBuffers_();
-
-        curTime_ = t;
-        curOutFileName_ = fileName_();
-
-        curWriter_ = new VtkWriter(gridView_, Dune::VTK::conforming);
+        // switch to the other output slot. the output of the previous time step may
+        // still be in progress, but we need to make sure that no other thread accesses
+        // the memory of the slot which we are about to reuse.
+        curSlotIdx_ = 1 - curSlotIdx_;
+        auto& slot = slots_[curSlotIdx_];
+        waitUntilWritten_(slot);
+        releaseBuffers_(slot);
+
+        slot.time = t;
+        slot.outFileName = fileName_();
+
+        if (nativeOutput_)
+            slot.nativeWriter = std::make_unique<NativeWriter>(gridView_,
+                                                               elementMapper_,
+                                                               vertexMapper_,
+                                                               compressOutput_,
+                                                               numCompressionThreads_);
+        else
+            slot.writer = new VtkWriter(gridView_, Dune::VTK::conforming);
         ++curWriterNum_;
     }
 
@@ -203,7 +356,7 @@ public:
     ScalarBuffer *allocateManagedScalarBuffer(size_t numEntities)
     {
         ScalarBuffer *buf = new ScalarBuffer(numEntities);
-        managedScalarBuffers_.push_back(buf);
+        slots_[curSlotIdx_].managedScalarBuffers.push_back(buf);
         return buf;
     }
 
@@ -219,7 +372,7 @@ public:
         for (size_t i = 0; i < numOuter; ++ i)
             (*buf)[i].resize(numInner);
 
-        managedVectorBuffers_.push_back(buf);
+        slots_[curSlotIdx_].managedVectorBuffers.push_back(buf);
         return buf;
     }
 
@@ -243,13 +396,19 @@ public:
     {
         sanitizeScalarBuffer_(buf);
 
+        auto& slot = slots_[curSlotIdx_];
+        if (slot.nativeWriter) {
+            slot.nativeWriter->addPointData(name, buf);
+            return;
+        }
+
         using VtkFn = VtkScalarFunction<GridView, VertexMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
                                     vertexMapper_,
                                     buf,
                                     /*codim=*/dim));
-        curWriter_->addVertexData(fnPtr);
+        slot.writer->addVertexData(fnPtr);
     }
 
     /*!
@@ -271,13 +430,19 @@ public:
     {
         sanitizeScalarBuffer_(buf);
 
+        auto& slot = slots_[curSlotIdx_];
+        if (slot.nativeWriter) {
+            slot.nativeWriter->addCellData(name, buf);
+            return;
+        }
+
         using VtkFn = VtkScalarFunction<GridView, ElementMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
                                     elementMapper_,
                                     buf,
                                     /*codim=*/0));
-        curWriter_->addCellData(fnPtr);
+        slot.writer->addCellData(fnPtr);
     }
 
     /*!
@@ -300,13 +465,19 @@ public:
     {
         sanitizeVectorBuffer_(buf);
 
+        auto& slot = slots_[curSlotIdx_];
+        if (slot.nativeWriter) {
+            slot.nativeWriter->addPointData(name, buf);
+            return;
+        }
+
         using VtkFn = VtkVectorFunction<GridView, VertexMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
                                     vertexMapper_,
                                     buf,
                                     /*codim=*/dim));
-        curWriter_->addVertexData(fnPtr);
+        slot.writer->addVertexData(fnPtr);
     }
 
     /*!
@@ -316,17 +487,23 @@ public:
     {
         using VtkFn = VtkTensorFunction<GridView, VertexMapper>;
 
+        auto& slot = slots_[curSlotIdx_];
         for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
             std::ostringstream oss;
             oss << name <<  "[" << colIdx << "]";
 
+            if (slot.nativeWriter) {
+                slot.nativeWriter->addPointData(oss.str(), buf, colIdx);
+                continue;
+            }
+
             FunctionPtr fnPtr(new VtkFn(oss.str(),
                                         gridView_,
                                         vertexMapper_,
                                         buf,
                                         /*codim=*/dim,
                                         colIdx));
-            curWriter_->addVertexData(fnPtr);
+            slot.writer->addVertexData(fnPtr);
         }
     }
 
@@ -349,13 +526,19 @@ public:
     {
         sanitizeVectorBuffer_(buf);
 
+        auto& slot = slots_[curSlotIdx_];
+        if (slot.nativeWriter) {
+            slot.nativeWriter->addCellData(name, buf);
+            return;
+        }
+
         using VtkFn = VtkVectorFunction<GridView, ElementMapper>;
         FunctionPtr fnPtr(new VtkFn(name,
                                     gridView_,
                                     elementMapper_,
                                     buf,
                                     /*codim=*/0));
-        curWriter_->addCellData(fnPtr);
+        slot.writer->addCellData(fnPtr);
     }
 
     /*!
@@ -365,17 +548,23 @@ public:
     {
         using VtkFn = VtkTensorFunction<GridView, ElementMapper>;
 
+        auto& slot = slots_[curSlotIdx_];
         for (unsigned colIdx = 0; colIdx < buf[0].N(); ++colIdx) {
             std::ostringstream oss;
             oss << name <<  "[" << colIdx << "]";
 
+            if (slot.nativeWriter) {
+                slot.nativeWriter->addCellData(oss.str(), buf, colIdx);
+                continue;
+            }
+
             FunctionPtr fnPtr(new VtkFn(oss.str(),
                                         gridView_,
                                         elementMapper_,
                                         buf,
                                         /*codim=*/0,
                                         colIdx));
-            curWriter_->addCellData(fnPtr);
+            slot.writer->addCellData(fnPtr);
         }
     }
 
@@ -388,8 +577,14 @@ public:
      */
     void endWrite(bool onlyDiscard = false)
     {
+        auto& slot = slots_[curSlotIdx_];
         if (!onlyDiscard) {
-            auto tasklet = std::make_shared<WriteDataTasklet>(*this);
+            // the native writer has copied all data when the fields were attached, so
+            // the managed buffers are not needed anymore
+            if (slot.nativeWriter)
+                releaseManagedBuffers_(slot);
+
+            auto tasklet = std::make_shared<WriteDataTasklet>(*this, slot);
             taskletRunner_.dispatch(tasklet);
         }
         else
@@ -401,6 +596,45 @@ public:
         finishMultiFile_();
     }
 
+    /*!
+     * \brief Wait until all outstanding output has been written to disk.
+     */
+    void waitForPendingOutput()
+    {
+        taskletRunner_.barrier();
+        for (auto& slot : slots_)
+            waitUntilWritten_(slot);
+    }
+
+    /*!
+     * \brief Returns the number of bytes written to disk by the current process.
+     *
+     * If Dune::VTKWriter is used for a parallel run, the size of the files is not
+     * known, so they are not considered.
+     */
+    std::size_t numBytesWritten() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return numBytesWritten_;
+    }
+
+    /*!
+     * \brief Returns the wall clock time [s] which was required to write the data to
+     *        disk.
+     */
+    double writeTime() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writeTime_;
+    }
+
+    /*!
+     * \brief Returns the wall clock time [s] for which the simulation was blocked
+     *        because the output of previous time steps was still outstanding.
+     */
+    double waitTime() const
+    { return waitTime_; }
+
     /*!
      * \brief Write the multi-writer's state to a restart file.
      */
@@ -503,6 +737,12 @@ private:
     }
 
     void finishMultiFile_()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishMultiFileUnlocked_();
+    }
+
+    void finishMultiFileUnlocked_()
     {
         // only the first process writes to the multi-file
         if (commRank_ == 0) {
@@ -515,6 +755,36 @@ private:
         }
     }
 
+    // called by the writer thread after the data of a time step has been written
+    void addDataSet_(double time, const std::string& fileName, std::size_t numBytes, double writeTime)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        numBytesWritten_ += numBytes;
+        writeTime_ += writeTime;
+
+        if (commRank_ == 0) {
+            multiFile_.precision(16);
+            multiFile_ << "   <DataSet timestep=\"" << time << "\" file=\""
+                       << fileName << "\"/>\n";
+            finishMultiFileUnlocked_();
+        }
+    }
+
+    // wait until the data of an output slot has been written to disk. if writing the
+    // data failed, the exception of the writer thread is re-thrown.
+    void waitUntilWritten_(OutputSlot& slot)
+    {
+        if (!slot.written.valid())
+            return;
+
+        Timer waitTimer;
+        waitTimer.start();
+        std::future<void> written = std::move(slot.written);
+        written.wait();
+        waitTime_ += waitTimer.stop();
+        written.get();
+    }
+
     // make sure the field is well defined if running under valgrind
     // and make sure that all values can be displayed by paraview
     void sanitizeScalarBuffer_(ScalarBuffer&)
@@ -527,19 +797,25 @@ private:
         // nothing to do: this is done by VtkVectorFunction
     }
 
-    // release the memory occupied by all buffer objects managed by the multi-writer
-    void releaseBuffers_()
+    // release the memory occupied by all buffer objects of an output slot
+    void releaseBuffers_(OutputSlot& slot)
     {
-        // discard managed objects and the current VTK writer
-        delete curWriter_;
-        curWriter_ = nullptr;
-        while (managedScalarBuffers_.begin() != managedScalarBuffers_.end()) {
-            delete managedScalarBuffers_.front();
-            managedScalarBuffers_.pop_front();
+        // discard managed objects and the VTK writers
+        delete slot.writer;
+        slot.writer = nullptr;
+        slot.nativeWriter.reset();
+        releaseManagedBuffers_(slot);
+    }
+
+    void releaseManagedBuffers_(OutputSlot& slot)
+    {
+        while (slot.managedScalarBuffers.begin() != slot.managedScalarBuffers.end()) {
+            delete slot.managedScalarBuffers.front();
+            slot.managedScalarBuffers.pop_front();
         }
-        while (managedVectorBuffers_.begin() != managedVectorBuffers_.end()) {
-            delete managedVectorBuffers_.front();
-            managedVectorBuffers_.pop_front();
+        while (slot.managedVectorBuffers.begin() != slot.managedVectorBuffers.end()) {
+            delete slot.managedVectorBuffers.front();
+            slot.managedVectorBuffers.pop_front();
         }
     }
 
@@ -555,13 +831,20 @@ private:
     int commSize_; // number of processes in the communicator
     int commRank_; // rank of the current process in the communicator
 
-    VtkWriter *curWriter_;
-    double curTime_;
-    std::string curOutFileName_;
+    bool nativeOutput_;
+    bool compressOutput_;
+    int numCompressionThreads_;
+
+    // the output buffers are used alternately (double buffering)
+    std::array<OutputSlot, 2> slots_;
+    unsigned curSlotIdx_;
     int curWriterNum_;
 
-    std::list<ScalarBuffer *> managedScalarBuffers_;
-    std::list<VectorBuffer *> managedVectorBuffers_;
+    // protects the multi-file and the statistics which are modified by the writer thread
+    mutable std::mutex mutex_;
+    std::size_t numBytesWritten_;
+    double writeTime_;
+    double waitTime_;
 
     TaskletRunner taskletRunner_;
 };
@@ -121,6 +121,14 @@ public:
             this->commitScalarBuffer_(baseWriter, "phase presence", phasePresence_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return phasePresenceOutput_();
+    }
+
 private:
     static bool phasePresenceOutput_()
     {
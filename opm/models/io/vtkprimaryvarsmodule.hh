@@ -150,6 +150,16 @@ public:
             this->commitScalarBuffer_(baseWriter, "DOF index", dofIndex_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return primaryVarsOutput_() ||
+            processRankOutput_() ||
+            dofIndexOutput_();
+    }
+
 private:
     static bool primaryVarsOutput_()
     {
@@ -147,6 +147,15 @@ public:
             this->commitScalarBuffer_(baseWriter, "L", L_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return LOutput_() ||
+            equilConstOutput_();
+    }
+
 private:
     static bool LOutput_()
     {
@@ -127,6 +127,14 @@ public:
             this->commitScalarBuffer_(baseWriter, "temperature", temperature_);
     }
 
+    /*!
+     * \brief Returns true iff at least one of the fields of the module is written.
+     */
+    bool isActive() const override
+    {
+        return temperatureOutput_();
+    }
+
 private:
     static bool temperatureOutput_()
     {
@@ -0,0 +1,505 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::VtuNativeWriter
+ */
+#ifndef EWOMS_VTU_NATIVE_WRITER_HH
+#define EWOMS_VTU_NATIVE_WRITER_HH
+
+#include <opm/models/io/baseoutputwriter.hh>
+
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Writes VTK unstructured grid files using raw binary appended data.
+ *
+ * In contrast to Dune::VTKWriter, all data is extracted from the grid and the output
+ * buffers when the object is constructed or a field is attached. This means that
+ * neither the grid nor any of the buffers need to be kept alive until the data is
+ * written to disk, which can thus happen asynchronously.
+ *
+ * If the writer is compiled with zlib support, the data arrays can optionally be
+ * compressed using the block format of vtkZLibDataCompressor. If OpenMP is available,
+ * the blocks are compressed by the given number of threads. Since the writer is usually
+ * run by the asynchronous output thread, this defaults to a single thread, so that the
+ * compression does not compete with the threads of the simulation.
+ */
+template <class GridView, class Mapper>
+class VtuNativeWriter
+{
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using HeaderType = std::uint64_t;
+
+    // size of the uncompressed blocks of the zlib compressor [bytes]
+    static constexpr std::size_t compressionBlockSize = 1 << 15;
+
+    struct DataArray
+    {
+        std::string name;
+        std::string type;
+        unsigned numComponents;
+        std::vector<unsigned char> data;
+
+        // the compressed representation of the data including its header. this is
+        // empty if the data is not compressed.
+        std::vector<unsigned char> encoded;
+    };
+
+public:
+    using ScalarBuffer = BaseOutputWriter::ScalarBuffer;
+    using VectorBuffer = BaseOutputWriter::VectorBuffer;
+    using TensorBuffer = BaseOutputWriter::TensorBuffer;
+
+    VtuNativeWriter(const GridView& gridView,
+                    const Mapper& elementMapper,
+                    const Mapper& vertexMapper,
+                    bool compress,
+                    int numCompressionThreads = 1)
+        : numPoints_(static_cast<std::size_t>(vertexMapper.size()))
+        , enableCompression_(compress)
+        , numCompressionThreads_(std::max(numCompressionThreads, 1))
+    {
+#if !HAVE_ZLIB
+        enableCompression_ = false;
+#endif
+
+        // the coordinates of the vertices. VTK always wants three dimensional points.
+        std::vector<double> coords(3*numPoints_, 0.0);
+        for (const auto& vertex : vertices(gridView)) {
+            const auto& pos = vertex.geometry().center();
+            std::size_t vertexIdx = static_cast<std::size_t>(vertexMapper.index(vertex));
+            for (unsigned k = 0; k < dimWorld && k < 3; ++k)
+                coords[3*vertexIdx + k] = pos[k];
+        }
+        points_ = makeArray_("Points", "Float64", /*numComponents=*/3, coords);
+
+        // the topology of the interior elements
+        std::vector<std::int64_t> connectivity;
+        std::vector<std::int64_t> offsets;
+        std::vector<std::uint8_t> types;
+        for (const auto& elem : elements(gridView)) {
+            if (elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            interiorElements_.push_back(static_cast<std::size_t>(elementMapper.index(elem)));
+
+            const auto& geomType = elem.type();
+            int numCorners = static_cast<int>(elem.subEntities(dim));
+            for (int vtkIdx = 0; vtkIdx < numCorners; ++vtkIdx) {
+                int duneIdx = Dune::VTK::renumber(geomType, vtkIdx);
+                connectivity.push_back(static_cast<std::int64_t>(vertexMapper.subIndex(elem, duneIdx, dim)));
+            }
+            offsets.push_back(static_cast<std::int64_t>(connectivity.size()));
+            types.push_back(static_cast<std::uint8_t>(Dune::VTK::geometryType(geomType)));
+        }
+
+        connectivity_ = makeArray_("connectivity", "Int64", 1, connectivity);
+        offsets_ = makeArray_("offsets", "Int64", 1, offsets);
+        types_ = makeArray_("types", "UInt8", 1, types);
+    }
+
+    /*!
+     * \brief Add a scalar field which is attached to the vertices of the grid.
+     */
+    void addPointData(const std::string& name, const ScalarBuffer& buf)
+    {
+        pointData_.push_back(makeArray_(name, "Float32", 1,
+                                        toFloat_(buf, numPoints_, nullptr)));
+    }
+
+    /*!
+     * \brief Add a scalar field which is attached to the elements of the grid.
+     */
+    void addCellData(const std::string& name, const ScalarBuffer& buf)
+    {
+        cellData_.push_back(makeArray_(name, "Float32", 1,
+                                       toFloat_(buf, interiorElements_.size(), &interiorElements_)));
+    }
+
+    /*!
+     * \brief Add a vector field which is attached to the vertices of the grid.
+     */
+    void addPointData(const std::string& name, const VectorBuffer& buf)
+    { pointData_.push_back(vectorArray_(name, buf, numPoints_, nullptr)); }
+
+    /*!
+     * \brief Add a vector field which is attached to the elements of the grid.
+     */
+    void addCellData(const std::string& name, const VectorBuffer& buf)
+    { cellData_.push_back(vectorArray_(name, buf, interiorElements_.size(), &interiorElements_)); }
+
+    /*!
+     * \brief Add a column of a tensor field which is attached to the vertices of the
+     *        grid.
+     */
+    void addPointData(const std::string& name, const TensorBuffer& buf, unsigned colIdx)
+    { pointData_.push_back(tensorColumnArray_(name, buf, colIdx, numPoints_, nullptr)); }
+
+    /*!
+     * \brief Add a column of a tensor field which is attached to the elements of the
+     *        grid.
+     */
+    void addCellData(const std::string& name, const TensorBuffer& buf, unsigned colIdx)
+    {
+        cellData_.push_back(tensorColumnArray_(name, buf, colIdx,
+                                               interiorElements_.size(), &interiorElements_));
+    }
+
+    /*!
+     * \brief Write the data to a .vtu file.
+     *
+     * \return The number of bytes which have been written.
+     */
+    std::size_t write(const std::string& fileName)
+    {
+        std::vector<DataArray*> arrays;
+        for (auto& array : pointData_)
+            arrays.push_back(&array);
+        for (auto& array : cellData_)
+            arrays.push_back(&array);
+        arrays.push_back(&points_);
+        arrays.push_back(&connectivity_);
+        arrays.push_back(&offsets_);
+        arrays.push_back(&types_);
+
+        if (enableCompression_)
+            compressArrays_(arrays);
+
+        std::ostringstream header;
+        std::size_t offset = 0;
+        header << "<?xml version=\"1.0\"?>\n"
+               << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+               << byteOrder_() << "\" header_type=\"UInt64\"";
+        if (enableCompression_)
+            header << " compressor=\"vtkZLibDataCompressor\"";
+        header << ">\n"
+               << " <UnstructuredGrid>\n"
+               << "  <Piece NumberOfPoints=\"" << numPoints_
+               << "\" NumberOfCells=\"" << interiorElements_.size() << "\">\n";
+
+        header << "   <PointData>\n";
+        for (const auto& array : pointData_)
+            writeArrayHeader_(header, array, offset);
+        header << "   </PointData>\n";
+
+        header << "   <CellData>\n";
+        for (const auto& array : cellData_)
+            writeArrayHeader_(header, array, offset);
+        header << "   </CellData>\n";
+
+        header << "   <Points>\n";
+        writeArrayHeader_(header, points_, offset);
+        header << "   </Points>\n";
+
+        header << "   <Cells>\n";
+        writeArrayHeader_(header, connectivity_, offset);
+        writeArrayHeader_(header, offsets_, offset);
+        writeArrayHeader_(header, types_, offset);
+        header << "   </Cells>\n";
+
+        header << "  </Piece>\n"
+               << " </UnstructuredGrid>\n"
+               << " <AppendedData encoding=\"raw\">\n"
+               << "_";
+
+        std::ofstream outFile(fileName, std::ios::binary);
+        const std::string& headerString = header.str();
+        outFile.write(headerString.data(), static_cast<std::streamsize>(headerString.size()));
+        for (const auto* array : arrays) {
+            if (enableCompression_) {
+                outFile.write(reinterpret_cast<const char*>(array->encoded.data()),
+                              static_cast<std::streamsize>(array->encoded.size()));
+            }
+            else {
+                HeaderType numBytes = array->data.size();
+                outFile.write(reinterpret_cast<const char*>(&numBytes), sizeof(numBytes));
+                outFile.write(reinterpret_cast<const char*>(array->data.data()),
+                              static_cast<std::streamsize>(array->data.size()));
+            }
+        }
+        outFile << "\n </AppendedData>\n"
+                << "</VTKFile>\n";
+
+        std::size_t numBytesWritten = static_cast<std::size_t>(outFile.tellp());
+        outFile.close();
+        if (!outFile)
+            throw std::runtime_error("Could not write the VTK file '" + fileName + "'");
+
+        return numBytesWritten;
+    }
+
+    /*!
+     * \brief Write the .pvtu file which references the pieces of all processes.
+     *
+     * This assumes that all processes have attached the same fields.
+     *
+     * \return The number of bytes which have been written.
+     */
+    std::size_t writeParallelHeader(const std::string& fileName,
+                                    const std::vector<std::string>& pieceFileNames) const
+    {
+        std::ofstream outFile(fileName);
+        outFile << "<?xml version=\"1.0\"?>\n"
+                << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\""
+                << byteOrder_() << "\" header_type=\"UInt64\">\n"
+                << " <PUnstructuredGrid GhostLevel=\"0\">\n";
+
+        outFile << "  <PPointData>\n";
+        for (const auto& array : pointData_)
+            writeParallelArrayHeader_(outFile, array);
+        outFile << "  </PPointData>\n";
+
+        outFile << "  <PCellData>\n";
+        for (const auto& array : cellData_)
+            writeParallelArrayHeader_(outFile, array);
+        outFile << "  </PCellData>\n";
+
+        outFile << "  <PPoints>\n";
+        writeParallelArrayHeader_(outFile, points_);
+        outFile << "  </PPoints>\n";
+
+        for (const auto& pieceFileName : pieceFileNames)
+            outFile << "  <Piece Source=\"" << pieceFileName << "\"/>\n";
+
+        outFile << " </PUnstructuredGrid>\n"
+                << "</VTKFile>\n";
+
+        std::size_t numBytesWritten = static_cast<std::size_t>(outFile.tellp());
+        outFile.close();
+        if (!outFile)
+            throw std::runtime_error("Could not write the VTK file '" + fileName + "'");
+
+        return numBytesWritten;
+    }
+
+private:
+    template <class T>
+    static DataArray makeArray_(const std::string& name,
+                                const std::string& type,
+                                unsigned numComponents,
+                                const std::vector<T>& values)
+    {
+        DataArray array;
+        array.name = name;
+        array.type = type;
+        array.numComponents = numComponents;
+        array.data.resize(values.size()*sizeof(T));
+        if (!values.empty())
+            std::memcpy(array.data.data(), values.data(), array.data.size());
+        return array;
+    }
+
+    // convert a scalar buffer to single precision. if an index list is given, only the
+    // entries which are referenced by it are considered.
+    static std::vector<float> toFloat_(const ScalarBuffer& buf,
+                                       std::size_t numEntries,
+                                       const std::vector<std::size_t>* indices)
+    {
+        std::vector<float> result(numEntries);
+        for (std::size_t i = 0; i < numEntries; ++i)
+            result[i] = static_cast<float>(buf[indices ? (*indices)[i] : i]);
+        return result;
+    }
+
+    // ParaView only considers vectors with three components as such, so vectors with
+    // two components are padded
+    static unsigned vtkNumComponents_(unsigned numComponents)
+    { return (numComponents == 2) ? 3 : numComponents; }
+
+    DataArray vectorArray_(const std::string& name,
+                           const VectorBuffer& buf,
+                           std::size_t numEntries,
+                           const std::vector<std::size_t>* indices) const
+    {
+        unsigned numComponents = buf.empty() ? 1 : static_cast<unsigned>(buf[0].size());
+        unsigned numVtkComponents = vtkNumComponents_(numComponents);
+
+        std::vector<float> values(numEntries*numVtkComponents, 0.0f);
+        for (std::size_t i = 0; i < numEntries; ++i) {
+            const auto& v = buf[indices ? (*indices)[i] : i];
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                values[i*numVtkComponents + compIdx] = static_cast<float>(v[compIdx]);
+        }
+
+        return makeArray_(name, "Float32", numVtkComponents, values);
+    }
+
+    DataArray tensorColumnArray_(const std::string& name,
+                                 const TensorBuffer& buf,
+                                 unsigned colIdx,
+                                 std::size_t numEntries,
+                                 const std::vector<std::size_t>* indices) const
+    {
+        unsigned numComponents = buf.empty() ? 1 : static_cast<unsigned>(buf[0].M());
+        unsigned numVtkComponents = vtkNumComponents_(numComponents);
+
+        std::vector<float> values(numEntries*numVtkComponents, 0.0f);
+        for (std::size_t i = 0; i < numEntries; ++i) {
+            const auto& t = buf[indices ? (*indices)[i] : i];
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                values[i*numVtkComponents + compIdx] = static_cast<float>(t[compIdx][colIdx]);
+        }
+
+        return makeArray_(name, "Float32", numVtkComponents, values);
+    }
+
+    void writeArrayHeader_(std::ostream& os, const DataArray& array, std::size_t& offset) const
+    {
+        os << "    <DataArray type=\"" << array.type << "\" Name=\"" << array.name
+           << "\" NumberOfComponents=\"" << array.numComponents
+           << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+
+        if (enableCompression_)
+            offset += array.encoded.size();
+        else
+            offset += sizeof(HeaderType) + array.data.size();
+    }
+
+    static void writeParallelArrayHeader_(std::ostream& os, const DataArray& array)
+    {
+        os << "   <PDataArray type=\"" << array.type << "\" Name=\"" << array.name
+           << "\" NumberOfComponents=\"" << array.numComponents << "\"/>\n";
+    }
+
+    // compress all blocks of all arrays. the blocks are independent of each other, so
+    // this is done in parallel by the requested number of threads.
+    void compressArrays_(const std::vector<DataArray*>& arrays)
+    {
+#if HAVE_ZLIB
+        struct Block
+        {
+            const DataArray* array;
+            std::size_t begin;
+            std::size_t size;
+            std::vector<unsigned char> compressed;
+        };
+
+        std::vector<Block> blocks;
+        std::vector<std::size_t> firstBlock(arrays.size() + 1, 0);
+        for (std::size_t arrayIdx = 0; arrayIdx < arrays.size(); ++arrayIdx) {
+            const auto* array = arrays[arrayIdx];
+            firstBlock[arrayIdx] = blocks.size();
+            for (std::size_t begin = 0; begin < array->data.size(); begin += compressionBlockSize)
+                blocks.push_back(Block{array, begin,
+                                       std::min(compressionBlockSize, array->data.size() - begin),
+                                       {}});
+        }
+        firstBlock[arrays.size()] = blocks.size();
+
+        int failed = 0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(numCompressionThreads_) schedule(dynamic) reduction(+:failed)
+#endif
+        for (long blockIdx = 0; blockIdx < static_cast<long>(blocks.size()); ++blockIdx) {
+            auto& block = blocks[static_cast<std::size_t>(blockIdx)];
+            uLongf compressedSize = compressBound(static_cast<uLong>(block.size));
+            block.compressed.resize(compressedSize);
+            int ret = compress2(block.compressed.data(),
+                                &compressedSize,
+                                block.array->data.data() + block.begin,
+                                static_cast<uLong>(block.size),
+                                Z_BEST_SPEED);
+            if (ret != Z_OK)
+                ++failed;
+            block.compressed.resize(compressedSize);
+        }
+
+        if (failed > 0)
+            throw std::runtime_error("Compressing the VTK output data failed");
+
+        // assemble the header and the compressed blocks of each array
+        for (std::size_t arrayIdx = 0; arrayIdx < arrays.size(); ++arrayIdx) {
+            auto* array = arrays[arrayIdx];
+            std::size_t numBlocks = firstBlock[arrayIdx + 1] - firstBlock[arrayIdx];
+
+            std::vector<HeaderType> header(3 + numBlocks);
+            header[0] = numBlocks;
+            header[1] = compressionBlockSize;
+            header[2] = array->data.size() % compressionBlockSize;
+            std::size_t totalSize = header.size()*sizeof(HeaderType);
+            for (std::size_t i = 0; i < numBlocks; ++i) {
+                header[3 + i] = blocks[firstBlock[arrayIdx] + i].compressed.size();
+                totalSize += header[3 + i];
+            }
+
+            array->encoded.resize(totalSize);
+            unsigned char* out = array->encoded.data();
+            std::memcpy(out, header.data(), header.size()*sizeof(HeaderType));
+            out += header.size()*sizeof(HeaderType);
+            for (std::size_t i = 0; i < numBlocks; ++i) {
+                const auto& compressed = blocks[firstBlock[arrayIdx] + i].compressed;
+                std::memcpy(out, compressed.data(), compressed.size());
+                out += compressed.size();
+            }
+        }
+#else
+        static_cast<void>(arrays);
+        throw std::logic_error("VTK output can only be compressed if zlib is available");
+#endif
+    }
+
+    static const char* byteOrder_()
+    {
+        const std::uint16_t probe = 1;
+        return (*reinterpret_cast<const unsigned char*>(&probe) == 1) ? "LittleEndian" : "BigEndian";
+    }
+
+    std::size_t numPoints_;
+    std::vector<std::size_t> interiorElements_;
+    bool enableCompression_;
+    int numCompressionThreads_;
+
+    DataArray points_;
+    DataArray connectivity_;
+    DataArray offsets_;
+    DataArray types_;
+
+    std::vector<DataArray> pointData_;
+    std::vector<DataArray> cellData_;
+};
+
+} // namespace Opm
+
+#endif
@@ -123,7 +123,7 @@ public:
         // retrieve capillary pressure parameters
         const auto& problem = elemCtx.problem();
         const MaterialLawParams& materialParams =
-            problem.materialLawParams(elemCtx, dofIdx, timeIdx);
+            problem.cachedMaterialLawParams(elemCtx, dofIdx, timeIdx);
         // calculate capillary pressures
         Evaluation capPress[numPhases];
         MaterialLaw::capillaryPressures(capPress, materialParams, fluidState_);
@@ -157,7 +157,7 @@ public:
         }
 
         // porosity
-        porosity_ = problem.porosity(elemCtx, dofIdx, timeIdx);
+        porosity_ = problem.cachedPorosity(elemCtx, dofIdx, timeIdx);
         Opm::Valgrind::CheckDefined(porosity_);
 
         // relative permeabilities
@@ -173,7 +173,7 @@ public:
         }
 
         // intrinsic permeability
-        intrinsicPerm_ = problem.intrinsicPermeability(elemCtx, dofIdx, timeIdx);
+        intrinsicPerm_ = problem.cachedIntrinsicPermeability(elemCtx, dofIdx, timeIdx);
 
         // update the quantities specific for the velocity model
         FluxIntensiveQuantities::update_(elemCtx, dofIdx, timeIdx);
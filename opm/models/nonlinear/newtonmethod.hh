@@ -36,17 +36,24 @@
 #include <opm/material/densead/Math.hpp>
 
 #include <opm/models/discretization/common/fvbaseproperties.hh>
+#include <opm/models/discretization/common/linearizationtype.hh>
 
 #include <opm/models/nonlinear/newtonmethodparameters.hh>
 #include <opm/models/nonlinear/newtonmethodproperties.hh>
 #include <opm/models/nonlinear/nullconvergencewriter.hh>
 
+#include <opm/models/parallel/packedallreduce.hh>
+
+#include <opm/models/utils/allocationaudit.hh>
+#include <opm/models/utils/genericguard.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
 
 #include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/pressuretransportsplitting.hh>
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 #include <unistd.h>
@@ -104,6 +111,12 @@ class NewtonMethod
     using Linearizer = GetPropType<TypeTag, Properties::Linearizer>;
     using LinearSolverBackend = GetPropType<TypeTag, Properties::LinearSolverBackend>;
     using ConvergenceWriter = GetPropType<TypeTag, Properties::NewtonConvergenceWriter>;
+    using Indices = GetPropType<TypeTag, Properties::Indices>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+    using PressureTransportSplitting =
+        Linear::PressureTransportSplitting<typename SparseMatrixAdapter::IstlMatrix, GlobalEqVector>;
+
+    static constexpr int pressureIdx = Linear::PressureVariableIndex<Indices>::value;
 
     using Communicator = typename Dune::MPIHelper::MPICommunicator;
     using CollectiveCommunication = typename Dune::Communication<typename Dune::MPIHelper::MPICommunicator>;
@@ -115,12 +128,20 @@ public:
         , linearSolver_(simulator)
         , comm_(Dune::MPIHelper::getCommunicator())
         , convergenceWriter_(asImp_())
+        , enablePackedReductions_(Parameters::Get<Parameters::NewtonPackReductions>())
+        , endIterReduction_(Dune::MPIHelper::getCommunicator())
+        , errorReduction_(Dune::MPIHelper::getCommunicator())
+        , enableSequentialImplicit_(Parameters::Get<Parameters::NewtonSequentialImplicit>())
     {
         lastError_ = 1e100;
         error_ = 1e100;
         tolerance_ = Parameters::Get<Parameters::NewtonTolerance<Scalar>>();
+        maxJacobianReuses_ = Parameters::Get<Parameters::NewtonMaxJacobianReuses>();
+        jacobianReuseContraction_ = Parameters::Get<Parameters::NewtonJacobianReuseContraction<Scalar>>();
 
         numIterations_ = 0;
+        beginIterationSucceeded_ = true;
+        endIterationFailed_ = false;
     }
 
     /*!
@@ -146,6 +167,30 @@ public:
         Parameters::Register<Parameters::NewtonMaxError<Scalar>>
             ("The maximum error tolerated by the Newton "
              "method to which does not cause an abort");
+        Parameters::Register<Parameters::NewtonMaxJacobianReuses>
+            ("The maximum number of consecutive Newton iterations which reuse the "
+             "Jacobian of a previous one. 0 recomputes it in every iteration");
+        Parameters::Register<Parameters::NewtonJacobianReuseContraction<Scalar>>
+            ("The factor by which each Newton iteration must reduce the error for "
+             "the Jacobian to be reused");
+        Parameters::Register<Parameters::NewtonPackReductions>
+            ("Combine the global reductions of a Newton iteration into few "
+             "non-blocking ones");
+        Parameters::Register<Parameters::NewtonSequentialImplicit>
+            ("Alternate between solving for pressure and for transport instead of "
+             "solving the fully implicit system, which is used as a fallback");
+        Parameters::Register<Parameters::NewtonSequentialInnerIterations>
+            ("The maximum number of pressure and of transport iterations per outer "
+             "iteration of the sequential implicit strategy");
+        Parameters::Register<Parameters::NewtonSequentialInnerReduction<Scalar>>
+            ("The reduction of the pressure and of the transport residual after which "
+             "the inner iterations of the sequential implicit strategy stop");
+        Parameters::Register<Parameters::NewtonSequentialPressureTolerance<Scalar>>
+            ("The reduction of the residual required by the linear solver for the "
+             "pressure system of the sequential implicit strategy");
+        Parameters::Register<Parameters::NewtonSequentialTransportTolerance<Scalar>>
+            ("The reduction of the residual required by the linear solver for the "
+             "transport system of the sequential implicit strategy");
     }
 
     /*!
@@ -162,7 +207,7 @@ public:
      *        tolerance.
      */
     bool converged() const
-    { return error_ <= tolerance(); }
+    { return error_ <= tolerance() && !endIterationFailed_; }
 
     /*!
      * \brief Returns a reference to the object describing the current physical problem.
@@ -195,6 +240,36 @@ public:
     int numIterations() const
     { return numIterations_; }
 
+    /*!
+     * \brief Returns the number of iterations which were actually done by the last
+     *        invocation of the Newton method.
+     *
+     * In contrast to numIterations(), this is not changed if the Newton method fails.
+     */
+    int numLastIterations() const
+    { return numLastIterations_; }
+
+    /*!
+     * \brief Returns the number of time steps for which the sequential implicit
+     *        strategy converged.
+     */
+    unsigned numSequentialImplicitConverged() const
+    { return numSequentialImplicitConverged_; }
+
+    /*!
+     * \brief Returns the number of time steps for which the sequential implicit
+     *        strategy did not converge and the fully implicit Newton method was used.
+     */
+    unsigned numSequentialImplicitFallbacks() const
+    { return numSequentialImplicitFallbacks_; }
+
+    /*!
+     * \brief Returns the number of iterations which reused the Jacobian of a previous
+     *        iteration since the Newton method was constructed.
+     */
+    unsigned numJacobianReuses() const
+    { return numJacobianReuses_; }
+
     /*!
      * \brief Set the index of current iteration.
      *
@@ -224,8 +299,37 @@ public:
      *
      * The actual implementation can influence all the strategic
      * decisions via callbacks using static polymorphism.
+     *
+     * If the sequential implicit strategy is enabled and it does not converge, the
+     * fully implicit Newton method is applied to the initial solution.
      */
     bool apply()
+    {
+        if (asImp_().useSequentialImplicit_()) {
+            SolutionVector& solution = model().solution(/*historyIdx=*/0);
+            SolutionVector initialSolution(solution);
+            if (asImp_().applySequentialImplicit_()) {
+                ++numSequentialImplicitConverged_;
+                return true;
+            }
+
+            ++numSequentialImplicitFallbacks_;
+            if (asImp_().verbose_())
+                std::cout << "Sequential implicit strategy did not converge. "
+                          << "Retrying with the fully implicit Newton method\n" << std::flush;
+
+            solution = initialSolution;
+            model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+        }
+
+        return asImp_().applyFullyImplicit_();
+    }
+
+protected:
+    /*!
+     * \brief Run the fully implicit Newton method.
+     */
+    bool applyFullyImplicit_()
     {
         // Clear the current line using an ansi escape
         // sequence.  For an explanation see
@@ -266,6 +370,10 @@ public:
             while (asImp_().proceed_()) {
                 // linearize the problem at the current solution
 
+                // beginIteration_() overwrites the error of the solution before the
+                // last update, which is needed to decide whether the Jacobian is reused
+                previousError_ = lastError_;
+
                 // notify the implementation that we're about to start
                 // a new iteration
                 prePostProcessTimer_.start();
@@ -275,6 +383,10 @@ public:
                 // make the current solution to the old one
                 currentSolution = nextSolution;
 
+                // if the method converges fast enough, the Jacobian of a previous
+                // iteration is kept and only the residual is recomputed
+                bool reuseJacobian = asImp_().reuseJacobian_();
+
                 if (asImp_().verbose_()) {
                     std::cout << "Linearize: r(x^k) = dS/dt + div F - q;   M = grad r"
                               << clearRemainingLine
@@ -282,18 +394,9 @@ public:
                 }
 
                 // do the actual linearization
-                linearizeTimer_.start();
-                asImp_().linearizeDomain_();
-                asImp_().linearizeAuxiliaryEquations_();
-                linearizeTimer_.stop();
-
-                solveTimer_.start();
+                linearizeSystem_(reuseJacobian);
                 auto& residual = linearizer.residual();
                 const auto& jacobian = linearizer.jacobian();
-                linearSolver_.prepare(jacobian, residual);
-                linearSolver_.setResidual(residual);
-                linearSolver_.getResidual(residual);
-                solveTimer_.stop();
 
                 // The preSolve_() method usually computes the errors, but it can do
                 // something else in addition. TODO: should its costs be counted to
@@ -315,6 +418,24 @@ public:
                     break;
                 }
 
+                // the reused Jacobian did not reduce the error sufficiently, so the one
+                // of the current solution is computed
+                if (reuseJacobian && error_ > jacobianReuseContraction_*lastError_) {
+                    reuseJacobian = false;
+                    linearizeSystem_(/*reuseJacobian=*/false);
+                }
+
+                // give the implementation a chance to improve the solution before the
+                // global update, e.g., by solving local nonlinear problems. in this case,
+                // the system must be linearized again.
+                updateTimer_.start();
+                const bool solutionChanged = asImp_().solveSubDomains_(nextSolution);
+                updateTimer_.stop();
+                if (solutionChanged) {
+                    currentSolution = nextSolution;
+                    linearizeSystem_(reuseJacobian);
+                }
+
                 // solve the resulting linear equation system
                 if (asImp_().verbose_()) {
                     std::cout << "Solve: M deltax^k = r"
@@ -324,12 +445,34 @@ public:
 
                 solveTimer_.start();
                 // solve A x = b, where b is the residual, A is its Jacobian and x is the
-                // update of the solution
-                linearSolver_.setMatrix(jacobian);
+                // update of the solution. if the Jacobian is reused, the linear solver
+                // still has it, including its preconditioner.
+                if (!reuseJacobian)
+                    linearSolver_.setMatrix(jacobian);
                 solutionUpdate = 0.0;
                 bool converged = linearSolver_.solve(solutionUpdate);
                 solveTimer_.stop();
 
+                if (!converged && reuseJacobian) {
+                    // retry using the Jacobian of the current solution
+                    reuseJacobian = false;
+                    linearizeSystem_(/*reuseJacobian=*/false);
+
+                    solveTimer_.start();
+                    linearSolver_.setMatrix(jacobian);
+                    solutionUpdate = 0.0;
+                    converged = linearSolver_.solve(solutionUpdate);
+                    solveTimer_.stop();
+                }
+
+                if (reuseJacobian) {
+                    ++jacobianReuses_;
+                    ++numJacobianReuses_;
+                    endIterMsg() << ", Jacobian reused";
+                }
+                else
+                    jacobianReuses_ = 0;
+
                 if (!converged) {
                     solveTimer_.stop();
                     if (asImp_().verbose_())
@@ -418,6 +561,16 @@ public:
                       << updateTimer_.realTimeElapsed() << "("
                       << 100 * updateTimer_.realTimeElapsed()/elapsedTot << "%)"
                       << "\n" << std::flush;
+
+            if (enablePackedReductions_) {
+                unsigned numReductions =
+                    endIterReduction_.numReductions() + errorReduction_.numReductions();
+                unsigned numValues =
+                    endIterReduction_.numValuesReduced() + errorReduction_.numValuesReduced();
+                std::cout << "Global reductions so far: " << numReductions << " instead of " << numValues
+                          << ", waited " << endIterReduction_.waitTimer().realTimeElapsed()
+                          << " seconds for the non-blocking ones\n" << std::flush;
+            }
         }
 
 
@@ -437,6 +590,344 @@ public:
         return true;
     }
 
+    /*!
+     * \brief Returns true iff the sequential implicit strategy is used for the
+     *        current time step.
+     */
+    bool useSequentialImplicit_()
+    {
+        if (!enableSequentialImplicit_)
+            return false;
+
+        // the pressure and the transport systems are solved by sequential solvers, the
+        // auxiliary equations (e.g. wells) are not part of the splitting, the splitting
+        // needs the off-diagonal blocks of the Jacobian and models with a single
+        // equation do not have a transport system
+        const bool usable =
+            comm_.size() == 1 && model().numAuxiliaryModules() == 0 &&
+            Linear::NeedsOffDiagonalBlocks<LinearSolverBackend>::value &&
+            PressureTransportSplitting::splittable();
+        if (!usable && !sequentialImplicitUnusableReported_) {
+            if (comm_.rank() == 0)
+                std::cout << "The sequential implicit strategy is not available for "
+                          << "parallel runs, models with auxiliary equations or a "
+                          << "single equation and matrix-free linear solvers. "
+                          << "Using the fully implicit Newton method\n" << std::flush;
+            sequentialImplicitUnusableReported_ = true;
+        }
+
+        return usable;
+    }
+
+    /*!
+     * \brief Run the sequential implicit strategy.
+     *
+     * Each outer iteration linearizes the system with regard to pressure. The residual
+     * of this linearization decides about convergence. If it is not converged yet, a
+     * few Newton iterations are done for the pressure equation, followed by a few
+     * Newton iterations for the transport equations at fixed pressure. The outer
+     * iterations are controlled by the same callbacks as the iterations of the fully
+     * implicit Newton method.
+     *
+     * The quasi-IMPES weights of the pressure equation require all columns of the
+     * diagonal blocks of the Jacobian. Therefore only the first outer iteration of a
+     * time step linearizes the fully implicit system, the later ones combine the
+     * pressure columns with the remaining columns of the last transport iteration.
+     */
+    bool applySequentialImplicit_()
+    {
+        // make sure all timers are prestine
+        prePostProcessTimer_.halt();
+        linearizeTimer_.halt();
+        solveTimer_.halt();
+        updateTimer_.halt();
+
+        SolutionVector& nextSolution = model().solution(/*historyIdx=*/0);
+        SolutionVector currentSolution(nextSolution);
+        SolutionVector innerSolution(nextSolution);
+        GlobalEqVector solutionUpdate(nextSolution.size());
+
+        Linearizer& linearizer = model().linearizer();
+
+        if (!splitting_)
+            splitting_ = std::make_unique<PressureTransportSplitting>(pressureIdx);
+
+        TimerGuard prePostProcessTimerGuard(prePostProcessTimer_);
+
+        prePostProcessTimer_.start();
+        asImp_().begin_(nextSolution);
+        prePostProcessTimer_.stop();
+
+        bool succeeded = true;
+        try {
+            TimerGuard innerPrePostProcessTimerGuard(prePostProcessTimer_);
+            TimerGuard linearizeTimerGuard(linearizeTimer_);
+            TimerGuard updateTimerGuard(updateTimer_);
+            TimerGuard solveTimerGuard(solveTimer_);
+
+            while (asImp_().proceed_()) {
+                prePostProcessTimer_.start();
+                asImp_().beginIteration_();
+                prePostProcessTimer_.stop();
+
+                currentSolution = nextSolution;
+
+                // the residual does not depend on the linearization type, so it decides
+                // about the convergence of the fully implicit system
+                const bool firstIteration = numIterations_ == 0;
+                linearizeTimer_.start();
+                setLinearizationType_(firstIteration
+                                      ? LinearizationType::implicit
+                                      : LinearizationType::pressure);
+                asImp_().linearizeDomain_();
+                asImp_().linearizeAuxiliaryEquations_();
+                linearizeTimer_.stop();
+
+                updateTimer_.start();
+                asImp_().preSolve_(currentSolution, linearizer.residual());
+                updateTimer_.stop();
+
+                if (!asImp_().proceed_()) {
+                    prePostProcessTimer_.start();
+                    asImp_().endIteration_(nextSolution, currentSolution);
+                    prePostProcessTimer_.stop();
+                    break;
+                }
+
+                // the pressure derivatives of this linearization are also used by
+                // the first pressure iteration
+                solveTimer_.start();
+                const auto& jacobian = linearizer.jacobian().istlMatrix();
+                if (firstIteration)
+                    splitting_->setDiagonal(jacobian);
+                else
+                    splitting_->updateDiagonalPressure(jacobian);
+                splitting_->computeWeights();
+                solveTimer_.stop();
+
+                const int numPressureIterations =
+                    sequentialPressureIterations_(nextSolution, innerSolution, solutionUpdate);
+                const int numTransportIterations =
+                    sequentialTransportIterations_(nextSolution, innerSolution, solutionUpdate);
+                endIterMsg() << ", pressure iterations=" << numPressureIterations
+                             << ", transport iterations=" << numTransportIterations;
+
+                prePostProcessTimer_.start();
+                asImp_().endIteration_(nextSolution, currentSolution);
+                prePostProcessTimer_.stop();
+            }
+        }
+        catch (const Dune::Exception& e)
+        {
+            if (asImp_().verbose_())
+                std::cout << "Newton method caught exception: \""
+                          << e.what() << "\"\n" << std::flush;
+            succeeded = false;
+        }
+        catch (const NumericalProblem& e)
+        {
+            if (asImp_().verbose_())
+                std::cout << "Newton method caught exception: \""
+                          << e.what() << "\"\n" << std::flush;
+            succeeded = false;
+        }
+
+        setLinearizationType_(LinearizationType::implicit);
+
+        if (succeeded) {
+            prePostProcessTimer_.start();
+            asImp_().end_();
+            prePostProcessTimer_.stop();
+
+            succeeded = asImp_().converged();
+        }
+
+        prePostProcessTimer_.start();
+        if (succeeded)
+            asImp_().succeeded_();
+        else
+            asImp_().failed_();
+        prePostProcessTimer_.stop();
+
+        return succeeded;
+    }
+
+    /*!
+     * \brief Do the Newton iterations for the pressure equation of an outer iteration
+     *        of the sequential implicit strategy.
+     *
+     * The linearization of the outer iteration is used for the first iteration.
+     * Returns the number of iterations.
+     */
+    int sequentialPressureIterations_(SolutionVector& nextSolution,
+                                      SolutionVector& innerSolution,
+                                      GlobalEqVector& solutionUpdate)
+    {
+        Linearizer& linearizer = model().linearizer();
+        const int maxIterations = Parameters::Get<Parameters::NewtonSequentialInnerIterations>();
+        const Scalar reduction = Parameters::Get<Parameters::NewtonSequentialInnerReduction<Scalar>>();
+        const Scalar linearReduction =
+            Parameters::Get<Parameters::NewtonSequentialPressureTolerance<Scalar>>();
+
+        Scalar initialNorm = 0.0;
+        int iterIdx = 0;
+        for (; iterIdx < maxIterations; ++iterIdx) {
+            if (iterIdx > 0) {
+                linearizeTimer_.start();
+                setLinearizationType_(LinearizationType::pressure);
+                asImp_().linearizeDomain_();
+                asImp_().linearizeAuxiliaryEquations_();
+                linearizeTimer_.stop();
+            }
+
+            solveTimer_.start();
+            const auto& residual = linearizer.residual();
+            const Scalar norm =
+                splitting_->assemblePressureSystem(linearizer.jacobian().istlMatrix(), residual);
+            if (iterIdx == 0)
+                initialNorm = norm;
+            if (norm <= reduction*initialNorm) {
+                solveTimer_.stop();
+                break;
+            }
+
+            const bool converged =
+                splitting_->solvePressureSystem(solutionUpdate, linearReduction,
+                                                /*maxIterations=*/1000);
+            solveTimer_.stop();
+            if (!converged)
+                throw NumericalProblem("The linear solver for the pressure system did not converge");
+
+            updateTimer_.start();
+            innerSolution = nextSolution;
+            asImp_().update_(nextSolution, innerSolution, solutionUpdate, residual);
+            updateTimer_.stop();
+        }
+
+        return iterIdx;
+    }
+
+    /*!
+     * \brief Do the Newton iterations for the transport equations at fixed pressure of
+     *        an outer iteration of the sequential implicit strategy.
+     *
+     * Returns the number of iterations.
+     */
+    int sequentialTransportIterations_(SolutionVector& nextSolution,
+                                       SolutionVector& innerSolution,
+                                       GlobalEqVector& solutionUpdate)
+    {
+        Linearizer& linearizer = model().linearizer();
+        const int maxIterations = Parameters::Get<Parameters::NewtonSequentialInnerIterations>();
+        const Scalar reduction = Parameters::Get<Parameters::NewtonSequentialInnerReduction<Scalar>>();
+        const Scalar linearReduction =
+            Parameters::Get<Parameters::NewtonSequentialTransportTolerance<Scalar>>();
+
+        Scalar initialNorm = 0.0;
+        int iterIdx = 0;
+        for (; iterIdx < maxIterations; ++iterIdx) {
+            linearizeTimer_.start();
+            setLinearizationType_(LinearizationType::seqtransport);
+            asImp_().linearizeDomain_();
+            asImp_().linearizeAuxiliaryEquations_();
+            linearizeTimer_.stop();
+
+            solveTimer_.start();
+            const auto& residual = linearizer.residual();
+            const auto& jacobian = linearizer.jacobian().istlMatrix();
+            splitting_->updateDiagonalTransport(jacobian);
+            const Scalar norm = splitting_->assembleTransportSystem(jacobian, residual);
+            if (iterIdx == 0)
+                initialNorm = norm;
+            if (norm <= reduction*initialNorm) {
+                solveTimer_.stop();
+                break;
+            }
+
+            const bool converged =
+                splitting_->solveTransportSystem(solutionUpdate, linearReduction,
+                                                 /*maxIterations=*/1000);
+            solveTimer_.stop();
+            if (!converged)
+                throw NumericalProblem("The linear solver for the transport system did not converge");
+
+            updateTimer_.start();
+            innerSolution = nextSolution;
+            asImp_().update_(nextSolution, innerSolution, solutionUpdate, residual);
+            updateTimer_.stop();
+        }
+
+        return iterIdx;
+    }
+
+    /*!
+     * \brief Linearize the system of equations at the current solution and pass the
+     *        residual to the linear solver.
+     *
+     * If the Jacobian is reused, only the residual is recomputed.
+     */
+    void linearizeSystem_(bool reuseJacobian)
+    {
+        auto& linearizer = model().linearizer();
+
+        linearizeTimer_.start();
+        linearizer.setReuseJacobian(reuseJacobian);
+        auto resetReuseFn = [&linearizer]() -> void
+                            { linearizer.setReuseJacobian(false); };
+        auto resetReuseGuard = Opm::make_guard(resetReuseFn);
+        asImp_().linearizeDomain_();
+        asImp_().linearizeAuxiliaryEquations_();
+        linearizeTimer_.stop();
+
+        solveTimer_.start();
+        auto& residual = linearizer.residual();
+        linearSolver_.prepare(linearizer.jacobian(), residual);
+        linearSolver_.setResidual(residual);
+        linearSolver_.getResidual(residual);
+        solveTimer_.stop();
+    }
+
+    /*!
+     * \brief Returns true if the Jacobian of the previous iteration is to be reused.
+     *
+     * This is the case if the last update reduced the error at least by the factor
+     * given by NewtonJacobianReuseContraction and the Jacobian was not reused too
+     * often already. Since this requires the errors of two solutions of the current
+     * time step, the Jacobian is recomputed for the first two iterations of each time
+     * step.
+     */
+    bool reuseJacobian_() const
+    {
+        if (maxJacobianReuses_ <= 0 || numIterations_ < 2 || jacobianReuses_ >= maxJacobianReuses_)
+            return false;
+
+        // the auxiliary equations write their own parts of the Jacobian
+        if (model().numAuxiliaryModules() > 0)
+            return false;
+
+        return error_ <= jacobianReuseContraction_*previousError_;
+    }
+
+    /*!
+     * \brief Set the primary variables with regard to which the model is linearized.
+     */
+    void setLinearizationType_(LinearizationType::VarType type)
+    {
+        auto& linearizer = model().linearizer();
+        LinearizationType linearizationType = linearizer.getLinearizationType();
+        if (linearizationType.type == type)
+            return;
+
+        linearizationType.type = type;
+        linearizer.setLinearizationType(linearizationType);
+
+        // the derivatives of the cached intensive quantities depend on the
+        // linearization type
+        model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+    }
+
+public:
+
     /*!
      * \brief Suggest a new time-step size based on the old time-step
      *        size.
@@ -520,6 +1011,8 @@ protected:
     void begin_(const SolutionVector&)
     {
         numIterations_ = 0;
+        endIterationFailed_ = false;
+        endIterReduction_.clear();
 
         if (Parameters::Get<Parameters::NewtonWriteConvergence>()) {
             convergenceWriter_.beginTimeStep();
@@ -546,6 +1039,13 @@ protected:
                       << "\n"  << std::flush;
         }
 
+        if (enablePackedReductions_) {
+            // the flag is reduced together with the error of the iteration
+            beginIterationSucceeded_ = succeeded;
+            lastError_ = error_;
+            return;
+        }
+
         succeeded = comm.min(succeeded);
 
         if (!succeeded)
@@ -569,6 +1069,19 @@ protected:
         model().linearizer().finalize();
     }
 
+    /*!
+     * \brief Improve the solution between the linearization and the solution of the
+     *        global linear system.
+     *
+     * This is called after the convergence check of each iteration. If the solution
+     * is changed, true must be returned, so that the system is linearized again. The
+     * default implementation does nothing.
+     *
+     * \param nextSolution The current solution, which may be modified
+     */
+    bool solveSubDomains_(SolutionVector&)
+    { return false; }
+
     void preSolve_(const SolutionVector&,
                    const GlobalEqVector& currentResidual)
     {
@@ -596,7 +1109,25 @@ protected:
         }
 
         // take the other processes into account
-        error_ = comm_.max(error_);
+        if (enablePackedReductions_) {
+            // the reduction started at the end of the previous iteration has been
+            // overlapping with the linearization
+            finishEndIterationReduction_();
+            if (endIterationFailed_)
+                throw NumericalProblem("post processing of the previous iteration failed");
+
+            errorReduction_.clear();
+            unsigned errorSlot = errorReduction_.add(error_, PackedAllReduce::Operation::Max);
+            errorReduction_.addSuccessFlag(beginIterationSucceeded_);
+            errorReduction_.start();
+            errorReduction_.finish();
+
+            if (!errorReduction_.allSucceeded())
+                throw NumericalProblem("pre processing of the problem failed");
+            error_ = errorReduction_.result(errorSlot);
+        }
+        else
+            error_ = comm_.max(error_);
 
         // make sure that the error never grows beyond the maximum
         // allowed one
@@ -677,6 +1208,7 @@ protected:
         if (!std::isfinite(solutionUpdate.one_norm()))
             throw NumericalProblem("Non-finite update!");
 
+        NoAllocationRegion noAllocationRegion("NewtonMethod::update_");
         size_t numGridDof = model().numGridDof();
         for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
             if (enableConstraints_()) {
@@ -770,10 +1302,18 @@ protected:
                       << "\n"  << std::flush;
         }
 
-        succeeded = comm.min(succeeded);
+        if (enablePackedReductions_) {
+            // the flags of this iteration are only needed once the error of the next
+            // one is known, so the reduction can overlap with the linearization
+            endIterReduction_.addSuccessFlag(succeeded);
+            endIterReduction_.start();
+        }
+        else {
+            succeeded = comm.min(succeeded);
 
-        if (!succeeded)
-            throw NumericalProblem("post processing of the problem failed");
+            if (!succeeded)
+                throw NumericalProblem("post processing of the problem failed");
+        }
 
         if (asImp_().verbose_()) {
             std::cout << "Newton iteration " << numIterations_ << ""
@@ -811,6 +1351,9 @@ protected:
      */
     void end_()
     {
+        // the iteration is only converged if its post processing succeeded everywhere
+        finishEndIterationReduction_();
+
         if (Parameters::Get<Parameters::NewtonWriteConvergence>()) {
             convergenceWriter_.endTimeStep();
         }
@@ -822,7 +1365,45 @@ protected:
      * This method is called _after_ end_()
      */
     void failed_()
-    { numIterations_ = targetIterations_() * 2; }
+    {
+        // all processes need to complete the pending reduction
+        endIterReduction_.clear();
+        // the number of iterations is used to determine the size of the next time step
+        numLastIterations_ = numIterations_;
+        numIterations_ = targetIterations_() * 2;
+    }
+
+    /*!
+     * \brief Returns true iff the global reductions of an iteration are combined.
+     *
+     * If this is the case, derived classes add the values which they need to be reduced
+     * at the end of an iteration to endIterationReduction_() before calling
+     * endIteration_() of this class. They can access the results in
+     * endIterationReductionFinished_().
+     */
+    bool packReductions_() const
+    { return enablePackedReductions_; }
+
+    PackedAllReduce& endIterationReduction_()
+    { return endIterReduction_; }
+
+    /*!
+     * \brief Called once the reduction started at the end of an iteration is complete.
+     */
+    void endIterationReductionFinished_()
+    { }
+
+    // complete the reduction started at the end of the previous iteration (if any)
+    void finishEndIterationReduction_()
+    {
+        if (!endIterReduction_.pending())
+            return;
+
+        endIterReduction_.finish();
+        endIterationFailed_ = !endIterReduction_.allSucceeded();
+        asImp_().endIterationReductionFinished_();
+        endIterReduction_.clear();
+    }
 
     /*!
      * \brief Called if the Newton method was successful.
@@ -830,7 +1411,7 @@ protected:
      * This method is called _after_ end_()
      */
     void succeeded_()
-    {}
+    { numLastIterations_ = numIterations_; }
 
     // optimal number of iterations we want to achieve
     int targetIterations_() const
@@ -853,10 +1434,20 @@ protected:
 
     Scalar error_;
     Scalar lastError_;
+    // the error of the solution before the last update
+    Scalar previousError_ = 1e100;
     Scalar tolerance_;
 
+    // the reuse of the Jacobian between iterations
+    int maxJacobianReuses_;
+    Scalar jacobianReuseContraction_;
+    int jacobianReuses_ = 0;
+    unsigned numJacobianReuses_ = 0;
+
     // actual number of iterations done so far
     int numIterations_;
+    // the number of iterations done by the last invocation of the Newton method
+    int numLastIterations_ = 0;
 
     // the linear solver
     LinearSolverBackend linearSolver_;
@@ -869,6 +1460,20 @@ protected:
     // method to disk
     ConvergenceWriter convergenceWriter_;
 
+    // combine the global reductions of each iteration
+    bool enablePackedReductions_;
+    PackedAllReduce endIterReduction_;
+    PackedAllReduce errorReduction_;
+    bool beginIterationSucceeded_;
+    bool endIterationFailed_;
+
+    // the sequential implicit strategy
+    bool enableSequentialImplicit_;
+    bool sequentialImplicitUnusableReported_ = false;
+    unsigned numSequentialImplicitConverged_ = 0;
+    unsigned numSequentialImplicitFallbacks_ = 0;
+    std::unique_ptr<PressureTransportSplitting> splitting_;
+
 private:
     Implementation& asImp_()
     { return *static_cast<Implementation *>(this); }
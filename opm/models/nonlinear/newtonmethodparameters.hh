@@ -25,6 +25,11 @@
 
 namespace Opm::Parameters {
 
+//! The factor by which each Newton iteration must at least reduce the error for the
+//! Jacobian to be reused in the next iteration
+template<class Scalar>
+struct NewtonJacobianReuseContraction { static constexpr Scalar value = 0.5; };
+
 //! The maximum error which may occur in a simulation before the
 //! Newton method for the time step is aborted
 template<class Scalar>
@@ -33,6 +38,74 @@ struct NewtonMaxError { static constexpr Scalar value = 1e100; };
 //! Number of maximum iterations for the Newton method.
 struct NewtonMaxIterations { static constexpr int value = 20; };
 
+/*!
+ * \brief The maximum number of consecutive iterations which reuse the Jacobian of a
+ *        previous Newton iteration.
+ *
+ * While the Newton method converges fast enough, the Jacobian and the preconditioner
+ * of the linear solver are kept, so that the iteration only requires the evaluation
+ * of the residual and the linear solve. 0 disables the reuse.
+ */
+struct NewtonMaxJacobianReuses { static constexpr int value = 0; };
+
+//! The maximum number of local Newton iterations per subdomain and global iteration
+//! of the nonlinear domain decomposition
+struct NewtonMaxSubDomainIterations { static constexpr int value = 4; };
+
+/*!
+ * \brief The number of subdomains per process of the nonlinear domain decomposition.
+ *
+ * If positive, the nonlinear problem of each subdomain is solved before the global
+ * update is computed in every Newton iteration, with the unknowns outside of the
+ * subdomain kept fixed. Zero disables the domain decomposition.
+ */
+struct NewtonNumSubDomains { static constexpr int value = 0; };
+
+/*!
+ * \brief Combine the global reductions of a Newton iteration.
+ *
+ * If enabled, the flags and counters which need to be reduced at the end of an
+ * iteration are reduced by a single non-blocking collective which overlaps with the
+ * linearization of the next iteration, and the remaining ones are reduced together
+ * with the error.
+ */
+struct NewtonPackReductions { static constexpr bool value = false; };
+
+/*!
+ * \brief Use the sequential implicit strategy instead of the fully implicit one.
+ *
+ * Each outer iteration does a few Newton iterations for the pressure equation followed
+ * by a few Newton iterations for the transport equations at fixed pressure. If the
+ * fully implicit residual does not converge this way, the time step is retried using
+ * the fully implicit Newton method. The strategy is only used for sequential runs of
+ * models without auxiliary equations.
+ */
+struct NewtonSequentialImplicit { static constexpr bool value = false; };
+
+//! The maximum number of pressure and transport iterations per outer iteration of
+//! the sequential implicit strategy
+struct NewtonSequentialInnerIterations { static constexpr int value = 3; };
+
+//! The reduction of the residual of the pressure and the transport equations after
+//! which the inner iterations of the sequential implicit strategy are stopped
+template<class Scalar>
+struct NewtonSequentialInnerReduction { static constexpr Scalar value = 1e-2; };
+
+//! The reduction of the residual at which the linear solver for the pressure system
+//! of the sequential implicit strategy is considered to be converged
+template<class Scalar>
+struct NewtonSequentialPressureTolerance { static constexpr Scalar value = 1e-6; };
+
+//! The reduction of the residual at which the linear solver for the transport system
+//! of the sequential implicit strategy is considered to be converged
+template<class Scalar>
+struct NewtonSequentialTransportTolerance { static constexpr Scalar value = 1e-4; };
+
+//! The reduction of the residual at which the linear solver for a subdomain of the
+//! nonlinear domain decomposition is considered to be converged
+template<class Scalar>
+struct NewtonSubDomainLinearReduction { static constexpr Scalar value = 1e-4; };
+
 /*!
  * \brief The number of iterations at which the Newton method
  *        should aim at.
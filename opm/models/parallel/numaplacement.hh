@@ -0,0 +1,411 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::NumaPlacement
+ */
+#ifndef EWOMS_NUMA_PLACEMENT_HH
+#define EWOMS_NUMA_PLACEMENT_HH
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+#define EWOMS_HAVE_NUMA_PLACEMENT 1
+#else
+#define EWOMS_HAVE_NUMA_PLACEMENT 0
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup Parallel
+ *
+ * \brief Places the pages of large arrays on the NUMA nodes of the threads which
+ *        process them.
+ *
+ * The large per-DOF arrays of the model and the Jacobian are allocated by the main
+ * thread, so the operating system usually puts all their pages onto the memory of the
+ * socket which runs it. The threaded loops over the degrees of freedom then mostly
+ * read remote memory.
+ *
+ * If NUMA aware initialization is enabled, each thread of the OpenMP team first
+ * touches the pages of its part of an array, i.e., the part which it processes in a
+ * loop that uses schedule(static). Since the arrays are usually already initialized
+ * when they are placed, the touched pages are then migrated to the NUMA node of the
+ * thread using the move_pages() system call. This keeps their content, so it also
+ * works for arrays which were filled serially. No NUMA library is required; on
+ * systems without the system call, nothing happens.
+ *
+ * The placement only pays off for the loops which use the same static partition.
+ * Loops which hand out the elements dynamically, like the ones based on
+ * ThreadedEntityIterator, must thus iterate over the static element order of the
+ * model instead if the placement is enabled. Also, the placement is only stable if
+ * the threads do not move between the sockets, so it should be combined with pinning
+ * the threads, see pinThreads().
+ */
+class NumaPlacement
+{
+public:
+    struct NodeStatistics
+    {
+        //! the number of threads which ran on the node during the last placement
+        unsigned numThreads = 0;
+        //! the number of pages of the placed arrays which reside on the node
+        std::size_t numPages = 0;
+    };
+
+    static void setEnabled(bool yesno)
+    { enabled_ = yesno; }
+
+    static bool enabled()
+    { return enabled_; }
+
+    /*!
+     * \brief Returns the first index of the part of a loop over n iterations which is
+     *        processed by a given thread for schedule(static).
+     *
+     * The OpenMP standard leaves the exact partition to the implementation. This is
+     * the one of the GNU and LLVM runtimes: The iterations are split into contiguous
+     * chunks and the first n % numThreads threads get one additional iteration.
+     */
+    static std::size_t staticPartitionBegin(std::size_t n, unsigned threadIdx, unsigned numThreads)
+    {
+        const std::size_t chunkSize = n/numThreads;
+        const std::size_t remainder = n%numThreads;
+        return threadIdx*chunkSize + std::min<std::size_t>(threadIdx, remainder);
+    }
+
+    /*!
+     * \brief Pin the threads of the OpenMP team to the CPUs of the process.
+     *
+     * Thread i of the process with the node-local MPI rank r is bound to the CPU
+     * r*numThreads + i of the affinity mask of the process, so consecutive threads
+     * share a socket and the processes on a node which share the same mask, e.g.
+     * because the MPI launcher did not bind them, use disjoint CPUs. The local rank is
+     * taken from the environment of the MPI launcher, because this is called before
+     * MPI is initialized. If the mask does not contain enough CPUs for this, the
+     * threads of several processes would share CPUs, so nothing is done and the
+     * binding of the launcher is kept. Nothing is done either if the placement of the
+     * threads is already controlled by the OpenMP runtime, e.g. using OMP_PROC_BIND.
+     * Returns true if the threads were pinned.
+     *
+     * Threads which are created later inherit the CPU of the thread which creates
+     * them, so the number of threads should not change after this was called.
+     */
+    static bool pinThreads()
+    {
+#if defined(__linux__) && defined(_OPENMP)
+        if (omp_get_proc_bind() != omp_proc_bind_false)
+            return false;
+
+        cpu_set_t allowedCpus;
+        CPU_ZERO(&allowedCpus);
+        if (sched_getaffinity(/*pid=*/0, sizeof(allowedCpus), &allowedCpus) != 0)
+            return false;
+
+        std::vector<int> cpus;
+        for (int cpuIdx = 0; cpuIdx < CPU_SETSIZE; ++cpuIdx)
+            if (CPU_ISSET(cpuIdx, &allowedCpus))
+                cpus.push_back(cpuIdx);
+
+        const std::size_t numThreads = static_cast<std::size_t>(omp_get_max_threads());
+        const std::size_t firstCpu = localMpiRank_()*numThreads;
+        if (firstCpu + numThreads > cpus.size())
+            return false;
+
+        bool success = true;
+#pragma omp parallel reduction(&&:success)
+        {
+            const int cpuIdx = cpus[firstCpu + omp_get_thread_num()];
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(cpuIdx, &cpuSet);
+            success = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+        }
+
+        return success;
+#else
+        return false;
+#endif
+    }
+
+    /*!
+     * \brief Place an array whose elements are processed by a loop over its indices
+     *        using schedule(static).
+     */
+    template <class T>
+    static void placeArray(const T* data, std::size_t size)
+    {
+        if (!enabled() || size == 0)
+            return;
+
+        placeRanges_(reinterpret_cast<const char*>(data),
+                     [size](unsigned threadIdx, unsigned numThreads)
+                     {
+                         return std::make_pair(staticPartitionBegin(size, threadIdx, numThreads)*sizeof(T),
+                                               staticPartitionBegin(size, threadIdx + 1, numThreads)*sizeof(T));
+                     });
+    }
+
+    /*!
+     * \brief Place the blocks of a sparse matrix whose rows are processed by a loop
+     *        using schedule(static).
+     *
+     * This assumes that the blocks of the matrix are stored in a contiguous array in
+     * the order of the rows, like the ones of a Dune::BCRSMatrix.
+     */
+    template <class Matrix>
+    static void placeMatrix(const Matrix& matrix)
+    {
+        using Block = typename Matrix::block_type;
+
+        const std::size_t numRows = matrix.N();
+        if (!enabled() || matrix.nonzeroes() == 0)
+            return;
+
+        // the index of the first block of each row within the array of blocks
+        std::vector<std::size_t> rowOffsets(numRows + 1, 0);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            rowOffsets[rowIdx + 1] = rowOffsets[rowIdx] + matrix[rowIdx].size();
+
+        std::size_t firstRowIdx = 0;
+        while (matrix[firstRowIdx].size() == 0)
+            ++firstRowIdx;
+        const Block* firstBlock = &(*matrix[firstRowIdx].begin());
+
+        placeRanges_(reinterpret_cast<const char*>(firstBlock),
+                     [numRows, &rowOffsets](unsigned threadIdx, unsigned numThreads)
+                     {
+                         const std::size_t beginRow = staticPartitionBegin(numRows, threadIdx, numThreads);
+                         const std::size_t endRow = staticPartitionBegin(numRows, threadIdx + 1, numThreads);
+                         return std::make_pair(rowOffsets[beginRow]*sizeof(Block),
+                                               rowOffsets[endRow]*sizeof(Block));
+                     });
+    }
+
+    /*!
+     * \brief Returns the statistics of all arrays placed so far for each NUMA node.
+     */
+    static std::map<int, NodeStatistics> statistics()
+    {
+        std::lock_guard<std::mutex> lock(registry_().mutex);
+        return registry_().nodes;
+    }
+
+    /*!
+     * \brief Print the number of threads and the amount of placed memory of each NUMA
+     *        node.
+     */
+    static void report(std::ostream& os)
+    {
+        const auto nodes = statistics();
+        if (nodes.empty()) {
+            os << "NUMA aware initialization: no arrays were placed";
+            if (!EWOMS_HAVE_NUMA_PLACEMENT)
+                os << " (not supported on this platform)";
+            os << "\n";
+            return;
+        }
+
+        const std::size_t pageSize = pageSize_();
+        os << "NUMA placement of the large arrays:\n";
+        for (const auto& [nodeIdx, stats] : nodes) {
+            os << "  node " << nodeIdx << ": " << stats.numThreads << " threads, "
+               << stats.numPages*pageSize/(1024.0*1024.0) << " MiB\n";
+        }
+    }
+
+    /*!
+     * \brief Forget about the arrays which were placed so far.
+     */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(registry_().mutex);
+        registry_().nodes.clear();
+    }
+
+private:
+    struct Registry
+    {
+        std::mutex mutex;
+        std::map<int, NodeStatistics> nodes;
+    };
+
+    // the results of a single thread for one array
+    struct ThreadResult
+    {
+        int nodeIdx = -1;
+        std::map<int, std::size_t> numPages;
+    };
+
+    static Registry& registry_()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    // the rank of the process amongst the MPI processes on the same node as set by the
+    // launchers of Open MPI, MPICH/Intel MPI and MVAPICH. Zero if it is unknown.
+    static std::size_t localMpiRank_()
+    {
+        for (const char* name : { "OMPI_COMM_WORLD_LOCAL_RANK",
+                                  "MPI_LOCALRANKID",
+                                  "MV2_COMM_WORLD_LOCAL_RANK" })
+        {
+            if (const char* value = std::getenv(name))
+                return static_cast<std::size_t>(std::strtoul(value, nullptr, 10));
+        }
+        return 0;
+    }
+
+    static std::size_t pageSize_()
+    {
+#if defined(__linux__)
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+
+    // the part of the array of each thread is given by a pair of byte offsets relative
+    // to the beginning of the array
+    template <class ThreadRange>
+    static void placeRanges_([[maybe_unused]] const char* base,
+                             [[maybe_unused]] const ThreadRange& threadRange)
+    {
+#if EWOMS_HAVE_NUMA_PLACEMENT
+        // the system call is given at most this number of pages at once
+        static constexpr std::size_t maxPagesPerCall = 4096;
+        // the flag of move_pages() to move the pages which are only used by this process
+        static constexpr int moveFlag = 1 << 1;
+
+        const std::size_t pageSize = pageSize_();
+        std::vector<ThreadResult> results;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+#ifdef _OPENMP
+            const unsigned threadIdx = omp_get_thread_num();
+            const unsigned numThreads = omp_get_num_threads();
+#else
+            const unsigned threadIdx = 0;
+            const unsigned numThreads = 1;
+#endif
+#ifdef _OPENMP
+#pragma omp single
+#endif
+            results.resize(numThreads);
+
+            ThreadResult& result = results[threadIdx];
+            unsigned cpuIdx = 0;
+            unsigned nodeIdx = 0;
+            if (syscall(SYS_getcpu, &cpuIdx, &nodeIdx, nullptr) == 0)
+                result.nodeIdx = static_cast<int>(nodeIdx);
+
+            const auto [beginOffset, endOffset] = threadRange(threadIdx, numThreads);
+            const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(base) + beginOffset;
+            const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(base) + endOffset;
+
+            // the pages which start within the part of the thread. pages which are
+            // shared with the part of the previous thread belong to that thread.
+            const std::uintptr_t firstPage = (begin + pageSize - 1)/pageSize*pageSize;
+            std::vector<void*> pages;
+            std::vector<int> targetNodes;
+            std::vector<int> status;
+            for (std::uintptr_t page = firstPage; page < end; ) {
+                pages.clear();
+                for (; page < end && pages.size() < maxPagesPerCall; page += pageSize) {
+                    // the first touch for pages which were not written yet. adding
+                    // zero atomically leaves the content of all other pages untouched.
+                    __atomic_fetch_or(reinterpret_cast<unsigned char*>(page), 0, __ATOMIC_RELAXED);
+                    pages.push_back(reinterpret_cast<void*>(page));
+                }
+
+                if (result.nodeIdx < 0)
+                    continue;
+
+                targetNodes.assign(pages.size(), result.nodeIdx);
+                status.assign(pages.size(), -1);
+                if (syscall(SYS_move_pages, /*pid=*/0, pages.size(), pages.data(),
+                            targetNodes.data(), status.data(), moveFlag) < 0)
+                    continue;
+
+                for (const int pageNodeIdx : status)
+                    if (pageNodeIdx >= 0)
+                        ++result.numPages[pageNodeIdx];
+            }
+        }
+
+        addResults_(results);
+#endif // EWOMS_HAVE_NUMA_PLACEMENT
+    }
+
+    static void addResults_(const std::vector<ThreadResult>& results)
+    {
+        std::map<int, NodeStatistics> nodes;
+        for (const auto& result : results) {
+            if (result.nodeIdx < 0)
+                continue;
+
+            ++nodes[result.nodeIdx].numThreads;
+            for (const auto& [pageNodeIdx, numPages] : result.numPages)
+                nodes[pageNodeIdx].numPages += numPages;
+        }
+
+        std::lock_guard<std::mutex> lock(registry_().mutex);
+        for (const auto& [nodeIdx, stats] : nodes) {
+            auto& node = registry_().nodes[nodeIdx];
+            if (stats.numThreads > 0)
+                node.numThreads = stats.numThreads;
+            node.numPages += stats.numPages;
+        }
+    }
+
+    static inline bool enabled_ = false;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,259 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::PackedAllReduce
+ */
+#ifndef EWOMS_PACKED_ALL_REDUCE_HH
+#define EWOMS_PACKED_ALL_REDUCE_HH
+
+#include <opm/models/utils/timer.hh>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Combines several global reductions into a single non-blocking one.
+ *
+ * Each value is added together with the operation by which it ought to be reduced.
+ * start() then initiates a single MPI_Iallreduce for all values which is completed by
+ * finish(). Since all values are reduced in one go, this pays the latency of a global
+ * collective only once, and the reduction can overlap with local work in between.
+ *
+ * Like for any other collective operation, all processes need to add the same
+ * sequence of operations.
+ */
+class PackedAllReduce
+{
+public:
+    enum class Operation { Max, Min, Sum };
+
+    explicit PackedAllReduce(typename Dune::MPIHelper::MPICommunicator comm)
+        : comm_(comm)
+        , pending_(false)
+        , numReductions_(0)
+        , numValuesReduced_(0)
+    {
+#if HAVE_MPI
+        request_ = MPI_REQUEST_NULL;
+#endif
+    }
+
+    ~PackedAllReduce()
+    { finish(); }
+
+    /*!
+     * \brief Add a value to be reduced and return its slot index.
+     */
+    unsigned add(double value, Operation op)
+    {
+        assert(!pending_);
+        buffer_.push_back(static_cast<double>(op));
+        buffer_.push_back(value);
+        return static_cast<unsigned>(buffer_.size()/2 - 1);
+    }
+
+    /*!
+     * \brief Add a flag which needs to be true on all processes.
+     */
+    unsigned addSuccessFlag(bool succeeded)
+    {
+        unsigned slot = add(succeeded ? 1.0 : 0.0, Operation::Min);
+        flagSlots_.push_back(slot);
+        return slot;
+    }
+
+    /*!
+     * \brief Initiate the reduction of all values added so far.
+     */
+    void start()
+    {
+        assert(!pending_);
+        if (buffer_.empty())
+            return;
+
+        pending_ = true;
+        ++numReductions_;
+        numValuesReduced_ += buffer_.size()/2;
+
+#if HAVE_MPI
+        int isInitialized;
+        MPI_Initialized(&isInitialized);
+        if (isInitialized) {
+            MPI_Iallreduce(MPI_IN_PLACE,
+                           buffer_.data(),
+                           static_cast<int>(buffer_.size()/2),
+                           pairType_(),
+                           reduceOp_(),
+                           comm_,
+                           &request_);
+        }
+#endif // HAVE_MPI
+    }
+
+    /*!
+     * \brief Wait until the reduction is complete.
+     *
+     * This is a no-op if no reduction is pending.
+     */
+    void finish()
+    {
+        if (!pending_)
+            return;
+
+        waitTimer_.start();
+#if HAVE_MPI
+        if (request_ != MPI_REQUEST_NULL)
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+#endif // HAVE_MPI
+        waitTimer_.stop();
+
+        pending_ = false;
+    }
+
+    /*!
+     * \brief Drop all values so that a new set of values can be added.
+     */
+    void clear()
+    {
+        finish();
+        buffer_.clear();
+        flagSlots_.clear();
+    }
+
+    /*!
+     * \brief Returns true iff a reduction has been started but not finished yet.
+     */
+    bool pending() const
+    { return pending_; }
+
+    /*!
+     * \brief Returns true iff no values have been added since the last clear().
+     */
+    bool empty() const
+    { return buffer_.empty(); }
+
+    /*!
+     * \brief Returns the reduced value of a slot.
+     *
+     * This is only valid after finish() has been called.
+     */
+    double result(unsigned slotIdx) const
+    {
+        assert(!pending_);
+        return buffer_[2*slotIdx + 1];
+    }
+
+    /*!
+     * \brief Returns true iff all flags added via addSuccessFlag() were true on all
+     *        processes.
+     */
+    bool allSucceeded() const
+    {
+        return std::all_of(flagSlots_.begin(), flagSlots_.end(),
+                           [this](unsigned slot) { return result(slot) > 0.5; });
+    }
+
+    /*!
+     * \brief Returns the number of global reductions done so far.
+     */
+    unsigned numReductions() const
+    { return numReductions_; }
+
+    /*!
+     * \brief Returns the number of values which were reduced so far.
+     *
+     * Without packing, each of these would have required a separate global reduction.
+     */
+    unsigned numValuesReduced() const
+    { return numValuesReduced_; }
+
+    /*!
+     * \brief Returns the timer for the time spent waiting for reductions to finish.
+     */
+    const Timer& waitTimer() const
+    { return waitTimer_; }
+
+private:
+#if HAVE_MPI
+    // reduce (operation, value) pairs. the operation is left unchanged.
+    static void reducePairs_(void* in, void* inout, int* len, MPI_Datatype*)
+    {
+        const double* src = static_cast<const double*>(in);
+        double* dst = static_cast<double*>(inout);
+        for (int i = 0; i < *len; ++i) {
+            const double a = src[2*i + 1];
+            double& b = dst[2*i + 1];
+            switch (static_cast<Operation>(static_cast<int>(dst[2*i]))) {
+            case Operation::Max: b = std::max(a, b); break;
+            case Operation::Min: b = std::min(a, b); break;
+            case Operation::Sum: b += a; break;
+            }
+        }
+    }
+
+    static MPI_Datatype pairType_()
+    {
+        static MPI_Datatype type = [] {
+            MPI_Datatype t;
+            MPI_Type_contiguous(2, MPI_DOUBLE, &t);
+            MPI_Type_commit(&t);
+            return t;
+        }();
+        return type;
+    }
+
+    static MPI_Op reduceOp_()
+    {
+        static MPI_Op op = [] {
+            MPI_Op o;
+            MPI_Op_create(&reducePairs_, /*commute=*/1, &o);
+            return o;
+        }();
+        return op;
+    }
+
+    MPI_Request request_;
+#endif // HAVE_MPI
+
+    typename Dune::MPIHelper::MPICommunicator comm_;
+    std::vector<double> buffer_;
+    std::vector<unsigned> flagSlots_;
+    bool pending_;
+    Timer waitTimer_;
+    unsigned numReductions_;
+    unsigned numValuesReduced_;
+};
+
+} // namespace Opm
+
+#endif
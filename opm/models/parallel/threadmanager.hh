@@ -32,6 +32,7 @@
 #endif
 
 #include <opm/models/discretization/common/fvbaseparameters.hh>
+#include <opm/models/parallel/numaplacement.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/propertysystem.hh>
 
@@ -63,6 +64,12 @@ public:
         Parameters::Register<Parameters::ThreadsPerProcess>
             ("The maximum number of threads to be instantiated per process "
              "('-1' means 'automatic')");
+        Parameters::Register<Parameters::PinThreads>
+            ("Bind each thread to one of the CPUs of the process, offset by the "
+             "node-local MPI rank");
+        Parameters::Register<Parameters::NumaAwareInitialization>
+            ("Place the pages of the large arrays on the NUMA nodes of the threads "
+             "which process them and report the amount of memory on each node");
     }
 
     /*!
@@ -72,7 +79,8 @@ public:
      *        and if set (disregard the environment variable OPM_NUM_THREADS).
      *        If false we will assume that the number of OpenMP threads is already set
      *        outside of this function (e.g. by OPM_NUM_THREADS or in the simulator by
-     *        the ThreadsPerProcess parameter).
+     *        the ThreadsPerProcess parameter). The threads are then neither
+     *        pinned nor is the NUMA aware initialization enabled.
      */
     static void init(bool queryCommandLineParameter = true)
     {
@@ -110,6 +118,12 @@ public:
         // get the number of threads which are used in the end.
         numThreads_ = omp_get_max_threads();
 #endif
+
+        if (queryCommandLineParameter) {
+            if (Parameters::Get<Parameters::PinThreads>())
+                NumaPlacement::pinThreads();
+            NumaPlacement::setEnabled(Parameters::Get<Parameters::NumaAwareInitialization>());
+        }
     }
 
     /*!
@@ -240,7 +240,7 @@ public:
         /////////////
         // Compute rel. perm and viscosity and densities
         /////////////
-        const MaterialLawParams& materialParams = problem.materialLawParams(elemCtx, dofIdx, timeIdx);
+        const MaterialLawParams& materialParams = problem.cachedMaterialLawParams(elemCtx, dofIdx, timeIdx);
 
         // calculate relative permeability
         MaterialLaw::relativePermeabilities(relativePermeability_,
@@ -267,11 +267,11 @@ public:
         /////////////
 
         // porosity
-        porosity_ = problem.porosity(elemCtx, dofIdx, timeIdx);
+        porosity_ = problem.cachedPorosity(elemCtx, dofIdx, timeIdx);
         Opm::Valgrind::CheckDefined(porosity_);
 
         // intrinsic permeability
-        intrinsicPerm_ = problem.intrinsicPermeability(elemCtx, dofIdx, timeIdx);
+        intrinsicPerm_ = problem.cachedIntrinsicPermeability(elemCtx, dofIdx, timeIdx);
 
         // update the quantities specific for the velocity model
         FluxIntensiveQuantities::update_(elemCtx, dofIdx, timeIdx);
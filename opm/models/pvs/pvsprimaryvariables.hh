@@ -35,6 +35,7 @@
 
 #include <opm/models/discretization/common/fvbaseprimaryvariables.hh>
 #include <opm/models/common/energymodule.hh>
+#include <opm/models/utils/allocationaudit.hh>
 
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
@@ -303,8 +304,10 @@ public:
         }
 
         // some phase must be present
-        if (phasePresence_ == 0)
+        if (phasePresence_ == 0) {
+            AllocationAudit::SuspendGuard suspendAudit;
             throw NumericalProblem("Phase state was 0, i.e., no fluid is present");
+        }
 
         // set the primary variables which correspond to mole
         // fractions of the present phase which has the lowest index.
@@ -94,7 +94,7 @@ public:
         // material law parameters
         const auto& problem = elemCtx.problem();
         const typename MaterialLaw::Params& materialParams =
-            problem.materialLawParams(elemCtx, dofIdx, timeIdx);
+            problem.cachedMaterialLawParams(elemCtx, dofIdx, timeIdx);
         const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
 
         /////////
@@ -147,10 +147,10 @@ public:
             mobility_[phaseIdx] = relativePermeability_[phaseIdx]/fluidState_.viscosity(phaseIdx);
 
         // porosity
-        porosity_ = problem.porosity(elemCtx, dofIdx, timeIdx);
+        porosity_ = problem.cachedPorosity(elemCtx, dofIdx, timeIdx);
 
         // intrinsic permeability
-        intrinsicPerm_ = problem.intrinsicPermeability(elemCtx, dofIdx, timeIdx);
+        intrinsicPerm_ = problem.cachedIntrinsicPermeability(elemCtx, dofIdx, timeIdx);
 
         // update the quantities specific for the velocity model
         FluxIntensiveQuantities::update_(elemCtx, dofIdx, timeIdx);
@@ -0,0 +1,349 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::AllocationAudit
+ */
+#ifndef EWOMS_ALLOCATION_AUDIT_HH
+#define EWOMS_ALLOCATION_AUDIT_HH
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+class NoAllocationRegion;
+
+/*!
+ * \ingroup Common
+ *
+ * \brief Counts the heap allocations which happen inside of "no-allocation regions".
+ *
+ * The code paths which are executed for every degree of freedom or face, e.g., the
+ * linearization, the update of the intensive quantities and the update of the
+ * primary variables in the Newton method, are marked using NoAllocationRegion
+ * objects. If the audit is enabled, all heap allocations which happen while such a
+ * region is active on the current thread are attributed to it, including the
+ * addresses of the code which requested them.
+ *
+ * The allocations are only seen if the global operator new is replaced by the one of
+ * allocationauditoperators.hh, which must thus be included by exactly one translation
+ * unit of the program. Without it, or if the audit is disabled, the regions do
+ * nothing except for checking a flag.
+ *
+ * In strict mode, the first allocation inside a region aborts the program. This is
+ * intended for test runs which ensure that no allocations creep into the kernels.
+ */
+class AllocationAudit
+{
+public:
+    enum class Mode { disabled, report, strict };
+
+    //! The maximum number of distinct call sites which are recorded per region
+    static constexpr std::size_t maxCallSites = 16;
+
+    struct RegionStatistics
+    {
+        std::size_t numAllocations = 0;
+        std::size_t numBytes = 0;
+        //! the number of allocations for each call site
+        std::map<const void*, std::size_t> callSites;
+        //! the number of allocations whose call site was not recorded
+        std::size_t numUnrecordedCallSites = 0;
+    };
+
+    /*!
+     * \brief Parse the mode of the audit from a string.
+     *
+     * The supported values are "none", "report" and "strict".
+     */
+    static Mode parseMode(const std::string& mode)
+    {
+        if (mode == "report")
+            return Mode::report;
+        else if (mode == "strict")
+            return Mode::strict;
+        else if (mode == "none" || mode.empty())
+            return Mode::disabled;
+
+        throw std::invalid_argument("Unknown allocation audit mode '" + mode + "'");
+    }
+
+    static void setMode(Mode mode)
+    { mode_.store(mode, std::memory_order_relaxed); }
+
+    static Mode mode()
+    { return mode_.load(std::memory_order_relaxed); }
+
+    static bool enabled()
+    { return mode() != Mode::disabled; }
+
+    /*!
+     * \brief Returns true if the global operator new reports the allocations to the
+     *        audit, i.e., if the program includes allocationauditoperators.hh.
+     */
+    static bool operatorsInstalled()
+    { return operatorsInstalled_.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Called by allocationauditoperators.hh when the program is initialized.
+     */
+    static void setOperatorsInstalled()
+    { operatorsInstalled_.store(true, std::memory_order_relaxed); }
+
+    /*!
+     * \brief Attribute an allocation to the region which is active on the current
+     *        thread.
+     *
+     * This is called by the replaced operator new and thus must not allocate itself.
+     */
+    static inline void recordAllocation(std::size_t size, const void* callSite) noexcept;
+
+    /*!
+     * \brief Returns the statistics of all regions which saw allocations so far.
+     */
+    static std::map<std::string, RegionStatistics> statistics()
+    {
+        SuspendGuard suspend;
+        std::lock_guard<std::mutex> lock(registry_().mutex);
+        return registry_().regions;
+    }
+
+    /*!
+     * \brief Forget about the allocations which were recorded so far.
+     */
+    static void reset()
+    {
+        SuspendGuard suspend;
+        std::lock_guard<std::mutex> lock(registry_().mutex);
+        registry_().regions.clear();
+    }
+
+    /*!
+     * \brief Print the allocations of each region and their call sites.
+     *
+     * The call sites are the return addresses of operator new. They can be mapped to
+     * source locations using, e.g., addr2line.
+     */
+    static void report(std::ostream& os)
+    {
+        const auto regions = statistics();
+
+        SuspendGuard suspend;
+        if (!operatorsInstalled()) {
+            os << "Heap allocations could not be audited because the global operator new "
+               << "was not replaced (see allocationauditoperators.hh)\n";
+            return;
+        }
+
+        if (regions.empty()) {
+            os << "No heap allocations inside of no-allocation regions\n";
+            return;
+        }
+
+        os << "Heap allocations inside of no-allocation regions:\n";
+        for (const auto& [name, stats] : regions) {
+            os << "  " << name << ": " << stats.numAllocations << " allocations, "
+               << stats.numBytes << " bytes\n";
+
+            std::vector<std::pair<const void*, std::size_t>> callSites(stats.callSites.begin(),
+                                                                       stats.callSites.end());
+            std::sort(callSites.begin(), callSites.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+            for (const auto& [callSite, count] : callSites)
+                os << "    " << callSite << ": " << count << "\n";
+            if (stats.numUnrecordedCallSites > 0)
+                os << "    (other call sites): " << stats.numUnrecordedCallSites << "\n";
+        }
+    }
+
+    /*!
+     * \brief Suspends recording the allocations of the current thread while the object
+     *        is alive.
+     *
+     * This is used for allocations which are expected even inside of no-allocation
+     * regions, e.g., for the message of an exception which is thrown by a kernel:
+     *
+     * \code
+     * if (!isfinite(x)) {
+     *     AllocationAudit::SuspendGuard suspendAudit;
+     *     throw NumericalProblem("x is " + std::to_string(x));
+     * }
+     * \endcode
+     */
+    class SuspendGuard
+    {
+    public:
+        SuspendGuard()
+            : wasSuspended_(suspended_)
+        { suspended_ = true; }
+
+        SuspendGuard(const SuspendGuard&) = delete;
+        SuspendGuard& operator=(const SuspendGuard&) = delete;
+
+        ~SuspendGuard()
+        { suspended_ = wasSuspended_; }
+
+    private:
+        bool wasSuspended_;
+    };
+
+private:
+    friend class NoAllocationRegion;
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::map<std::string, RegionStatistics> regions;
+    };
+
+    static Registry& registry_()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    static inline std::atomic<Mode> mode_{Mode::disabled};
+    static inline std::atomic<bool> operatorsInstalled_{false};
+    static inline thread_local NoAllocationRegion* currentRegion_ = nullptr;
+    static inline thread_local bool suspended_ = false;
+};
+
+/*!
+ * \ingroup Common
+ *
+ * \brief Marks a scope in which no heap allocations are expected.
+ *
+ * Regions can be nested; allocations are attributed to the innermost region of the
+ * current thread. The region has no effect unless the allocation audit is enabled
+ * when it is entered.
+ */
+class NoAllocationRegion
+{
+public:
+    explicit NoAllocationRegion(const char* name)
+        : name_(name)
+        , active_(AllocationAudit::enabled())
+    {
+        if (active_) {
+            parent_ = AllocationAudit::currentRegion_;
+            AllocationAudit::currentRegion_ = this;
+        }
+    }
+
+    NoAllocationRegion(const NoAllocationRegion&) = delete;
+    NoAllocationRegion& operator=(const NoAllocationRegion&) = delete;
+
+    ~NoAllocationRegion()
+    {
+        if (!active_)
+            return;
+
+        AllocationAudit::currentRegion_ = parent_;
+        if (numAllocations_ == 0)
+            return;
+
+        AllocationAudit::SuspendGuard suspend;
+        auto& registry = AllocationAudit::registry_();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto& stats = registry.regions[name_];
+        stats.numAllocations += numAllocations_;
+        stats.numBytes += numBytes_;
+        stats.numUnrecordedCallSites += numUnrecordedCallSites_;
+        for (std::size_t i = 0; i < numCallSites_; ++i)
+            stats.callSites[callSites_[i].address] += callSites_[i].count;
+    }
+
+    const char* name() const
+    { return name_; }
+
+    std::size_t numAllocations() const
+    { return numAllocations_; }
+
+private:
+    friend class AllocationAudit;
+
+    void record_(std::size_t size, const void* callSite) noexcept
+    {
+        ++numAllocations_;
+        numBytes_ += size;
+
+        for (std::size_t i = 0; i < numCallSites_; ++i) {
+            if (callSites_[i].address == callSite) {
+                ++callSites_[i].count;
+                return;
+            }
+        }
+
+        if (numCallSites_ < callSites_.size())
+            callSites_[numCallSites_++] = {callSite, 1};
+        else
+            ++numUnrecordedCallSites_;
+    }
+
+    const char* name_;
+    bool active_;
+    NoAllocationRegion* parent_ = nullptr;
+
+    std::size_t numAllocations_ = 0;
+    std::size_t numBytes_ = 0;
+    // left uninitialized, so that entering a region is cheap. only the first
+    // numCallSites_ entries are valid.
+    struct CallSite { const void* address; std::size_t count; };
+    std::array<CallSite, AllocationAudit::maxCallSites> callSites_;
+    std::size_t numCallSites_ = 0;
+    std::size_t numUnrecordedCallSites_ = 0;
+};
+
+inline void AllocationAudit::recordAllocation(std::size_t size, const void* callSite) noexcept
+{
+    NoAllocationRegion* region = currentRegion_;
+    if (!region || suspended_)
+        return;
+
+    if (mode() == Mode::strict) {
+        // do not use iostreams here: they might allocate
+        std::fprintf(stderr,
+                     "Heap allocation of %zu bytes at %p inside of no-allocation region '%s'\n",
+                     size, callSite, region->name());
+        std::abort();
+    }
+
+    region->record_(size, callSite);
+}
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,150 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Replaces the global operator new and operator delete by versions which
+ *        report the allocations to Opm::AllocationAudit.
+ *
+ * Since the replacement operators are defined in the global namespace, this file must
+ * be included by exactly one translation unit of a program, usually the one which
+ * contains main().
+ */
+#ifndef EWOMS_ALLOCATION_AUDIT_OPERATORS_HH
+#define EWOMS_ALLOCATION_AUDIT_OPERATORS_HH
+
+#include <opm/models/utils/allocationaudit.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__)
+#define EWOMS_ALLOCATION_CALL_SITE __builtin_return_address(0)
+#else
+#define EWOMS_ALLOCATION_CALL_SITE nullptr
+#endif
+
+namespace Opm::detail {
+
+inline void* auditedAllocate(std::size_t size, const void* callSite)
+{
+    AllocationAudit::recordAllocation(size, callSite);
+
+    if (size == 0)
+        size = 1;
+    for (;;) {
+        if (void* ptr = std::malloc(size))
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void* auditedAllocate(std::size_t size, std::align_val_t alignment, const void* callSite)
+{
+    AllocationAudit::recordAllocation(size, callSite);
+
+    // aligned_alloc() requires the size to be a multiple of the alignment
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    size = std::max<std::size_t>(align, (size + align - 1)/align*align);
+    for (;;) {
+        if (void* ptr = std::aligned_alloc(align, size))
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+// tell the audit that the allocations are seen when the program is initialized
+[[maybe_unused]] static const bool auditedOperatorsInstalled =
+    (AllocationAudit::setOperatorsInstalled(), true);
+
+} // namespace Opm::detail
+
+void* operator new(std::size_t size)
+{ return Opm::detail::auditedAllocate(size, EWOMS_ALLOCATION_CALL_SITE); }
+
+void* operator new[](std::size_t size)
+{ return Opm::detail::auditedAllocate(size, EWOMS_ALLOCATION_CALL_SITE); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{ return Opm::detail::auditedAllocate(size, alignment, EWOMS_ALLOCATION_CALL_SITE); }
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{ return Opm::detail::auditedAllocate(size, alignment, EWOMS_ALLOCATION_CALL_SITE); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return Opm::detail::auditedAllocate(size, EWOMS_ALLOCATION_CALL_SITE);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return Opm::detail::auditedAllocate(size, EWOMS_ALLOCATION_CALL_SITE);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+#undef EWOMS_ALLOCATION_CALL_SITE
+
+#endif
@@ -30,6 +30,16 @@
 
 namespace Opm::Parameters {
 
+/*!
+ * \brief Audit the heap allocations inside of the per-element and per-degree of
+ *        freedom kernels?
+ *
+ * "none" disables the audit, "report" prints the allocations at the end of the run and
+ * "strict" aborts at the first allocation. This requires the program to include
+ * allocationauditoperators.hh.
+ */
+struct AllocationAuditMode { static constexpr auto value = "none"; };
+
 //! grid resolution
 struct CellsX { static constexpr unsigned value = 1; };
 struct CellsY { static constexpr unsigned value = 1; };
@@ -654,20 +654,35 @@ public:
             // try to restart a previous simulation
             time_ = restartTime;
 
+            Timer deserializeTimer;
+            Timer modelDeserializeTimer;
+            deserializeTimer.start();
+
             Restart res;
+            res.setParallelDeserialization(model_->enableParallelStartup());
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeBegin(*this, time_));
             if (verbose_)
                 std::cout << "Deserialize from file '" << res.fileName() << "'\n" << std::flush;
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(this->deserialize(res));
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->deserialize(res));
+            modelDeserializeTimer.start();
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->deserialize(res));
+            modelDeserializeTimer.stop();
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeEnd());
-            if (verbose_)
+
+            deserializeTimer.stop();
+            if (verbose_) {
                 std::cout << "Deserialization done."
                           << " Simulator time: " << time() << humanReadableTime(time())
                           << " Time step index: " << timeStepIndex()
                           << " Episode index: " << episodeIndex()
                           << "\n" << std::flush;
+                std::cout << "Deserialization took " << deserializeTimer.realTimeElapsed() << " seconds"
+                          << " (model: " << modelDeserializeTimer.realTimeElapsed() << " seconds,"
+                          << " reading entities: " << res.entityReadTime() << " seconds,"
+                          << " decoding entities: " << res.entityDecodeTime() << " seconds)\n"
+                          << std::flush;
+            }
         }
         else {
             // if no restart is done, apply the initial solution
@@ -680,11 +695,24 @@ public:
             timeStepSize_ = 0.0;
             timeStepIdx_ = -1;
 
+            Timer initialSolutionTimer;
+            initialSolutionTimer.start();
             EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->applyInitialSolution());
+            initialSolutionTimer.stop();
 
             // write initial condition
+            Timer initialOutputTimer;
+            initialOutputTimer.start();
             if (problem_->shouldWriteOutput())
                 EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->writeOutput());
+            initialOutputTimer.stop();
+
+            if (verbose_)
+                std::cout << "Initial solution applied in "
+                          << initialSolutionTimer.realTimeElapsed() << " seconds,"
+                          << " initial output written in "
+                          << initialOutputTimer.realTimeElapsed() << " seconds\n"
+                          << std::flush;
 
             timeStepSize_ = oldTimeStepSize;
             timeStepIdx_ = oldTimeStepIdx;
@@ -34,6 +34,8 @@
 
 #include "parametersystem.hh"
 
+#include <opm/models/parallel/numaplacement.hh>
+#include <opm/models/utils/allocationaudit.hh>
 #include <opm/models/utils/simulator.hh>
 #include <opm/models/utils/timer.hh>
 
@@ -53,6 +55,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <locale>
 
@@ -78,6 +81,10 @@ static inline void registerAllParameters_(bool finalizeRegistration = true)
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
 
+    Parameters::Register<Parameters::AllocationAuditMode>
+        ("Audit the heap allocations in the kernels of the simulator: 'none', "
+         "'report' to print them at the end of the run, or 'strict' to abort at "
+         "the first one");
     Parameters::Register<Parameters::ParameterFile>
         ("An .ini file which contains a set of run-time parameters");
     Parameters::Register<Parameters::PrintParameters>
@@ -306,6 +313,11 @@ static inline int start(int argc, char **argv,  bool registerParams=true)
 
         ThreadManager::init();
 
+        AllocationAudit::setMode(AllocationAudit::parseMode(Parameters::Get<Parameters::AllocationAuditMode>()));
+        if (AllocationAudit::enabled() && !AllocationAudit::operatorsInstalled())
+            throw std::invalid_argument("Auditing the heap allocations requires a simulator "
+                                        "which includes allocationauditoperators.hh");
+
         // initialize MPI, finalize is done automatically on exit
 #if HAVE_DUNE_FEM
         Dune::Fem::MPIManager::initialize(argc, argv);
@@ -380,6 +392,12 @@ static inline int start(int argc, char **argv,  bool registerParams=true)
         Simulator simulator;
         simulator.run();
 
+        if (AllocationAudit::enabled() && myRank == 0)
+            AllocationAudit::report(std::cout);
+
+        if (NumaPlacement::enabled() && myRank == 0)
+            NumaPlacement::report(std::cout);
+
         if (myRank == 0) {
             std::cout << "Simulation completed" << std::endl;                                 
         }
@@ -0,0 +1,197 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::UniformXTabulated2DFunctionBundle
+ */
+#ifndef EWOMS_TABULATED_2D_FUNCTION_BUNDLE_HH
+#define EWOMS_TABULATED_2D_FUNCTION_BUNDLE_HH
+
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A set of two-dimensional tabulated functions which are sampled at the same
+ *        points and are always evaluated at the same position.
+ *
+ * This is equivalent to a std::array of UniformXTabulated2DFunction objects which use
+ * the same sampling points, but the values of all functions are stored next to each
+ * other for each sampling point. Evaluating the bundle thus only requires to search the
+ * intervals and to compute the interpolation weights (including their derivatives if
+ * Evaluation is an automatic differentiation type) once for all functions.
+ *
+ * The vertical and the left-extreme interpolation policies of
+ * UniformXTabulated2DFunction are supported.
+ */
+template <class Scalar, std::size_t numFunctions>
+class UniformXTabulated2DFunctionBundle
+{
+public:
+    using InterpolationPolicy = typename UniformXTabulated2DFunction<Scalar>::InterpolationPolicy;
+    using Values = std::array<Scalar, numFunctions>;
+
+    explicit UniformXTabulated2DFunctionBundle(InterpolationPolicy interpolationGuide = InterpolationPolicy::Vertical)
+        : interpolationGuide_(interpolationGuide)
+    {
+        if (interpolationGuide_ == InterpolationPolicy::RightExtreme)
+            throw std::invalid_argument("Tabulated function bundles do not support the "
+                                        "right-extreme interpolation policy");
+    }
+
+    /*!
+     * \brief Returns the number of sampling points on the x-axis.
+     */
+    std::size_t numX() const
+    { return xPos_.size(); }
+
+    /*!
+     * \brief Returns the number of sampling points on the y-axis for a given x-position.
+     */
+    std::size_t numY(std::size_t i) const
+    { return yPos_[i].size(); }
+
+    /*!
+     * \brief Set the x-position of the next column of sampling points.
+     *
+     * The x-positions must be appended in ascending order.
+     */
+    std::size_t appendXPos(Scalar x)
+    {
+        assert(xPos_.empty() || xPos_.back() < x);
+        xPos_.push_back(x);
+        yPos_.emplace_back();
+        values_.emplace_back();
+        return xPos_.size() - 1;
+    }
+
+    /*!
+     * \brief Append a sampling point with the values of all functions to a column.
+     *
+     * The y-positions of each column must be appended in ascending order.
+     */
+    std::size_t appendSamplePoint(std::size_t i, Scalar y, const Values& values)
+    {
+        assert(i < numX());
+        assert(yPos_[i].empty() || yPos_[i].back() < y);
+        yPos_[i].push_back(y);
+        values_[i].push_back(values);
+        return yPos_[i].size() - 1;
+    }
+
+    /*!
+     * \brief Evaluate all functions at a given position.
+     *
+     * If extrapolate is true, the functions are extrapolated linearly using the
+     * outermost intervals, else the position must be within the tabulated range.
+     */
+    template <class Evaluation>
+    std::array<Evaluation, numFunctions> eval(const Evaluation& x,
+                                              const Evaluation& y,
+                                              bool extrapolate = false) const
+    {
+        const unsigned i = segmentIndex_(xPos_, x, extrapolate);
+        const Evaluation alpha = (x - xPos_[i])/(xPos_[i + 1] - xPos_[i]);
+
+        // with the left-extreme policy, the interpolation follows the line which
+        // connects the smallest y-positions of the two columns
+        Evaluation yEval1 = y;
+        Evaluation yEval2 = y;
+        if (interpolationGuide_ == InterpolationPolicy::LeftExtreme) {
+            const Scalar shift = yPos_[i + 1].front() - yPos_[i].front();
+            yEval1 -= alpha*shift;
+            yEval2 += (1.0 - alpha)*shift;
+        }
+
+        const auto& y1 = yPos_[i];
+        const auto& y2 = yPos_[i + 1];
+        const unsigned j1 = segmentIndex_(y1, yEval1, extrapolate);
+        const unsigned j2 = segmentIndex_(y2, yEval2, extrapolate);
+        const Evaluation beta1 = (yEval1 - y1[j1])/(y1[j1 + 1] - y1[j1]);
+        const Evaluation beta2 = (yEval2 - y2[j2])/(y2[j2 + 1] - y2[j2]);
+
+        // the weights of the four sampling points which enclose the position
+        const Evaluation w11 = (1.0 - alpha)*(1.0 - beta1);
+        const Evaluation w12 = (1.0 - alpha)*beta1;
+        const Evaluation w21 = alpha*(1.0 - beta2);
+        const Evaluation w22 = alpha*beta2;
+
+        const Values& v11 = values_[i][j1];
+        const Values& v12 = values_[i][j1 + 1];
+        const Values& v21 = values_[i + 1][j2];
+        const Values& v22 = values_[i + 1][j2 + 1];
+
+        std::array<Evaluation, numFunctions> result;
+        for (std::size_t funcIdx = 0; funcIdx < numFunctions; ++funcIdx)
+            result[funcIdx] =
+                w11*v11[funcIdx] + w12*v12[funcIdx] + w21*v21[funcIdx] + w22*v22[funcIdx];
+
+        return result;
+    }
+
+private:
+    // returns the index of the interval of a sorted array of sampling points which
+    // contains a given position
+    template <class Evaluation>
+    static unsigned segmentIndex_(const std::vector<Scalar>& samples,
+                                  const Evaluation& pos,
+                                  [[maybe_unused]] bool extrapolate)
+    {
+        assert(samples.size() >= 2);
+        assert(extrapolate || (samples.front() <= pos && pos <= samples.back()));
+
+        const std::size_t n = samples.size();
+        if (pos <= samples[1])
+            return 0;
+        if (pos >= samples[n - 2])
+            return static_cast<unsigned>(n - 2);
+
+        // bisection on the interior intervals
+        std::size_t lowerIdx = 1;
+        std::size_t upperIdx = n - 2;
+        while (lowerIdx + 1 < upperIdx) {
+            const std::size_t pivotIdx = (lowerIdx + upperIdx)/2;
+            if (pos < samples[pivotIdx])
+                upperIdx = pivotIdx;
+            else
+                lowerIdx = pivotIdx;
+        }
+
+        return static_cast<unsigned>(lowerIdx);
+    }
+
+    std::vector<Scalar> xPos_;
+    std::vector<std::vector<Scalar>> yPos_;
+    std::vector<std::vector<Values>> values_;
+    InterpolationPolicy interpolationGuide_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,171 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Controllers which determine the size of the next time step.
+ */
+#ifndef EWOMS_TIME_STEP_CONTROLLER_HH
+#define EWOMS_TIME_STEP_CONTROLLER_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Opm {
+
+/*!
+ * \ingroup Common
+ *
+ * \brief The base class for all time step controllers.
+ *
+ * A time step controller is asked for the size of the next time step after each
+ * successful time integration.
+ */
+template <class Scalar>
+class BaseTimeStepController
+{
+public:
+    virtual ~BaseTimeStepController() = default;
+
+    /*!
+     * \brief Returns true iff the controller needs the relative change of the solution
+     *        over a time step.
+     *
+     * Computing this quantity requires a global reduction, so it is only done if the
+     * controller actually uses it.
+     */
+    virtual bool needRelativeChange() const
+    { return false; }
+
+    /*!
+     * \brief Returns the suggested size of the next time step.
+     *
+     * \param dt The size of the time step which has just been completed [s]
+     * \param numIterations The number of Newton iterations required by the time step
+     * \param relativeChange The relative change of the solution over the time step. This
+     *                       is only meaningful if needRelativeChange() returns true.
+     */
+    virtual Scalar suggestTimeStepSize(Scalar dt,
+                                       int numIterations,
+                                       Scalar relativeChange) = 0;
+};
+
+/*!
+ * \ingroup Common
+ *
+ * \brief A time step controller which targets a given number of Newton iterations.
+ *
+ * If the time step required more iterations than the target, the time step size is
+ * reduced by a constant factor, if it required less, it is increased by another one.
+ */
+template <class Scalar>
+class IterationCountTimeStepController : public BaseTimeStepController<Scalar>
+{
+public:
+    IterationCountTimeStepController(int targetIterations,
+                                     Scalar decayRate,
+                                     Scalar growthRate)
+        : targetIterations_(targetIterations)
+        , decayRate_(decayRate)
+        , growthRate_(growthRate)
+    { }
+
+    Scalar suggestTimeStepSize(Scalar dt,
+                               int numIterations,
+                               Scalar /*relativeChange*/) override
+    {
+        if (numIterations > targetIterations_)
+            return dt*decayRate_;
+        else if (numIterations < targetIterations_)
+            return dt*growthRate_;
+        return dt;
+    }
+
+private:
+    int targetIterations_;
+    Scalar decayRate_;
+    Scalar growthRate_;
+};
+
+/*!
+ * \ingroup Common
+ *
+ * \brief A PID time step controller which targets a given relative change of the
+ *        solution per time step.
+ *
+ * The controller uses the relative changes of the last three time steps. If the most
+ * recent change is larger than the tolerance, the time step size is scaled down
+ * proportionally. For details, see
+ *
+ * G. Söderlind: "Automatic Control and Adaptive Time-Stepping", Numerical
+ * Algorithms 31, pp 281-310, 2002
+ */
+template <class Scalar>
+class PidTimeStepController : public BaseTimeStepController<Scalar>
+{
+public:
+    PidTimeStepController(Scalar tolerance, Scalar growthRate)
+        : tolerance_(tolerance)
+        , growthRate_(growthRate)
+    { errors_.fill(tolerance); }
+
+    bool needRelativeChange() const override
+    { return true; }
+
+    Scalar suggestTimeStepSize(Scalar dt,
+                               int /*numIterations*/,
+                               Scalar relativeChange) override
+    {
+        // avoid divisions by zero if the solution did not change at all
+        const Scalar minError = tolerance_*std::numeric_limits<Scalar>::epsilon();
+
+        errors_[0] = errors_[1];
+        errors_[1] = errors_[2];
+        errors_[2] = std::max(relativeChange, minError);
+
+        if (errors_[2] > tolerance_)
+            return dt*tolerance_/errors_[2];
+
+        // the gains of the proportional, integral and derivative parts
+        const Scalar kP = 0.075;
+        const Scalar kI = 0.175;
+        const Scalar kD = 0.01;
+        const Scalar factor =
+            std::pow(errors_[1]/errors_[2], kP)
+            * std::pow(tolerance_/errors_[2], kI)
+            * std::pow(errors_[0]*errors_[0]/(errors_[1]*errors_[2]), kD);
+
+        return dt*std::min(factor, growthRate_);
+    }
+
+private:
+    Scalar tolerance_;
+    Scalar growthRate_;
+    std::array<Scalar, 3> errors_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,272 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::CprPreconditioner
+ */
+#ifndef EWOMS_CPR_PRECONDITIONER_HH
+#define EWOMS_CPR_PRECONDITIONER_HH
+
+#include <opm/simulators/linalg/ilufirstelement.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace Opm::Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief A sequential two-stage constrained pressure residual (CPR) preconditioner.
+ *
+ * The first stage restricts the residual to a scalar pressure equation using a
+ * weighted sum of the mass conservation equations of each degree of freedom and
+ * solves it approximately using one cycle of algebraic multi-grid. The second stage
+ * applies an ILU(0) preconditioner of the full block system to the residual which
+ * remains after the pressure correction.
+ *
+ * The weights of the equations are supplied by the user of the class, e.g. using
+ * the quasi-IMPES or the true-IMPES approach. For details, see
+ *
+ * J. R. Wallis: "Incomplete Gaussian Elimination as a Preconditioning for
+ * Generalized Conjugate Gradient Acceleration", SPE 12265, 1983
+ */
+template <class Matrix, class Vector>
+class CprPreconditioner : public Dune::Preconditioner<Vector, Vector>
+{
+    using field_type = typename Vector::field_type;
+    static constexpr int numEq = Vector::block_type::dimension;
+
+public:
+    using domain_type = Vector;
+    using range_type = Vector;
+
+    using WeightVector = Dune::BlockVector<Dune::FieldVector<field_type, numEq> >;
+
+private:
+    using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<field_type, 1, 1> >;
+    using PressureVector = Dune::BlockVector<Dune::FieldVector<field_type, 1> >;
+    using PressureOperator = Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector>;
+    using PressureSmoother = Dune::SeqSOR<PressureMatrix, PressureVector, PressureVector>;
+    using PressureAmg = Dune::Amg::AMG<PressureOperator, PressureVector, PressureSmoother>;
+    using Ilu = Dune::SeqILU<Matrix, Vector, Vector>;
+
+public:
+    /*!
+     * \brief Create the preconditioner.
+     *
+     * \param matrix The matrix of the full system. It must stay alive as long as the
+     *               preconditioner is used.
+     * \param weights The weights of the equations of each degree of freedom which
+     *                define the pressure equation.
+     * \param pressureIdx The index of the primary variable which represents pressure.
+     * \param coarsenTarget The number of unknowns at which the coarsening of the AMG
+     *                      hierarchy for the pressure system stops.
+     * \param dimension The spatial dimension of the grid.
+     * \param relaxation The relaxation factor of the ILU(0) stage.
+     */
+    CprPreconditioner(const Matrix& matrix,
+                      const WeightVector& weights,
+                      unsigned pressureIdx,
+                      int coarsenTarget,
+                      int dimension,
+                      field_type relaxation = 1.0)
+        : matrix_(matrix)
+        , pressureIdx_(pressureIdx)
+        , coarsenTarget_(coarsenTarget)
+        , dimension_(dimension)
+    {
+        assert(pressureIdx_ < static_cast<unsigned>(numEq));
+
+        createPressureMatrix_();
+        assemblePressureMatrix_(weights);
+        setupAmg_();
+
+        ilu_ = std::make_unique<Ilu>(matrix_, relaxation);
+
+        pressureRhs_.resize(matrix_.N());
+        pressureSol_.resize(matrix_.N());
+    }
+
+    //! the kind of computations supported by the preconditioner
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+    /*!
+     * \brief Update the preconditioner after the values of the matrix have changed.
+     *
+     * The sparsity pattern of the matrix must be the same as when the preconditioner
+     * was created. The aggregates of the AMG hierarchy for the pressure system are
+     * kept and only the coarse level matrices and the smoothers are recomputed.
+     */
+    void update(const WeightVector& weights, field_type relaxation = 1.0)
+    {
+        assemblePressureMatrix_(weights);
+        amg_->update();
+
+        ilu_ = std::make_unique<Ilu>(matrix_, relaxation);
+    }
+
+    void pre(Vector&, Vector&) override
+    {
+        // the AMG allocates its vectors on the coarse levels here, so this is not
+        // repeated for every application of the preconditioner
+        pressureSol_ = 0.0;
+        pressureRhs_ = 0.0;
+        amg_->pre(pressureSol_, pressureRhs_);
+    }
+
+    void apply(Vector& x, const Vector& d) override
+    {
+        const std::size_t numRows = matrix_.N();
+        if (!residual_) {
+            residual_ = std::make_unique<Vector>(d);
+            correction_ = std::make_unique<Vector>(d);
+        }
+
+        // first stage: restrict the residual to the pressure equation and solve the
+        // pressure system approximately
+        auto& rp = pressureRhs_;
+        auto& xp = pressureSol_;
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            rp[rowIdx] = weights_[rowIdx]*d[rowIdx];
+
+        xp = 0.0;
+        amg_->apply(xp, rp);
+
+        x = 0.0;
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            x[rowIdx][pressureIdx_] = xp[rowIdx];
+
+        // second stage: smooth the full system using the residual which remains after
+        // the pressure correction
+        auto& r = *residual_;
+        auto& dx = *correction_;
+        r = d;
+        matrix_.mmv(x, r);
+
+        dx = 0.0;
+        ilu_->apply(dx, r);
+        x += dx;
+    }
+
+    void post(Vector&) override
+    { amg_->post(pressureSol_); }
+
+private:
+    void createPressureMatrix_()
+    {
+        const std::size_t numRows = matrix_.N();
+        pressureMatrix_ = std::make_unique<PressureMatrix>(numRows,
+                                                           numRows,
+                                                           matrix_.nonzeroes(),
+                                                           PressureMatrix::row_wise);
+
+        // the pressure system uses the same sparsity pattern as the full system
+        auto srcRowIt = matrix_.begin();
+        for (auto rowIt = pressureMatrix_->createbegin();
+             rowIt != pressureMatrix_->createend();
+             ++rowIt, ++srcRowIt)
+        {
+            const auto colEndIt = srcRowIt->end();
+            for (auto colIt = srcRowIt->begin(); colIt != colEndIt; ++colIt)
+                rowIt.insert(colIt.index());
+        }
+    }
+
+    void assemblePressureMatrix_(const WeightVector& weights)
+    {
+        weights_ = weights;
+
+        // the pressure equation of a row is the weighted sum of its equations, and
+        // only the derivatives with regard to pressure are considered
+        auto rowIt = pressureMatrix_->begin();
+        const auto rowEndIt = matrix_.end();
+        for (auto srcRowIt = matrix_.begin(); srcRowIt != rowEndIt; ++srcRowIt, ++rowIt) {
+            const auto& w = weights_[srcRowIt.index()];
+            auto colIt = rowIt->begin();
+            const auto colEndIt = srcRowIt->end();
+            for (auto srcColIt = srcRowIt->begin(); srcColIt != colEndIt; ++srcColIt, ++colIt) {
+                field_type value = 0.0;
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    value += w[eqIdx]*(*srcColIt)[eqIdx][pressureIdx_];
+                *colIt = value;
+            }
+        }
+    }
+
+    void setupAmg_()
+    {
+        using SmootherArgs = typename Dune::Amg::SmootherTraits<PressureSmoother>::Arguments;
+        using CoarsenCriterion =
+            Dune::Amg::CoarsenCriterion<Dune::Amg::UnSymmetricCriterion<PressureMatrix,
+                                                                        Dune::Amg::FirstDiagonal> >;
+
+        SmootherArgs smootherArgs;
+        smootherArgs.iterations = 1;
+        smootherArgs.relaxationFactor = 1.0;
+
+        CoarsenCriterion coarsenCriterion(/*maxLevel=*/15, coarsenTarget_);
+        coarsenCriterion.setDefaultValuesAnisotropic(dimension_, /*aggregateSizePerDim=*/3);
+        coarsenCriterion.setDebugLevel(0);
+        coarsenCriterion.setMinCoarsenRate(1.05);
+        coarsenCriterion.setAccumulate(Dune::Amg::noAccu);
+        coarsenCriterion.setSkipIsolated(false);
+
+        pressureOperator_ = std::make_unique<PressureOperator>(*pressureMatrix_);
+        amg_ = std::make_unique<PressureAmg>(*pressureOperator_, coarsenCriterion, smootherArgs);
+    }
+
+    const Matrix& matrix_;
+    unsigned pressureIdx_;
+    int coarsenTarget_;
+    int dimension_;
+
+    WeightVector weights_;
+    std::unique_ptr<PressureMatrix> pressureMatrix_;
+    std::unique_ptr<PressureOperator> pressureOperator_;
+    std::unique_ptr<PressureAmg> amg_;
+    std::unique_ptr<Ilu> ilu_;
+
+    // temporary vectors of apply(). the ones for the full system are allocated lazily
+    // because overlapping vectors can only be copy constructed.
+    std::unique_ptr<Vector> residual_;
+    std::unique_ptr<Vector> correction_;
+    PressureVector pressureRhs_;
+    PressureVector pressureSol_;
+};
+
+} // namespace Opm::Linear
+
+#endif
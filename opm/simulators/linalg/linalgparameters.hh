@@ -70,6 +70,14 @@ struct LinearSolverTolerance { static constexpr Scalar value = 1e-3; };
  */
 struct LinearSolverVerbosity { static constexpr int value = 0; };
 
+/*!
+ * \brief Number of Newton iterations for which the diagonal blocks of the Jacobian used
+ *        by the block-Jacobi preconditioner of the matrix-free linear solver are kept.
+ *
+ * A value of 1 means that the preconditioner is updated in every Newton iteration.
+ */
+struct MatrixFreePreconditionerLag { static constexpr int value = 1; };
+
 //! The order of the sequential preconditioner
 struct PreconditionerOrder { static constexpr int value = 0; };
 
@@ -31,6 +31,8 @@
 
 #include <opm/models/utils/basicproperties.hh>
 
+#include <type_traits>
+
 namespace Opm::Properties {
 
 //! The type of the linear solver to be used
@@ -73,4 +75,24 @@ struct OverlappingVector { using type = UndefinedProperty; };
 
 } // namespace Opm::Properties
 
+namespace Opm::Linear {
+
+/*!
+ * \brief Specifies whether a linear solver backend uses the off-diagonal blocks of the
+ *        Jacobian matrix.
+ *
+ * Backends which only need the diagonal blocks (e.g., because they compute the
+ * Jacobian-vector products themselves) export a static constexpr data member
+ * \c needsOffDiagonalBlocks which is false. In this case, the linearizers only allocate
+ * and assemble the diagonal blocks of the Jacobian.
+ */
+template <class Backend, class = void>
+struct NeedsOffDiagonalBlocks : public std::true_type {};
+
+template <class Backend>
+struct NeedsOffDiagonalBlocks<Backend, std::void_t<decltype(Backend::needsOffDiagonalBlocks)>>
+    : public std::integral_constant<bool, Backend::needsOffDiagonalBlocks> {};
+
+} // namespace Opm::Linear
+
 #endif
@@ -0,0 +1,783 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::Linear::MatrixFreeBiCGStabSolverBackend
+ */
+#ifndef EWOMS_MATRIX_FREE_BACKEND_HH
+#define EWOMS_MATRIX_FREE_BACKEND_HH
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/rangegenerators.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/models/discretization/common/fvbaseproperties.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
+#include <opm/models/parallel/threadmanager.hh>
+#include <opm/models/utils/parametersystem.hh>
+#include <opm/models/utils/timer.hh>
+#include <opm/models/utils/timerguard.hh>
+
+#include <opm/simulators/linalg/bicgstabsolver.hh>
+#include <opm/simulators/linalg/combinedcriterion.hh>
+#include <opm/simulators/linalg/linalgparameters.hh>
+#include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/overlappingblockvector.hh>
+#include <opm/simulators/linalg/overlappingpreconditioner.hh>
+#include <opm/simulators/linalg/overlappingscalarproduct.hh>
+#include <opm/simulators/linalg/parallelbasebackend.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Opm::Linear {
+
+template <class TypeTag>
+class MatrixFreeBiCGStabSolverBackend;
+
+} // namespace Opm::Linear
+
+namespace Opm::Properties {
+
+// Create new type tags
+namespace TTag {
+
+struct MatrixFreeBiCGStabLinearSolver
+{ using InheritsFrom = std::tuple<ParallelBaseLinearSolver>; };
+
+} // end namespace TTag
+
+template<class TypeTag>
+struct LinearSolverBackend<TypeTag, TTag::MatrixFreeBiCGStabLinearSolver>
+{ using type = Opm::Linear::MatrixFreeBiCGStabSolverBackend<TypeTag>; };
+
+} // namespace Opm::Properties
+
+namespace Opm::Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief A linear operator which computes Jacobian-vector products without using the
+ *        assembled Jacobian matrix.
+ *
+ * The product is computed element by element from the derivatives of the local
+ * residual, i.e., for each primary degree of freedom \f$j\f$ of an element, the
+ * derivatives of the element's residual with regard to the primary variables of
+ * \f$j\f$ are multiplied by the corresponding entries of the direction vector. The
+ * result is thus exactly what multiplying the assembled Jacobian would give, but only
+ * the local Jacobians of a single element per thread exist at any time.
+ *
+ * The operator is applied while the linear system of the current Newton iteration is
+ * solved, i.e., the solution of the model is the linearization point. If the model
+ * caches the intensive quantities, the ones computed by the linearizer are used, else
+ * they are evaluated from a private copy of the solution. Likewise, the storage term of
+ * the previous time step is read from the storage cache of the model if it is enabled
+ * and it is only recomputed otherwise. An application of the operator thus only
+ * evaluates the extensive quantities and the local residual of each element.
+ */
+template <class TypeTag>
+class MatrixFreeOperator
+    : public Dune::LinearOperator<GetPropType<TypeTag, Properties::OverlappingVector>,
+                                  GetPropType<TypeTag, Properties::OverlappingVector> >
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using LocalResidual = GetPropType<TypeTag, Properties::LocalResidual>;
+    using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
+    using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+    using Overlap = GetPropType<TypeTag, Properties::Overlap>;
+    using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
+
+    using Element = typename GridView::template Codim<0>::Entity;
+    using LocalEvalBlockVector = typename LocalResidual::LocalEvalBlockVector;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+    enum { historySize = getPropValue<TypeTag, Properties::TimeDiscHistorySize>() };
+
+    static const bool linearizeNonLocalElements =
+        getPropValue<TypeTag, Properties::LinearizeNonLocalElements>();
+
+    static_assert(!std::is_same<Evaluation, Scalar>::value,
+                  "The matrix-free operator requires a model which uses automatic "
+                  "differentiation");
+
+public:
+    //! export types
+    using domain_type = OverlappingVector;
+    using range_type = OverlappingVector;
+    using field_type = typename domain_type::field_type;
+
+    MatrixFreeOperator(const Simulator& simulator, const Overlap& overlap)
+        : simulator_(simulator)
+        , overlap_(overlap)
+        , scaleAddTmp_(overlap)
+        , numApplications_(0)
+    {
+        const auto& model = simulator_.model();
+        unsigned numThreads = ThreadManager::maxThreads();
+        elemCtx_.resize(numThreads);
+        localResidual_.resize(numThreads);
+        threadResult_.resize(numThreads);
+        for (unsigned threadId = 0; threadId < numThreads; ++threadId) {
+            elemCtx_[threadId] = std::make_unique<ElementContext>(simulator_);
+            localResidual_[threadId].reserve(model.maxNumStencilDof());
+
+            // the storage term of the previous time step is taken from the cache of the
+            // model if it is available, but the cache is never updated by the operator
+            elemCtx_[threadId]->setEnableStorageCache(model.enableStorageCache());
+            elemCtx_[threadId]->setStorageCacheReadOnly(true);
+        }
+    }
+
+    //! the kind of computations supported by the operator. Either overlapping or non-overlapping
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::overlapping; }
+
+    /*!
+     * \brief Set the point at which the Jacobian is to be applied.
+     *
+     * This is the current solution of the model. If the model does not cache the
+     * intensive quantities, a copy of the solution is stored. This method must be
+     * called before the operator is applied.
+     */
+    void linearizeAt()
+    {
+        const auto& model = simulator_.model();
+        if (!model.storeIntensiveQuantities())
+            linearizationPoint_ = model.solution(/*timeIdx=*/0);
+
+        std::size_t numDof = model.solution(/*timeIdx=*/0).size();
+        direction_.resize(numDof);
+        result_.resize(numDof);
+        for (auto& threadResult : threadResult_) {
+            threadResult.resize(numDof);
+            threadResult = 0.0;
+        }
+    }
+
+    //! apply operator to x:  \f$ y = A(x) \f$
+    void apply(const OverlappingVector& x, OverlappingVector& y) const override
+    {
+        TimerGuard applyGuard(applyTimer_);
+        applyTimer_.start();
+        ++numApplications_;
+
+        x.assignTo(direction_);
+
+        // storage to any exception that needs to be bridged out of the parallel block
+        // below. initialized to null to indicate no exception
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator_.gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // each thread accumulates its contributions in its own vector, so no
+            // locking is required
+            unsigned threadId = ThreadManager::threadId();
+            ElementContext& elemCtx = *elemCtx_[threadId];
+            LocalEvalBlockVector& localResidual = localResidual_[threadId];
+            GlobalEqVector& threadResult = threadResult_[threadId];
+
+            auto elemIt = threadedElemIt.beginParallel();
+            try {
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const auto& elem = *elemIt;
+                    if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                        continue;
+
+                    applyElement_(threadResult, localResidual, elemCtx, threadId, elem);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> take(exceptionLock);
+                exceptionPtr = std::current_exception();
+                threadedElemIt.setFinished();
+            }
+        }
+
+        if (exceptionPtr) {
+            for (auto& threadResult : threadResult_)
+                threadResult = 0.0;
+            std::rethrow_exception(exceptionPtr);
+        }
+
+        // add up the contributions of all threads and reset them for the next
+        // application of the operator
+        const int numDof = static_cast<int>(result_.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            result_[dofIdx] = 0.0;
+            for (auto& threadResult : threadResult_) {
+                result_[dofIdx] += threadResult[dofIdx];
+                threadResult[dofIdx] = 0.0;
+            }
+        }
+
+        // the border entries are added up like those of the residual
+        y.assignAddBorder(result_);
+    }
+
+    //! apply operator to x, scale and add:  \f$ y = y + \alpha A(x) \f$
+    void applyscaleadd(field_type alpha,
+                       const OverlappingVector& x,
+                       OverlappingVector& y) const override
+    {
+        apply(x, scaleAddTmp_);
+        y.axpy(alpha, scaleAddTmp_);
+    }
+
+    const Overlap& overlap() const
+    { return overlap_; }
+
+    /*!
+     * \brief Returns the number of times the operator was applied since its creation.
+     */
+    std::size_t numApplications() const
+    { return numApplications_; }
+
+    /*!
+     * \brief Returns the wall clock time spent for applying the operator.
+     */
+    const Timer& applyTimer() const
+    { return applyTimer_; }
+
+    /*!
+     * \brief Returns the number of bytes which are allocated by the global vectors of
+     *        the operator.
+     */
+    std::size_t memoryUsage() const
+    {
+        std::size_t numEqVectors = 2 + threadResult_.size();
+        return
+            linearizationPoint_.size()*sizeof(typename SolutionVector::block_type)
+            + numEqVectors*direction_.size()*sizeof(typename GlobalEqVector::block_type)
+            + scaleAddTmp_.size()*sizeof(typename OverlappingVector::block_type);
+    }
+
+private:
+    // add the product of the local Jacobian of an element and the direction vector to
+    // the result vector
+    void applyElement_(GlobalEqVector& dest,
+                       LocalEvalBlockVector& localResidual,
+                       ElementContext& elemCtx,
+                       unsigned threadId,
+                       const Element& elem) const
+    {
+        const auto& model = simulator_.model();
+
+        elemCtx.updateStencil(elem);
+        // the cached intensive quantities are those of the linearization point, the
+        // linearizer has computed them for all degrees of freedom of the stencil
+        if (model.storeIntensiveQuantities())
+            elemCtx.updateIntensiveQuantities(/*timeIdx=*/0);
+        else
+            elemCtx.updateIntensiveQuantities(linearizationPoint_, /*timeIdx=*/0);
+
+        if (!model.enableStorageCache()) {
+            for (unsigned timeIdx = 1; timeIdx < historySize; ++timeIdx)
+                elemCtx.updatePrimaryIntensiveQuantities(model.solution(timeIdx), timeIdx);
+        }
+
+        std::size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        std::size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        localResidual.resize(numDof);
+        for (unsigned focusDofIdx = 0; focusDofIdx < numPrimaryDof; ++focusDofIdx) {
+            elemCtx.setFocusDofIndex(focusDofIdx);
+            elemCtx.updateAllExtensiveQuantities();
+            model.localResidual(threadId).eval(localResidual, elemCtx);
+
+            // the derivatives of the residual of each degree of freedom of the stencil
+            // with regard to the primary variables of the focus degree of freedom form
+            // a column of blocks of the Jacobian
+            const auto& dirBlock = direction_[elemCtx.globalSpaceIndex(focusDofIdx, /*timeIdx=*/0)];
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                auto& destBlock = dest[elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0)];
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                        destBlock[eqIdx] += localResidual[dofIdx][eqIdx].derivative(pvIdx)*dirBlock[pvIdx];
+            }
+        }
+    }
+
+    const Simulator& simulator_;
+    const Overlap& overlap_;
+
+    SolutionVector linearizationPoint_;
+
+    std::vector<std::unique_ptr<ElementContext>> elemCtx_;
+    mutable std::vector<LocalEvalBlockVector> localResidual_;
+    mutable std::vector<GlobalEqVector> threadResult_;
+    mutable GlobalEqVector direction_;
+    mutable GlobalEqVector result_;
+    // the result of the operator for applyscaleadd()
+    mutable OverlappingVector scaleAddTmp_;
+
+    mutable std::size_t numApplications_;
+    mutable Timer applyTimer_;
+};
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief A block-Jacobi preconditioner which only stores the inverses of the diagonal
+ *        blocks of a matrix.
+ *
+ * It operates on the domestic indices of an overlapping vector and needs to be wrapped
+ * into an OverlappingPreconditioner.
+ */
+template <class OverlappingVector, class MatrixBlock>
+class MatrixFreeBlockJacobiPreconditioner
+    : public Dune::Preconditioner<OverlappingVector, OverlappingVector>
+{
+public:
+    using domain_type = OverlappingVector;
+    using range_type = OverlappingVector;
+    using field_type = typename OverlappingVector::field_type;
+
+    explicit MatrixFreeBlockJacobiPreconditioner(const std::vector<MatrixBlock>& invDiagonal)
+        : invDiagonal_(invDiagonal)
+    { }
+
+    void pre(domain_type&, range_type&) override
+    { }
+
+    void apply(domain_type& x, const range_type& d) override
+    {
+        for (unsigned rowIdx = 0; rowIdx < invDiagonal_.size(); ++rowIdx)
+            invDiagonal_[rowIdx].mv(d[rowIdx], x[rowIdx]);
+    }
+
+    void post(domain_type&) override
+    { }
+
+    Dune::SolverCategory::Category category() const override
+    { return Dune::SolverCategory::sequential; }
+
+private:
+    const std::vector<MatrixBlock>& invDiagonal_;
+};
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief A Jacobian-free Newton-Krylov linear solver backend.
+ *
+ * The Krylov method (BiCGStab) only needs Jacobian-vector products, which are provided
+ * by the MatrixFreeOperator. The backend tells the linearizer that it does not need the
+ * off-diagonal blocks of the Jacobian, so only the diagonal blocks are allocated and
+ * assembled. Their inverses form a block-Jacobi preconditioner. Since the preconditioner
+ * does not need to be exact, it can be lagged for several Newton iterations using the
+ * "MatrixFreePreconditionerLag" parameter.
+ *
+ * The algebraic overlap is computed from the connectivity of the element stencils, so
+ * the backend does not allocate any overlapping matrix either.
+ *
+ * Only the BiCGStab solver of opm-models and the block-Jacobi preconditioner are
+ * supported: the solvers and preconditioners of the ISTL solver wrappers need the
+ * assembled matrix. Also note that the matrix-free operator only considers the residual
+ * of the model's local residual, i.e., models which use auxiliary equations (e.g.,
+ * wells) or constraint degrees of freedom must use one of the assembled linear solvers.
+ */
+template <class TypeTag>
+class MatrixFreeBiCGStabSolverBackend
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using LinearSolverScalar = GetPropType<TypeTag, Properties::LinearSolverScalar>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+    using Vector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+    using BorderListCreator = GetPropType<TypeTag, Properties::BorderListCreator>;
+    using Stencil = GetPropType<TypeTag, Properties::Stencil>;
+
+    using Overlap = GetPropType<TypeTag, Properties::Overlap>;
+    using OverlappingVector = GetPropType<TypeTag, Properties::OverlappingVector>;
+
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+
+    using MatrixBlock = Dune::FieldMatrix<LinearSolverScalar, numEq, numEq>;
+    using DiagonalEntry = Dune::FieldVector<LinearSolverScalar, numEq*numEq>;
+    using DiagonalVector = Dune::BlockVector<DiagonalEntry>;
+    using OverlappingDiagonalVector = OverlappingBlockVector<DiagonalEntry, Overlap>;
+    using PatternMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<LinearSolverScalar, 1, 1> >;
+
+    using Operator = MatrixFreeOperator<TypeTag>;
+    using SequentialPreconditioner = MatrixFreeBlockJacobiPreconditioner<OverlappingVector, MatrixBlock>;
+    using ParallelPreconditioner = OverlappingPreconditioner<SequentialPreconditioner, Overlap>;
+    using ParallelScalarProduct = OverlappingScalarProduct<OverlappingVector, Overlap>;
+
+    using RawLinearSolver = BiCGStabSolver<Operator,
+                                           OverlappingVector,
+                                           ParallelPreconditioner>;
+
+    static_assert(!getPropValue<TypeTag, Properties::EnableConstraints>(),
+                  "The matrix-free linear solver backend does not support constraints");
+
+public:
+    //! the linearizers only need to assemble the diagonal blocks of the Jacobian
+    static constexpr bool needsOffDiagonalBlocks = false;
+
+    MatrixFreeBiCGStabSolverBackend(const Simulator& simulator)
+        : simulator_(simulator)
+        , gridSequenceNumber_(-1)
+        , lastIterations_(0)
+        , numPatternNonzeros_(0)
+        , numSolves_(0)
+        , numApplications_(0)
+        , applyTime_(0.0)
+    { }
+
+    ~MatrixFreeBiCGStabSolverBackend()
+    {
+        if (numSolves_ > 0 && simulator_.gridView().comm().rank() == 0 &&
+            Parameters::Get<Parameters::LinearSolverVerbosity>() > 0)
+            printReport_();
+
+        cleanup_();
+    }
+
+    static void registerParameters()
+    {
+        Parameters::Register<Parameters::LinearSolverTolerance<Scalar>>
+            ("The maximum allowed error between of the linear solver");
+        Parameters::Register<Parameters::LinearSolverAbsTolerance<Scalar>>
+            ("The maximum accepted error of the norm of the residual");
+        Parameters::Register<Parameters::LinearSolverOverlapSize>
+            ("The size of the algebraic overlap for the linear solver");
+        Parameters::Register<Parameters::LinearSolverMaxIterations>
+            ("The maximum number of iterations of the linear solver");
+        Parameters::Register<Parameters::LinearSolverVerbosity>
+            ("The verbosity level of the linear solver");
+        Parameters::Register<Parameters::LinearSolverMaxError<Scalar>>
+            ("The maximum residual error which the linear solver tolerates"
+             " without giving up");
+        Parameters::Register<Parameters::MatrixFreePreconditionerLag>
+            ("The number of Newton iterations for which the block-Jacobi preconditioner "
+             "of the matrix-free linear solver is kept");
+    }
+
+    /*!
+     * \brief Causes the solve() method to discared the structure of the linear system of
+     *        equations the next time it is called.
+     */
+    void eraseMatrix()
+    { cleanup_(); }
+
+    /*!
+     * \brief Set up the internal data structures required for the linear solver.
+     *
+     * The algebraic overlap is determined from the element stencils because the
+     * Jacobian only features its diagonal blocks.
+     */
+    void prepare(const SparseMatrixAdapter&, const Vector&)
+    {
+        // if grid has changed the sequence number has changed too
+        int curSeqNum = simulator_.vanguard().gridSequenceNumber();
+        if (gridSequenceNumber_ == curSeqNum && overlap_)
+            return;
+
+        cleanup_();
+        gridSequenceNumber_ = curSeqNum;
+
+        BorderListCreator borderListCreator(simulator_.gridView(),
+                                            simulator_.model().dofMapper());
+        unsigned overlapSize = Parameters::Get<Parameters::LinearSolverOverlapSize>();
+        {
+            // the overlap only depends on the connectivity of the degrees of freedom,
+            // so a scalar matrix is sufficient. it is released right away.
+            PatternMatrix pattern;
+            createPattern_(pattern);
+            numPatternNonzeros_ = pattern.nonzeroes();
+            overlap_ = std::make_unique<Overlap>(pattern,
+                                                 borderListCreator.borderList(),
+                                                 borderListCreator.blackList(),
+                                                 overlapSize);
+        }
+
+        overlappingb_ = std::make_unique<OverlappingVector>(*overlap_);
+        overlappingx_ = std::make_unique<OverlappingVector>(*overlap_);
+        overlappingDiagonal_ = std::make_unique<OverlappingDiagonalVector>(*overlap_);
+        operator_ = std::make_unique<Operator>(simulator_, *overlap_);
+        preconditionerAge_ = -1;
+    }
+
+    /*!
+     * \brief Assign values to the internal data structure for the residual vector.
+     *
+     * This method also cares about synchronizing that vector with the peer processes.
+     */
+    void setResidual(const Vector& b)
+    { overlappingb_->assignAddBorder(b); }
+
+    /*!
+     * \brief Retrieve the synchronized internal residual vector.
+     *
+     * This only deals with entries which are local to the current process.
+     */
+    void getResidual(Vector& b) const
+    { overlappingb_->assignTo(b); }
+
+    /*!
+     * \brief Sets the values of the residual's Jacobian matrix.
+     *
+     * Only the diagonal blocks are used. They are inverted for the block-Jacobi
+     * preconditioner if it is due for an update.
+     */
+    void setMatrix(const SparseMatrixAdapter& M)
+    {
+        int lag = std::max(Parameters::Get<Parameters::MatrixFreePreconditionerLag>(), 1);
+        if (preconditionerAge_ >= 0 && preconditionerAge_ + 1 < lag) {
+            ++preconditionerAge_;
+            return;
+        }
+
+        updatePreconditioner_(M);
+        preconditionerAge_ = 0;
+    }
+
+    /*!
+     * \brief Actually solve the linear system of equations.
+     *
+     * \return true if the residual reduction could be achieved, else false.
+     */
+    bool solve(Vector& x)
+    {
+        (*overlappingx_) = 0.0;
+
+        operator_->linearizeAt();
+
+        SequentialPreconditioner seqPreCond(invDiagonal_);
+        ParallelPreconditioner parPreCond(seqPreCond, *overlap_);
+        ParallelScalarProduct parScalarProduct(*overlap_);
+
+        const auto& gridView = simulator_.gridView();
+        using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
+
+        Scalar linearSolverTolerance = Parameters::Get<Parameters::LinearSolverTolerance<Scalar>>();
+        Scalar linearSolverAbsTolerance = Parameters::Get<Parameters::LinearSolverAbsTolerance<Scalar>>();
+        if (linearSolverAbsTolerance < 0.0)
+            linearSolverAbsTolerance = simulator_.model().newtonMethod().tolerance() / 100.0;
+
+        CCC convCrit(gridView.comm(),
+                     /*residualReductionTolerance=*/linearSolverTolerance,
+                     /*absoluteResidualTolerance=*/linearSolverAbsTolerance,
+                     Parameters::Get<Parameters::LinearSolverMaxError<Scalar>>());
+
+        RawLinearSolver solver(parPreCond, convCrit, parScalarProduct);
+
+        int verbosity = 0;
+        if (overlap_->myRank() == 0)
+            verbosity = Parameters::Get<Parameters::LinearSolverVerbosity>();
+        solver.setVerbosity(verbosity);
+        solver.setMaxIterations(Parameters::Get<Parameters::LinearSolverMaxIterations>());
+        solver.setLinearOperator(operator_.get());
+        solver.setRhs(overlappingb_.get());
+
+        std::size_t numApplicationsBefore = operator_->numApplications();
+        double applyTimeBefore = operator_->applyTimer().realTimeElapsed();
+
+        bool converged = solver.apply(*overlappingx_);
+        lastIterations_ = solver.report().iterations();
+
+        ++numSolves_;
+        numApplications_ += operator_->numApplications() - numApplicationsBefore;
+        applyTime_ += operator_->applyTimer().realTimeElapsed() - applyTimeBefore;
+
+        overlappingx_->assignTo(x);
+
+        return converged;
+    }
+
+    /*!
+     * \brief Return number of iterations used during last solve.
+     */
+    std::size_t iterations() const
+    { return lastIterations_; }
+
+    /*!
+     * \brief Returns the number of bytes which are allocated by the matrix-free operator.
+     */
+    std::size_t operatorMemoryUsage() const
+    { return operator_ ? operator_->memoryUsage() : 0; }
+
+    /*!
+     * \brief Returns the number of bytes which are allocated by the preconditioner.
+     */
+    std::size_t preconditionerMemoryUsage() const
+    {
+        std::size_t numBlocks = invDiagonal_.size();
+        if (overlappingDiagonal_)
+            numBlocks += overlappingDiagonal_->size();
+        return numBlocks*sizeof(MatrixBlock);
+    }
+
+    /*!
+     * \brief Returns the number of bytes which the assembled (non-overlapping) Jacobian
+     *        would need.
+     */
+    std::size_t assembledJacobianMemoryUsage() const
+    { return numPatternNonzeros_*sizeof(typename SparseMatrixAdapter::MatrixBlock); }
+
+private:
+    void cleanup_()
+    {
+        // everything else refers to the overlap, so it is released last
+        operator_.reset();
+        overlappingDiagonal_.reset();
+        overlappingx_.reset();
+        overlappingb_.reset();
+        invDiagonal_.clear();
+        overlap_.reset();
+    }
+
+    // determine the connectivity of the degrees of freedom from the element stencils
+    void createPattern_(PatternMatrix& pattern) const
+    {
+        const auto& model = simulator_.model();
+        std::size_t numDof = model.numGridDof();
+
+        std::vector<std::set<unsigned>> neighbors(numDof);
+        Stencil stencil(simulator_.gridView(), model.dofMapper());
+        for (const auto& elem : elements(simulator_.gridView())) {
+            stencil.update(elem);
+
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+                for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx)
+                    neighbors[myIdx].insert(stencil.globalSpaceIndex(dofIdx));
+            }
+        }
+
+        pattern.setBuildMode(PatternMatrix::random);
+        pattern.setSize(numDof, numDof);
+        for (unsigned rowIdx = 0; rowIdx < numDof; ++rowIdx)
+            pattern.setrowsize(rowIdx, neighbors[rowIdx].size());
+        pattern.endrowsizes();
+        for (unsigned rowIdx = 0; rowIdx < numDof; ++rowIdx)
+            for (unsigned colIdx : neighbors[rowIdx])
+                pattern.addindex(rowIdx, colIdx);
+        pattern.endindices();
+    }
+
+    // invert the diagonal blocks of the Jacobian for the block-Jacobi preconditioner
+    void updatePreconditioner_(const SparseMatrixAdapter& M)
+    {
+        const auto& istlMatrix = M.istlMatrix();
+        DiagonalVector nativeDiagonal(overlap_->numNative());
+        for (unsigned rowIdx = 0; rowIdx < nativeDiagonal.size(); ++rowIdx) {
+            const auto& block = istlMatrix[rowIdx][rowIdx];
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    nativeDiagonal[rowIdx][eqIdx*numEq + pvIdx] = block[eqIdx][pvIdx];
+        }
+
+        // the diagonal blocks of the border degrees of freedom are added up exactly
+        // like the entries of the residual
+        overlappingDiagonal_->assignAddBorder(nativeDiagonal);
+
+        std::size_t numDomestic = overlap_->numDomestic();
+        invDiagonal_.resize(numDomestic);
+        int preconditionerIsReady = 1;
+        for (unsigned domRowIdx = 0; domRowIdx < numDomestic; ++domRowIdx) {
+            auto& invBlock = invDiagonal_[domRowIdx];
+            const auto& entry = (*overlappingDiagonal_)[domRowIdx];
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    invBlock[eqIdx][pvIdx] = entry[eqIdx*numEq + pvIdx];
+
+            try {
+                invBlock.invert();
+            }
+            catch (const Dune::Exception&) {
+                preconditionerIsReady = 0;
+            }
+        }
+
+        // make sure that the preconditioner is also ready on all peer ranks.
+        preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
+        if (!preconditionerIsReady)
+            throw NumericalProblem("Inverting the diagonal blocks of the Jacobian failed");
+    }
+
+    void printReport_() const
+    {
+        std::cout << "Matrix-free linear solver:\n"
+                  << "  linear solves: " << numSolves_ << "\n"
+                  << "  operator applications: " << numApplications_ << "\n"
+                  << "  time spent in operator applications: " << applyTime_ << " s\n"
+                  << "  memory used by the operator: "
+                  << operatorMemoryUsage()/1024 << " KiB\n"
+                  << "  memory used by the block-Jacobi preconditioner: "
+                  << preconditionerMemoryUsage()/1024 << " KiB\n"
+                  << "  memory the assembled Jacobian would need: "
+                  << assembledJacobianMemoryUsage()/1024 << " KiB\n"
+                  << std::flush;
+    }
+
+    const Simulator& simulator_;
+    int gridSequenceNumber_;
+    std::size_t lastIterations_;
+
+    std::unique_ptr<Overlap> overlap_;
+    std::unique_ptr<OverlappingVector> overlappingb_;
+    std::unique_ptr<OverlappingVector> overlappingx_;
+    std::unique_ptr<OverlappingDiagonalVector> overlappingDiagonal_;
+    std::vector<MatrixBlock> invDiagonal_;
+    std::unique_ptr<Operator> operator_;
+    int preconditionerAge_{-1};
+
+    std::size_t numPatternNonzeros_;
+    std::size_t numSolves_;
+    std::size_t numApplications_;
+    double applyTime_;
+};
+
+} // namespace Opm::Linear
+
+#endif
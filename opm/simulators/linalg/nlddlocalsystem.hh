@@ -0,0 +1,177 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::Linear::NlddLocalSystem
+ */
+#ifndef EWOMS_NLDD_LOCAL_SYSTEM_HH
+#define EWOMS_NLDD_LOCAL_SYSTEM_HH
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Opm::Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief The linear system of equations of a subdomain of the nonlinear domain
+ *        decomposition.
+ *
+ * The system consists of the rows and columns of the global system which belong to
+ * the degrees of freedom of the subdomain, i.e., the unknowns outside of the
+ * subdomain are kept fixed. The sparsity pattern is extracted once; afterwards,
+ * assemble() only copies the values of the global blocks. The system is solved using
+ * BiCGStab preconditioned by ILU(0).
+ */
+template <class Matrix, class Vector>
+class NlddLocalSystem
+{
+    using Scalar = typename Vector::field_type;
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    using Ilu = Dune::SeqILU<Matrix, Vector, Vector>;
+    using Solver = Dune::BiCGSTABSolver<Vector>;
+    using Block = typename Matrix::block_type;
+
+public:
+    /*!
+     * \brief Extract the sparsity pattern of a subdomain.
+     *
+     * \param globalMatrix The global Jacobian
+     * \param cells The global indices of the degrees of freedom of the subdomain
+     * \param globalToLocal Scratch space of the size of the global system. All entries
+     *                      must be -1 and are -1 again when the constructor returns.
+     */
+    NlddLocalSystem(const Matrix& globalMatrix,
+                    const std::vector<int>& cells,
+                    std::vector<int>& globalToLocal)
+        : cells_(cells)
+    {
+        assert(globalToLocal.size() == globalMatrix.N());
+
+        // if the degrees of freedom are sorted, the local columns of each row are
+        // ordered like the global ones, so the blocks can be copied in sequence
+        std::sort(cells_.begin(), cells_.end());
+
+        const std::size_t numRows = cells_.size();
+        for (std::size_t localIdx = 0; localIdx < numRows; ++localIdx)
+            globalToLocal[cells_[localIdx]] = static_cast<int>(localIdx);
+
+        std::size_t numNonZeros = 0;
+        for (const int globalIdx : cells_) {
+            const auto& row = globalMatrix[globalIdx];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt)
+                if (globalToLocal[colIt.index()] >= 0)
+                    ++numNonZeros;
+        }
+
+        matrix_.setBuildMode(Matrix::row_wise);
+        matrix_.setSize(numRows, numRows, numNonZeros);
+        sourceBlocks_.reserve(numNonZeros);
+        auto cellIt = cells_.begin();
+        for (auto rowIt = matrix_.createbegin(); rowIt != matrix_.createend(); ++rowIt, ++cellIt) {
+            const auto& row = globalMatrix[*cellIt];
+            for (auto colIt = row.begin(); colIt != row.end(); ++colIt) {
+                const int localColIdx = globalToLocal[colIt.index()];
+                if (localColIdx >= 0) {
+                    rowIt.insert(localColIdx);
+                    sourceBlocks_.push_back(&(*colIt));
+                }
+            }
+        }
+
+        for (const int globalIdx : cells_)
+            globalToLocal[globalIdx] = -1;
+
+        rhs_.resize(numRows);
+        solution_.resize(numRows);
+    }
+
+    /*!
+     * \brief Returns the global indices of the degrees of freedom of the subdomain.
+     */
+    const std::vector<int>& cells() const
+    { return cells_; }
+
+    /*!
+     * \brief Copy the values of the subdomain from the global system.
+     *
+     * The blocks are read from the global matrix which was passed to the constructor,
+     * so it must not have been reallocated since.
+     */
+    void assemble(const Vector& globalResidual)
+    {
+        std::size_t blockIdx = 0;
+        for (auto rowIt = matrix_.begin(); rowIt != matrix_.end(); ++rowIt)
+            for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt)
+                *colIt = *sourceBlocks_[blockIdx++];
+
+        for (std::size_t localIdx = 0; localIdx < cells_.size(); ++localIdx)
+            rhs_[localIdx] = globalResidual[cells_[localIdx]];
+    }
+
+    /*!
+     * \brief Solve the local system and scatter the result into a global vector.
+     *
+     * Only the entries of the subdomain are written. Returns false if the linear solver
+     * did not converge or produced a non-finite solution.
+     */
+    bool solve(Vector& globalSolution, Scalar reduction, int maxIterations)
+    {
+        Operator op(matrix_);
+        Ilu ilu(matrix_, /*relaxation=*/1.0);
+        Solver solver(op, ilu, reduction, maxIterations, /*verbose=*/0);
+
+        Dune::InverseOperatorResult result;
+        solution_ = 0.0;
+        solver.apply(solution_, rhs_, result);
+        if (!result.converged || !std::isfinite(solution_.infinity_norm()))
+            return false;
+
+        for (std::size_t localIdx = 0; localIdx < cells_.size(); ++localIdx)
+            globalSolution[cells_[localIdx]] = solution_[localIdx];
+
+        return true;
+    }
+
+private:
+    std::vector<int> cells_;
+    Matrix matrix_;
+    std::vector<const Block*> sourceBlocks_;
+    Vector rhs_;
+    Vector solution_;
+};
+
+} // namespace Opm::Linear
+
+#endif
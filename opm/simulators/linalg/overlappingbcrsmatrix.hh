@@ -37,7 +37,9 @@
 #include <dune/istl/scalarproducts.hh>
 #include <dune/istl/io.hh>
 #include <algorithm>
+#include <cstddef>
 #include <set>
+#include <unordered_set>
 #include <map>
 #include <iostream>
 #include <vector>
@@ -216,44 +218,44 @@ public:
                                 "row");
     }
 
+    /*!
+     * \brief Copy the domestic entries of a non-overlapping matrix into the overlapping
+     *        one and set all other entries to zero.
+     *
+     * The location of the overlapping entry which corresponds to each native one is
+     * determined when the method is called for the first time. Afterwards, this
+     * amounts to a linear pass over the native entries. The sparsity pattern of the
+     * native matrix must thus stay the same as long as its number of non-zero entries
+     * does not change.
+     */
     template <class NativeBCRSMatrix>
     void assignFromNative(const NativeBCRSMatrix& nativeMatrix)
     {
-        // first, set everything to 0,
-        BCRSMatrix::operator=(0.0);
-
-        // then copy the domestic entries of the native matrix to the overlapping matrix
-        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
-            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
-            if (domesticRowIdx < 0) {
-                continue; // row corresponds to a black-listed entry
-            }
-
-            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
-            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
-            for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
-                Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
-
-                // make sure to include all off-diagonal entries, even those which belong
-                // to DOFs which are managed by a peer process. For this, we have to
-                // re-map the column index of the black-listed index to a native one.
-                if (domesticColIdx < 0)
-                    domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIt.index()));
-
-                if (domesticColIdx < 0)
-                    // there is no domestic index which corresponds to a black-listed
-                    // one. this can happen if the grid overlap is larger than the
-                    // algebraic one...
+        if (nativeEntryTargets_.empty() || nativeEntryTargets_.size() != nativeMatrix.nonzeroes())
+            mapNativeEntries_(nativeMatrix);
+
+        // the entries which do not have a counterpart in the native matrix only receive
+        // contributions from the peer processes
+        for (block_type* dest : nonNativeEntries_)
+            *dest = 0.0;
+
+        std::size_t entryIdx = 0;
+        const auto& nativeRowEndIt = nativeMatrix.end();
+        for (auto nativeRowIt = nativeMatrix.begin(); nativeRowIt != nativeRowEndIt; ++nativeRowIt) {
+            const auto& nativeColEndIt = nativeRowIt->end();
+            for (auto nativeColIt = nativeRowIt->begin(); nativeColIt != nativeColEndIt; ++nativeColIt, ++entryIdx) {
+                block_type* dest = nativeEntryTargets_[entryIdx];
+                if (!dest)
+                    // the entry is black-listed or not known to the domestic overlap
                     continue;
 
                 // we need to copy the block matrices manually since it seems that (at
                 // least some versions of) Dune have an endless recursion bug when
                 // assigning dense matrices of different field type
                 const auto& src = *nativeColIt;
-                auto& dest = (*this)[static_cast<unsigned>(domesticRowIdx)][static_cast<unsigned>(domesticColIdx)];
                 for (unsigned i = 0; i < src.rows; ++i) {
                     for (unsigned j = 0; j < src.cols; ++j) {
-                        dest[i][j] = static_cast<field_type>(src[i][j]);
+                        (*dest)[i][j] = static_cast<field_type>(src[i][j]);
                     }
                 }
             }
@@ -322,6 +324,59 @@ public:
     }
 
 private:
+    // determine the overlapping entry which corresponds to each entry of the native
+    // matrix and the overlapping entries which do not correspond to any native one
+    template <class NativeBCRSMatrix>
+    void mapNativeEntries_(const NativeBCRSMatrix& nativeMatrix)
+    {
+        nativeEntryTargets_.clear();
+        nativeEntryTargets_.reserve(nativeMatrix.nonzeroes());
+        std::unordered_set<const block_type*> nativeEntries;
+
+        for (unsigned nativeRowIdx = 0; nativeRowIdx < nativeMatrix.N(); ++nativeRowIdx) {
+            Index domesticRowIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeRowIdx));
+
+            auto nativeColIt = nativeMatrix[nativeRowIdx].begin();
+            const auto& nativeColEndIt = nativeMatrix[nativeRowIdx].end();
+            for (; nativeColIt != nativeColEndIt; ++nativeColIt) {
+                if (domesticRowIdx < 0) {
+                    // row corresponds to a black-listed entry
+                    nativeEntryTargets_.push_back(nullptr);
+                    continue;
+                }
+
+                Index domesticColIdx = overlap_->nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+
+                // make sure to include all off-diagonal entries, even those which belong
+                // to DOFs which are managed by a peer process. For this, we have to
+                // re-map the column index of the black-listed index to a native one.
+                if (domesticColIdx < 0)
+                    domesticColIdx = overlap_->blackList().nativeToDomestic(static_cast<Index>(nativeColIt.index()));
+
+                if (domesticColIdx < 0) {
+                    // there is no domestic index which corresponds to a black-listed
+                    // one. this can happen if the grid overlap is larger than the
+                    // algebraic one...
+                    nativeEntryTargets_.push_back(nullptr);
+                    continue;
+                }
+
+                block_type* dest = &(*this)[static_cast<unsigned>(domesticRowIdx)][static_cast<unsigned>(domesticColIdx)];
+                nativeEntryTargets_.push_back(dest);
+                nativeEntries.insert(dest);
+            }
+        }
+
+        nonNativeEntries_.clear();
+        const auto& rowEndIt = this->end();
+        for (auto rowIt = this->begin(); rowIt != rowEndIt; ++rowIt) {
+            const auto& colEndIt = rowIt->end();
+            for (auto colIt = rowIt->begin(); colIt != colEndIt; ++colIt)
+                if (nativeEntries.count(&(*colIt)) == 0)
+                    nonNativeEntries_.push_back(&(*colIt));
+        }
+    }
+
     template <class NativeBCRSMatrix>
     void build_(const NativeBCRSMatrix& nativeMatrix)
     {
@@ -673,6 +728,11 @@ private:
     Entries entries_;
     std::shared_ptr<Overlap> overlap_;
 
+    // the overlapping entry for each entry of the native matrix in row-major order
+    // (nullptr if there is none) and the overlapping entries without a native one
+    std::vector<block_type*> nativeEntryTargets_;
+    std::vector<block_type*> nonNativeEntries_;
+
     std::map<ProcessRank, MpiBuffer<unsigned> *> numRowsSendBuff_;
     std::map<ProcessRank, MpiBuffer<unsigned> *> rowSizesSendBuff_;
     std::map<ProcessRank, MpiBuffer<Index> *> rowIndicesSendBuff_;
@@ -33,11 +33,15 @@
 #include "combinedcriterion.hh"
 #include "istlsparsematrixadapter.hh"
 
+#include <opm/models/utils/timer.hh>
+
 #include <dune/istl/bcrsmatrix.hh>
 #include <dune/istl/paamg/amg.hh>
 #include <dune/istl/paamg/pinfo.hh>
 #include <dune/istl/owneroverlapcopy.hh>
 
+#include <cstddef>
+#include <iostream>
 #include <memory>
 #include <tuple>
 #include <utility>
@@ -71,6 +75,15 @@ namespace Opm::Parameters {
 //! multi-grid solver
 struct AmgCoarsenTarget { static constexpr int value = 5000; };
 
+//! If the AMG hierarchy is reused, the number of linear solves after which the
+//! aggregates are nevertheless recomputed. 0 means that they are only recomputed if
+//! the structure of the linear system changes.
+struct AmgRebuildInterval { static constexpr int value = 0; };
+
+//! Keep the communication objects and the aggregates of the AMG hierarchy between
+//! linear solves and only recompute the coarse level matrices and the smoothers
+struct AmgReuseHierarchy { static constexpr bool value = false; };
+
 }
 
 namespace Opm::Linear {
@@ -145,8 +158,20 @@ class ParallelAmgBackend : public ParallelBaseBackend<TypeTag>
 public:
     ParallelAmgBackend(const Simulator& simulator)
         : ParentType(simulator)
+        , reuseHierarchy_(Parameters::Get<Parameters::AmgReuseHierarchy>())
+        , rebuildInterval_(Parameters::Get<Parameters::AmgRebuildInterval>())
+        , numSolvesSinceRebuild_(0)
+        , numSetups_(0)
+        , numRebuilds_(0)
     { }
 
+    ~ParallelAmgBackend()
+    {
+        if (numSetups_ > 0 && this->simulator_.gridView().comm().rank() == 0 &&
+            Parameters::Get<Parameters::LinearSolverVerbosity>() > 0)
+            printReport_();
+    }
+
     static void registerParameters()
     {
         ParentType::registerParameters();
@@ -157,36 +182,88 @@ public:
         Parameters::Register<Parameters::AmgCoarsenTarget>
             ("The coarsening target for the agglomerations of "
              "the AMG preconditioner");
+        Parameters::Register<Parameters::AmgRebuildInterval>
+            ("The number of linear solves after which the aggregates of a reused AMG "
+             "hierarchy are recomputed (0: only if the structure of the matrix changes)");
+        Parameters::Register<Parameters::AmgReuseHierarchy>
+            ("Keep the aggregates of the AMG hierarchy between linear solves and "
+             "only recompute the coarse level matrices and the smoothers");
     }
 
+    /*!
+     * \brief Returns the timer for the setup of the AMG preconditioner.
+     */
+    const Timer& setupTimer() const
+    { return setupTimer_; }
+
 protected:
     friend ParentType;
 
     std::shared_ptr<AMG> preparePreconditioner_()
     {
+        // the matrix was not changed since the last solve
+        if (!this->matrixChanged_ && amg_)
+            return amg_;
+
+        setupTimer_.start();
+        ++numSetups_;
+
+        if (reuseHierarchy_ && amg_ &&
+            (rebuildInterval_ <= 0 || numSolvesSinceRebuild_ < rebuildInterval_))
+        {
+            // the overlapping matrix is the same object as for the previous solve and
+            // only its values have changed. the fine operator thus still refers to it
+            // and it suffices to recompute the Galerkin products of the coarse levels,
+            // the smoothers and the coarse solver.
+            amg_->update();
+            ++numSolvesSinceRebuild_;
+            setupTimer_.stop();
+            return amg_;
+        }
+
 #if HAVE_MPI
-        // create and initialize DUNE's OwnerOverlapCopyCommunication
-        // using the domestic overlap
-        istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
-        setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
-        istlComm_->remoteIndices().template rebuild<false>();
+        if (!reuseHierarchy_ || !istlComm_) {
+            // create and initialize DUNE's OwnerOverlapCopyCommunication
+            // using the domestic overlap
+            istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
+            setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
+            istlComm_->remoteIndices().template rebuild<false>();
+        }
 #endif
 
         // create the parallel scalar product and the parallel operator
+        if (!reuseHierarchy_ || !fineOperator_) {
 #if HAVE_MPI
-        fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_, *istlComm_);
+            fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_, *istlComm_);
 #else
-        fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_);
+            fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_);
 #endif
+        }
 
         setupAmg_();
+        ++numRebuilds_;
+        numSolvesSinceRebuild_ = 1;
 
+        setupTimer_.stop();
         return amg_;
     }
 
     void cleanupPreconditioner_()
     { /* nothing to do */ }
 
+    void cleanup_()
+    {
+        // the cached objects refer to the overlapping matrix, so they must not survive
+        // it
+        amg_.reset();
+        fineOperator_.reset();
+#if HAVE_MPI
+        istlComm_.reset();
+#endif
+
+        ParentType::cleanup_();
+    }
+
     std::shared_ptr<RawLinearSolver> prepareSolver_(ParallelOperator& parOperator,
                                                     ParallelScalarProduct& parScalarProduct,
                                                     AMG& parPreCond)
@@ -315,6 +392,15 @@ protected:
 #endif
     }
 
+    void printReport_() const
+    {
+        std::cout << "AMG preconditioner:\n"
+                  << "  setups: " << numSetups_ << " (" << numRebuilds_ << " with new aggregates)\n"
+                  << "  setup time: " << setupTimer_.realTimeElapsed() << " s ("
+                  << setupTimer_.realTimeElapsed()/numSetups_ << " s per linear solve)\n"
+                  << std::flush;
+    }
+
     std::unique_ptr<ConvergenceCriterion<OverlappingVector> > convCrit_;
 
     std::shared_ptr<FineOperator> fineOperator_;
@@ -323,6 +409,14 @@ protected:
 #if HAVE_MPI
     std::shared_ptr<OwnerOverlapCopyCommunication> istlComm_;
 #endif
+
+    bool reuseHierarchy_;
+    int rebuildInterval_;
+    int numSolvesSinceRebuild_;
+
+    Timer setupTimer_;
+    std::size_t numSetups_;
+    std::size_t numRebuilds_;
 };
 
 } // namespace Opm::Linear
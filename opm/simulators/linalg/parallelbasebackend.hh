@@ -171,7 +171,7 @@ public:
      *        equations the next time it is called.
      */
     void eraseMatrix()
-    { cleanup_(); }
+    { asImp_().cleanup_(); }
 
     /*!
      * \brief Set up the internal data structures required for the linear solver.
@@ -242,11 +242,15 @@ public:
     {
         overlappingMatrix_->assignFromNative(M.istlMatrix());
         overlappingMatrix_->syncAdd();
+        matrixChanged_ = true;
     }
 
     /*!
      * \brief Actually solve the linear system of equations.
      *
+     * If setMatrix() was not called since the last solve, the preconditioner of the
+     * last solve is reused.
+     *
      * \return true if the residual reduction could be achieved, else false.
      */
     bool solve(Vector& x)
@@ -254,6 +258,7 @@ public:
         (*overlappingx_) = 0.0;
 
         auto parPreCond = asImp_().preparePreconditioner_();
+        matrixChanged_ = false;
         auto precondCleanupFn = [this]() -> void
                                 { this->asImp_().cleanupPreconditioner_(); };
         auto precondCleanupGuard = Opm::make_guard(precondCleanupFn);
@@ -298,6 +303,12 @@ protected:
 
     void cleanup_()
     {
+        // the preconditioner refers to the overlapping matrix
+        if (parPreCond_) {
+            parPreCond_.reset();
+            precWrapper_.cleanup();
+        }
+
         // create the overlapping Jacobian matrix and vectors
         delete overlappingMatrix_;
         delete overlappingb_;
@@ -310,6 +321,14 @@ protected:
 
     std::shared_ptr<ParallelPreconditioner> preparePreconditioner_()
     {
+        if (!matrixChanged_ && parPreCond_)
+            return parPreCond_;
+
+        if (parPreCond_) {
+            parPreCond_.reset();
+            precWrapper_.cleanup();
+        }
+
         int preconditionerIsReady = 1;
         try {
             // update sequential preconditioner
@@ -329,12 +348,13 @@ protected:
             throw NumericalProblem("Creating the preconditioner failed");
 
         // create the parallel preconditioner
-        return std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
+        parPreCond_ = std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
+        return parPreCond_;
     }
 
     void cleanupPreconditioner_()
     {
-        precWrapper_.cleanup();
+        // the preconditioner is kept until the matrix changes
     }
 
     void writeOverlapToVTK_()
@@ -382,7 +402,11 @@ protected:
     OverlappingVector *overlappingb_;
     OverlappingVector *overlappingx_;
 
+    // true if the values of the matrix were changed since the last solve
+    bool matrixChanged_ = true;
+
     PreconditionerWrapper precWrapper_;
+    std::shared_ptr<ParallelPreconditioner> parPreCond_;
 };
 }} // namespace Linear, Opm
 
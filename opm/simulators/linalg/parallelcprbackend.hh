@@ -0,0 +1,382 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::ParallelCprBackend
+ */
+#ifndef EWOMS_PARALLEL_CPR_BACKEND_HH
+#define EWOMS_PARALLEL_CPR_BACKEND_HH
+
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/models/discretization/common/fvbaseproperties.hh>
+#include <opm/models/utils/timer.hh>
+
+#include <opm/simulators/linalg/bicgstabsolver.hh>
+#include <opm/simulators/linalg/combinedcriterion.hh>
+#include <opm/simulators/linalg/cprpreconditioner.hh>
+#include <opm/simulators/linalg/istlsparsematrixadapter.hh>
+#include <opm/simulators/linalg/linalgparameters.hh>
+#include <opm/simulators/linalg/linalgproperties.hh>
+#include <opm/simulators/linalg/overlappingpreconditioner.hh>
+#include <opm/simulators/linalg/parallelamgbackend.hh>
+#include <opm/simulators/linalg/parallelbasebackend.hh>
+#include <opm/simulators/linalg/pressuretransportsplitting.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Opm::Linear {
+
+template <class TypeTag>
+class ParallelCprBackend;
+
+} // namespace Opm::Linear
+
+namespace Opm::Properties {
+
+// Create new type tags
+namespace TTag {
+
+struct ParallelCprLinearSolver
+{ using InheritsFrom = std::tuple<ParallelBaseLinearSolver>; };
+
+} // end namespace TTag
+
+template<class TypeTag>
+struct LinearSolverBackend<TypeTag, TTag::ParallelCprLinearSolver>
+{ using type = Opm::Linear::ParallelCprBackend<TypeTag>; };
+
+} // namespace Opm::Properties
+
+namespace Opm::Parameters {
+
+//! The method used to compute the weights of the equations which form the pressure
+//! system of the CPR preconditioner. Either "quasiimpes" or "trueimpes".
+struct CprWeights { static constexpr auto value = "quasiimpes"; };
+
+} // namespace Opm::Parameters
+
+namespace Opm::Linear {
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Provides a linear solver backend which uses BiCGStab preconditioned by a
+ *        two-stage constrained pressure residual (CPR) preconditioner.
+ *
+ * The pressure system is formed from the Jacobian by weighting the equations of each
+ * degree of freedom. With the quasi-IMPES approach, the weights are derived from the
+ * diagonal blocks of the Jacobian, with true-IMPES they are derived from the
+ * derivatives of the storage term. The pressure system is then solved by an AMG and
+ * the full system is smoothed by block-ILU(0).
+ *
+ * In parallel, the CPR preconditioner is applied on the overlapping domain of each
+ * process, i.e., the pressure AMG is a per-process one which is combined in an
+ * additive Schwarz fashion.
+ */
+template <class TypeTag>
+class ParallelCprBackend : public ParallelBaseBackend<TypeTag>
+{
+    using ParentType = ParallelBaseBackend<TypeTag>;
+
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using Indices = GetPropType<TypeTag, Properties::Indices>;
+    using Overlap = GetPropType<TypeTag, Properties::Overlap>;
+    using OverlappingMatrix = GetPropType<TypeTag, Properties::OverlappingMatrix>;
+    using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+
+    using ParallelOperator = typename ParentType::ParallelOperator;
+    using OverlappingVector = typename ParentType::OverlappingVector;
+    using ParallelScalarProduct = typename ParentType::ParallelScalarProduct;
+
+    static constexpr int numEq = getPropValue<TypeTag, Properties::NumEq>();
+    static constexpr int pressureIdx = PressureVariableIndex<Indices>::value;
+
+    using MatrixBlock = typename SparseMatrixAdapter::MatrixBlock;
+    using Cpr = CprPreconditioner<OverlappingMatrix, OverlappingVector>;
+    using WeightVector = typename Cpr::WeightVector;
+    using LinearSolverScalar = typename WeightVector::field_type;
+    using ParallelPreconditioner = OverlappingPreconditioner<Cpr, Overlap>;
+
+    using RawLinearSolver = BiCGStabSolver<ParallelOperator,
+                                           OverlappingVector,
+                                           ParallelPreconditioner>;
+
+    static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
+                  "The ParallelCprBackend linear solver backend requires the IstlSparseMatrixAdapter");
+
+public:
+    ParallelCprBackend(const Simulator& simulator)
+        : ParentType(simulator)
+    {
+        const std::string weights = Parameters::Get<Parameters::CprWeights>();
+        if (weights == "trueimpes")
+            trueImpes_ = true;
+        else if (weights == "quasiimpes")
+            trueImpes_ = false;
+        else
+            throw std::invalid_argument("Unknown method for the CPR weights: '" + weights + "'");
+
+        reuseHierarchy_ = Parameters::Get<Parameters::AmgReuseHierarchy>();
+    }
+
+    ~ParallelCprBackend()
+    {
+        if (numSetups_ > 0 && this->simulator_.gridView().comm().rank() == 0 &&
+            Parameters::Get<Parameters::LinearSolverVerbosity>() > 0)
+        {
+            std::cout << "CPR preconditioner:\n"
+                      << "  setups: " << numSetups_ << "\n"
+                      << "  setup time: " << setupTimer_.realTimeElapsed() << " s ("
+                      << setupTimer_.realTimeElapsed()/numSetups_ << " s per linear solve)\n"
+                      << std::flush;
+        }
+    }
+
+    static void registerParameters()
+    {
+        ParentType::registerParameters();
+
+        Parameters::Register<Parameters::LinearSolverMaxError<Scalar>>
+            ("The maximum residual error which the linear solver tolerates "
+             "without giving up");
+        Parameters::Register<Parameters::AmgCoarsenTarget>
+            ("The coarsening target for the agglomerations of "
+             "the AMG preconditioner");
+        Parameters::Register<Parameters::AmgReuseHierarchy>
+            ("Keep the aggregates of the AMG hierarchy between linear solves and "
+             "only recompute the coarse level matrices and the smoothers");
+        Parameters::Register<Parameters::CprWeights>
+            ("The method used to compute the weights of the pressure system of the "
+             "CPR preconditioner. Possible values: 'quasiimpes', 'trueimpes'");
+    }
+
+    /*!
+     * \brief Returns the timer for the setup of the CPR preconditioner.
+     */
+    const Timer& setupTimer() const
+    { return setupTimer_; }
+
+protected:
+    friend ParentType;
+
+    std::shared_ptr<ParallelPreconditioner> preparePreconditioner_()
+    {
+        // the matrix was not changed since the last solve
+        if (!this->matrixChanged_ && cpr_)
+            return std::make_shared<ParallelPreconditioner>(*cpr_, this->overlappingMatrix_->overlap());
+
+        setupTimer_.start();
+        ++numSetups_;
+
+        int preconditionerIsReady = 1;
+        try {
+            computeWeights_();
+
+            const LinearSolverScalar relaxation =
+                Parameters::Get<Parameters::PreconditionerRelaxation<Scalar>>();
+            if (reuseHierarchy_ && cpr_)
+                // the overlapping matrix is the same object as for the previous solve,
+                // only its values have changed
+                cpr_->update(weights_, relaxation);
+            else {
+                cpr_.reset();
+                cpr_ = std::make_unique<Cpr>(*this->overlappingMatrix_,
+                                             weights_,
+                                             pressureIdx,
+                                             Parameters::Get<Parameters::AmgCoarsenTarget>(),
+                                             GridView::dimension,
+                                             relaxation);
+            }
+        }
+        catch (const Dune::Exception& e) {
+            std::cout << "CPR preconditioner threw exception \"" << e.what()
+                      << " on rank " << this->overlappingMatrix_->overlap().myRank()
+                      << "\n"  << std::flush;
+            preconditionerIsReady = 0;
+        }
+
+        // make sure that the preconditioner is also ready on all peer ranks.
+        preconditionerIsReady = this->simulator_.gridView().comm().min(preconditionerIsReady);
+        setupTimer_.stop();
+        if (!preconditionerIsReady)
+            throw NumericalProblem("Creating the CPR preconditioner failed");
+
+        return std::make_shared<ParallelPreconditioner>(*cpr_, this->overlappingMatrix_->overlap());
+    }
+
+    void cleanupPreconditioner_()
+    {
+        // the preconditioner is kept until the matrix changes
+    }
+
+    void cleanup_()
+    {
+        // the CPR preconditioner refers to the overlapping matrix
+        cpr_.reset();
+
+        ParentType::cleanup_();
+    }
+
+    std::shared_ptr<RawLinearSolver> prepareSolver_(ParallelOperator& parOperator,
+                                                    ParallelScalarProduct& parScalarProduct,
+                                                    ParallelPreconditioner& parPreCond)
+    {
+        const auto& gridView = this->simulator_.gridView();
+        using CCC = CombinedCriterion<OverlappingVector, decltype(gridView.comm())>;
+
+        Scalar linearSolverTolerance = Parameters::Get<Parameters::LinearSolverTolerance<Scalar>>();
+        Scalar linearSolverAbsTolerance = Parameters::Get<Parameters::LinearSolverAbsTolerance<Scalar>>();
+        if(linearSolverAbsTolerance < 0.0)
+            linearSolverAbsTolerance = this->simulator_.model().newtonMethod().tolerance() / 100.0;
+
+        convCrit_.reset(new CCC(gridView.comm(),
+                                /*residualReductionTolerance=*/linearSolverTolerance,
+                                /*absoluteResidualTolerance=*/linearSolverAbsTolerance,
+                                Parameters::Get<Parameters::LinearSolverMaxError<Scalar>>()));
+
+        auto bicgstabSolver =
+            std::make_shared<RawLinearSolver>(parPreCond, *convCrit_, parScalarProduct);
+
+        int verbosity = 0;
+        if (parOperator.overlap().myRank() == 0)
+            verbosity = Parameters::Get<Parameters::LinearSolverVerbosity>();
+        bicgstabSolver->setVerbosity(verbosity);
+        bicgstabSolver->setMaxIterations(Parameters::Get<Parameters::LinearSolverMaxIterations>());
+        bicgstabSolver->setLinearOperator(&parOperator);
+        bicgstabSolver->setRhs(this->overlappingb_);
+
+        return bicgstabSolver;
+    }
+
+    std::pair<bool,int> runSolver_(std::shared_ptr<RawLinearSolver> solver)
+    {
+        bool converged = solver->apply(*this->overlappingx_);
+        return std::make_pair(converged, int(solver->report().iterations()));
+    }
+
+    void cleanupSolver_()
+    { /* nothing to do */ }
+
+private:
+    // compute the weights of the equations for all domestic rows of the overlapping
+    // matrix
+    void computeWeights_()
+    {
+        const auto& matrix = *this->overlappingMatrix_;
+        const auto& overlap = matrix.overlap();
+        const std::size_t numDomestic = matrix.N();
+
+        weights_.resize(numDomestic);
+
+        // the true-IMPES weights can only be computed for the degrees of freedom of the
+        // local grid. all others use the quasi-IMPES weights.
+        if (trueImpes_)
+            computeStorageDerivatives_();
+
+        for (std::size_t domIdx = 0; domIdx < numDomestic; ++domIdx) {
+            const Index nativeIdx = overlap.domesticToNative(static_cast<Index>(domIdx));
+            if (trueImpes_ && nativeIdx >= 0 &&
+                static_cast<std::size_t>(nativeIdx) < hasStorageDerivatives_.size() &&
+                hasStorageDerivatives_[nativeIdx])
+            {
+                computeQuasiImpesWeight(weights_[domIdx], storageDerivatives_[nativeIdx], pressureIdx);
+            }
+            else
+                computeQuasiImpesWeight(weights_[domIdx], matrix[domIdx][domIdx], pressureIdx);
+        }
+    }
+
+    // compute the derivatives of the storage term of each degree of freedom of the
+    // local grid with regard to its primary variables
+    void computeStorageDerivatives_()
+    {
+        hasStorageDerivatives_.clear();
+
+        if constexpr (!std::is_same_v<Evaluation, Scalar>) {
+            // with finite differences, the storage derivatives are not available, so
+            // the quasi-IMPES weights are used in this case
+            auto& simulator = const_cast<Simulator&>(this->simulator_);
+            const auto& model = simulator.model();
+            const auto& localResidual = model.localResidual(/*threadId=*/0);
+
+            storageDerivatives_.resize(model.numGridDof());
+            hasStorageDerivatives_.assign(model.numGridDof(), false);
+
+            // the storage term only depends on the intensive quantities of the degree of
+            // freedom itself, so it suffices to evaluate it once per degree of freedom.
+            ElementContext elemCtx(simulator);
+            Dune::FieldVector<Evaluation, numEq> storage;
+            for (const auto& elem : elements(simulator.gridView(), Dune::Partitions::interior)) {
+                elemCtx.updatePrimaryStencil(elem);
+                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+
+                for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
+                    const unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                    if (hasStorageDerivatives_[globalIdx])
+                        continue;
+                    hasStorageDerivatives_[globalIdx] = true;
+
+                    localResidual.computeStorage(storage, elemCtx, dofIdx, /*timeIdx=*/0);
+                    auto& block = storageDerivatives_[globalIdx];
+                    for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                        for (int pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                            block[eqIdx][pvIdx] = storage[eqIdx].derivative(pvIdx);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<ConvergenceCriterion<OverlappingVector> > convCrit_;
+    std::unique_ptr<Cpr> cpr_;
+    WeightVector weights_;
+    std::vector<MatrixBlock> storageDerivatives_;
+    std::vector<bool> hasStorageDerivatives_;
+
+    bool trueImpes_;
+    bool reuseHierarchy_;
+
+    Timer setupTimer_;
+    unsigned numSetups_{0};
+};
+
+} // namespace Opm::Linear
+
+#endif
@@ -0,0 +1,398 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::Linear::PressureTransportSplitting
+ */
+#ifndef EWOMS_PRESSURE_TRANSPORT_SPLITTING_HH
+#define EWOMS_PRESSURE_TRANSPORT_SPLITTING_HH
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace Opm::Linear {
+
+namespace detail {
+
+template <class Indices, class = void>
+struct Pressure0Index
+{ static constexpr int value = 0; };
+
+template <class Indices>
+struct Pressure0Index<Indices, std::void_t<decltype(Indices::pressure0Idx)> >
+{ static constexpr int value = Indices::pressure0Idx; };
+
+} // namespace detail
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Determines the index of the primary variable which represents pressure.
+ *
+ * The black-oil models call it pressureSwitchIdx, most other models pressure0Idx.
+ */
+template <class Indices, class = void>
+struct PressureVariableIndex : public detail::Pressure0Index<Indices>
+{ };
+
+template <class Indices>
+struct PressureVariableIndex<Indices, std::void_t<decltype(Indices::pressureSwitchIdx)> >
+{ static constexpr int value = Indices::pressureSwitchIdx; };
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Computes the quasi-IMPES weights of the equations of a degree of freedom.
+ *
+ * The weights w of a block B are given by B^T w = e_p, where e_p is the unit vector of
+ * the pressure variable. i.e., the weighted sum of the equations is independent of all
+ * variables except pressure. The weights are scaled to a maximum of one. If the block
+ * is singular, all weights are one.
+ */
+template <class Weight, class Block>
+void computeQuasiImpesWeight(Weight& weight, const Block& block, unsigned pressureIdx)
+{
+    using Field = typename Weight::field_type;
+    constexpr int numEq = Weight::dimension;
+
+    Dune::FieldMatrix<Field, numEq, numEq> blockT;
+    for (int i = 0; i < numEq; ++i)
+        for (int j = 0; j < numEq; ++j)
+            blockT[i][j] = block[j][i];
+
+    Weight rhs(0.0);
+    rhs[pressureIdx] = 1.0;
+
+    try {
+        blockT.solve(weight, rhs);
+    }
+    catch (const Dune::FMatrixError&) {
+        // singular block: fall back to the sum of all equations
+        weight = 1.0;
+        return;
+    }
+
+    // scale the weights so that the pressure system is not badly scaled
+    const Field maxWeight = weight.infinity_norm();
+    if (maxWeight > 0.0 && std::isfinite(maxWeight))
+        weight /= maxWeight;
+    else
+        weight = 1.0;
+}
+
+/*!
+ * \ingroup Linear
+ *
+ * \brief Splits the linearized system of equations of a sequential implicit
+ *        time integration into a pressure and a transport part.
+ *
+ * The pressure system is the weighted sum of the equations of each degree of freedom,
+ * where the weights are the quasi-IMPES ones of the fully implicit Jacobian, and only
+ * its derivatives with regard to pressure are considered. This scalar system is solved
+ * using BiCGStab preconditioned by ILU(0).
+ *
+ * For the transport system, the pressure is kept fixed. One equation per degree of
+ * freedom is redundant in this case and is dropped, namely the one whose index is
+ * that of the pressure variable. The remaining equations and variables form a block
+ * system with one row and column less per block than the fully implicit one, which is
+ * solved using BiCGStab preconditioned by ILU(0) as well.
+ *
+ * Since the pressure and the transport linearizations only provide some columns of
+ * the Jacobian, the diagonal blocks from which the weights are computed are
+ * assembled from the latest linearization of either kind.
+ */
+template <class Matrix, class Vector>
+class PressureTransportSplitting
+{
+    using Scalar = typename Vector::field_type;
+    static constexpr int numEq = Vector::block_type::dimension;
+    // models with a single equation do not have a transport system. the block size
+    // must be positive nevertheless
+    static constexpr int numTransportEq = numEq > 1 ? numEq - 1 : 1;
+
+    using Block = Dune::FieldMatrix<Scalar, numEq, numEq>;
+    using BlockVector = Dune::BlockVector<Block>;
+
+    using PressureMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, 1, 1> >;
+    using PressureVector = Dune::BlockVector<Dune::FieldVector<Scalar, 1> >;
+    using PressureOperator = Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector>;
+    using PressureIlu = Dune::SeqILU<PressureMatrix, PressureVector, PressureVector>;
+    using PressureSolver = Dune::BiCGSTABSolver<PressureVector>;
+
+    using TransportMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, numTransportEq, numTransportEq> >;
+    using TransportVector = Dune::BlockVector<Dune::FieldVector<Scalar, numTransportEq> >;
+    using TransportOperator = Dune::MatrixAdapter<TransportMatrix, TransportVector, TransportVector>;
+    using TransportIlu = Dune::SeqILU<TransportMatrix, TransportVector, TransportVector>;
+    using TransportSolver = Dune::BiCGSTABSolver<TransportVector>;
+
+public:
+    using WeightVector = Dune::BlockVector<Dune::FieldVector<Scalar, numEq> >;
+
+    explicit PressureTransportSplitting(unsigned pressureIdx)
+        : pressureIdx_(pressureIdx)
+    { assert(pressureIdx_ < static_cast<unsigned>(numEq)); }
+
+    /*!
+     * \brief Returns true if the equations can be split, i.e., if there is at least
+     *        one equation besides the pressure one.
+     */
+    static constexpr bool splittable()
+    { return numEq > 1; }
+
+    /*!
+     * \brief Store the diagonal blocks of a fully implicit Jacobian.
+     */
+    void setDiagonal(const Matrix& jacobian)
+    {
+        const std::size_t numRows = jacobian.N();
+        diagonal_.resize(numRows);
+        for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+            diagonal_[rowIdx] = jacobian[rowIdx][rowIdx];
+    }
+
+    /*!
+     * \brief Update the pressure column of the stored diagonal blocks using a Jacobian
+     *        which was linearized with regard to pressure.
+     */
+    void updateDiagonalPressure(const Matrix& jacobian)
+    {
+        assert(diagonal_.size() == jacobian.N());
+        for (std::size_t rowIdx = 0; rowIdx < diagonal_.size(); ++rowIdx) {
+            const auto& block = jacobian[rowIdx][rowIdx];
+            for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                diagonal_[rowIdx][eqIdx][pressureIdx_] = block[eqIdx][pressureIdx_];
+        }
+    }
+
+    /*!
+     * \brief Update all columns but the pressure one of the stored diagonal blocks using
+     *        a Jacobian which was linearized at fixed pressure.
+     */
+    void updateDiagonalTransport(const Matrix& jacobian)
+    {
+        assert(diagonal_.size() == jacobian.N());
+        for (std::size_t rowIdx = 0; rowIdx < diagonal_.size(); ++rowIdx) {
+            const auto& block = jacobian[rowIdx][rowIdx];
+            for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                for (int pvIdx = 0; pvIdx < numEq; ++pvIdx)
+                    if (pvIdx != static_cast<int>(pressureIdx_))
+                        diagonal_[rowIdx][eqIdx][pvIdx] = block[eqIdx][pvIdx];
+        }
+    }
+
+    /*!
+     * \brief Compute the weights of the pressure equation from the stored diagonal
+     *        blocks.
+     */
+    void computeWeights()
+    {
+        weights_.resize(diagonal_.size());
+        for (std::size_t rowIdx = 0; rowIdx < diagonal_.size(); ++rowIdx)
+            computeQuasiImpesWeight(weights_[rowIdx], diagonal_[rowIdx], pressureIdx_);
+    }
+
+    /*!
+     * \brief Form the pressure system from a Jacobian and a residual.
+     *
+     * Only the derivatives with regard to pressure are used, so the Jacobian may
+     * either be the fully implicit one or one linearized for pressure only. Returns
+     * the maximum norm of the residual of the pressure system.
+     */
+    Scalar assemblePressureSystem(const Matrix& jacobian, const Vector& residual)
+    {
+        assert(weights_.size() == jacobian.N());
+
+        if (!pressureMatrix_ ||
+            pressureMatrix_->N() != jacobian.N() ||
+            pressureMatrix_->nonzeroes() != jacobian.nonzeroes())
+            pressureMatrix_ = createMatrix_<PressureMatrix>(jacobian, pressureRhs_, pressureSol_);
+
+        Scalar norm = 0.0;
+        auto rowIt = pressureMatrix_->begin();
+        const auto rowEndIt = jacobian.end();
+        for (auto srcRowIt = jacobian.begin(); srcRowIt != rowEndIt; ++srcRowIt, ++rowIt) {
+            const std::size_t rowIdx = srcRowIt.index();
+            const auto& w = weights_[rowIdx];
+
+            auto colIt = rowIt->begin();
+            const auto colEndIt = srcRowIt->end();
+            for (auto srcColIt = srcRowIt->begin(); srcColIt != colEndIt; ++srcColIt, ++colIt) {
+                Scalar value = 0.0;
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    value += w[eqIdx]*(*srcColIt)[eqIdx][pressureIdx_];
+                *colIt = value;
+            }
+
+            pressureRhs_[rowIdx] = w*residual[rowIdx];
+            norm = std::max<Scalar>(norm, std::abs(pressureRhs_[rowIdx][0]));
+        }
+
+        return norm;
+    }
+
+    /*!
+     * \brief Solve the pressure system assembled last.
+     *
+     * The update of the pressure variable is written to the solution update, all other
+     * components of it are zero. Returns true if the linear solver converged.
+     */
+    bool solvePressureSystem(Vector& solutionUpdate, Scalar reduction, int maxIterations)
+    {
+        PressureOperator pressureOperator(*pressureMatrix_);
+        PressureIlu ilu(*pressureMatrix_, /*relaxation=*/1.0);
+        PressureSolver solver(pressureOperator, ilu, reduction, maxIterations, /*verbose=*/0);
+
+        Dune::InverseOperatorResult result;
+        pressureSol_ = 0.0;
+        solver.apply(pressureSol_, pressureRhs_, result);
+
+        solutionUpdate = 0.0;
+        for (std::size_t rowIdx = 0; rowIdx < pressureSol_.size(); ++rowIdx)
+            solutionUpdate[rowIdx][pressureIdx_] = pressureSol_[rowIdx][0];
+
+        return result.converged;
+    }
+
+    /*!
+     * \brief Form the transport system at fixed pressure from a Jacobian and a
+     *        residual.
+     *
+     * The row of the pressure equation and the column of the pressure variable are
+     * dropped from each block. Returns the maximum norm of the residual of the
+     * transport system.
+     */
+    Scalar assembleTransportSystem(const Matrix& jacobian, const Vector& residual)
+    {
+        if (!transportMatrix_ ||
+            transportMatrix_->N() != jacobian.N() ||
+            transportMatrix_->nonzeroes() != jacobian.nonzeroes())
+            transportMatrix_ = createMatrix_<TransportMatrix>(jacobian, transportRhs_, transportSol_);
+
+        Scalar norm = 0.0;
+        auto rowIt = transportMatrix_->begin();
+        const auto rowEndIt = jacobian.end();
+        for (auto srcRowIt = jacobian.begin(); srcRowIt != rowEndIt; ++srcRowIt, ++rowIt) {
+            const std::size_t rowIdx = srcRowIt.index();
+
+            auto colIt = rowIt->begin();
+            const auto colEndIt = srcRowIt->end();
+            for (auto srcColIt = srcRowIt->begin(); srcColIt != colEndIt; ++srcColIt, ++colIt) {
+                const auto& block = *srcColIt;
+                for (int eqIdx = 0; eqIdx < numTransportEq; ++eqIdx)
+                    for (int pvIdx = 0; pvIdx < numTransportEq; ++pvIdx)
+                        (*colIt)[eqIdx][pvIdx] = block[fullIndex_(eqIdx)][fullIndex_(pvIdx)];
+            }
+
+            for (int eqIdx = 0; eqIdx < numTransportEq; ++eqIdx) {
+                transportRhs_[rowIdx][eqIdx] = residual[rowIdx][fullIndex_(eqIdx)];
+                norm = std::max<Scalar>(norm, std::abs(transportRhs_[rowIdx][eqIdx]));
+            }
+        }
+
+        return norm;
+    }
+
+    /*!
+     * \brief Solve the transport system assembled last.
+     *
+     * The pressure component of the solution update is zero. Returns true if the
+     * linear solver converged.
+     */
+    bool solveTransportSystem(Vector& solutionUpdate, Scalar reduction, int maxIterations)
+    {
+        TransportOperator transportOperator(*transportMatrix_);
+        TransportIlu ilu(*transportMatrix_, /*relaxation=*/1.0);
+        TransportSolver solver(transportOperator, ilu, reduction, maxIterations, /*verbose=*/0);
+
+        Dune::InverseOperatorResult result;
+        transportSol_ = 0.0;
+        solver.apply(transportSol_, transportRhs_, result);
+
+        solutionUpdate = 0.0;
+        for (std::size_t rowIdx = 0; rowIdx < transportSol_.size(); ++rowIdx)
+            for (int eqIdx = 0; eqIdx < numTransportEq; ++eqIdx)
+                solutionUpdate[rowIdx][fullIndex_(eqIdx)] = transportSol_[rowIdx][eqIdx];
+
+        return result.converged;
+    }
+
+private:
+    // maps an index of the transport system to the one of the full system
+    int fullIndex_(int transportIdx) const
+    { return transportIdx < static_cast<int>(pressureIdx_) ? transportIdx : transportIdx + 1; }
+
+    // create a matrix which uses the same sparsity pattern as the full system
+    template <class ReducedMatrix, class ReducedVector>
+    static std::unique_ptr<ReducedMatrix> createMatrix_(const Matrix& jacobian,
+                                                        ReducedVector& rhs,
+                                                        ReducedVector& sol)
+    {
+        const std::size_t numRows = jacobian.N();
+        auto matrix = std::make_unique<ReducedMatrix>(numRows,
+                                                      numRows,
+                                                      jacobian.nonzeroes(),
+                                                      ReducedMatrix::row_wise);
+
+        auto srcRowIt = jacobian.begin();
+        for (auto rowIt = matrix->createbegin(); rowIt != matrix->createend(); ++rowIt, ++srcRowIt) {
+            const auto colEndIt = srcRowIt->end();
+            for (auto colIt = srcRowIt->begin(); colIt != colEndIt; ++colIt)
+                rowIt.insert(colIt.index());
+        }
+
+        rhs.resize(numRows);
+        sol.resize(numRows);
+
+        return matrix;
+    }
+
+    unsigned pressureIdx_;
+
+    BlockVector diagonal_;
+    WeightVector weights_;
+
+    std::unique_ptr<PressureMatrix> pressureMatrix_;
+    PressureVector pressureRhs_;
+    PressureVector pressureSol_;
+
+    std::unique_ptr<TransportMatrix> transportMatrix_;
+    TransportVector transportRhs_;
+    TransportVector transportSol_;
+};
+
+} // namespace Opm::Linear
+
+#endif
@@ -0,0 +1,60 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Two-phase test for the immiscible model which uses the element-centered finite
+ *        volume discretization in conjunction with automatic differentiation and
+ *        which replaces the global allocation functions to audit the heap
+ *        allocations of the simulator's kernels.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <opm/models/utils/allocationauditoperators.hh>
+#include <opm/models/utils/start.hh>
+
+#include <cstddef>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    using ProblemTypeTag = Opm::Properties::TTag::LensProblemEcfvAd;
+    const int ret = Opm::start<ProblemTypeTag>(argc, argv);
+    if (ret != 0)
+        return ret;
+
+    // the simulation is run in report mode, so that all regions which allocate
+    // memory are listed by start() instead of aborting at the first allocation
+    std::size_t numAllocations = 0;
+    for (const auto& [name, stats] : Opm::AllocationAudit::statistics())
+        numAllocations += stats.numAllocations;
+
+    if (numAllocations > 0) {
+        std::cerr << numAllocations << " heap allocations within no-allocation regions\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -389,6 +389,12 @@ public:
         return temperature_;
     }
 
+    /*!
+     * \copydoc MultiPhaseBaseProblem::spatialParametersAreTimeInvariant
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return true; }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::intrinsicPermeability
      */
@@ -371,6 +371,15 @@ public:
     Scalar temperature(const Context& /*context*/, unsigned /*spaceIdx*/, unsigned /*timeIdx*/) const
     { return temperature_; }
 
+    /*!
+     * \copydoc MultiPhaseBaseProblem::spatialParametersAreTimeInvariant
+     *
+     * The intrinsic permeability is the same everywhere, but the faces change if
+     * the grid is adapted.
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return !this->model().enableGridAdaptation(); }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::intrinsicPermeability
      */
@@ -349,6 +349,12 @@ public:
      */
     //! \{
 
+    /*!
+     * \copydoc MultiPhaseBaseProblem::spatialParametersAreTimeInvariant
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return true; }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::intrinsicPermeability
      */
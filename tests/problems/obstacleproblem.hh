@@ -323,6 +323,12 @@ public:
                        unsigned /*timeIdx*/) const
     { return temperature_; }
 
+    /*!
+     * \copydoc MultiPhaseBaseProblem::spatialParametersAreTimeInvariant
+     */
+    bool spatialParametersAreTimeInvariant() const
+    { return true; }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::intrinsicPermeability
      */
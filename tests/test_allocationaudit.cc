@@ -0,0 +1,142 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test which makes sure that the heap allocations inside of no-allocation
+ *        regions are attributed to the correct region.
+ */
+#include "config.h"
+
+#include <opm/models/utils/allocationauditoperators.hh>
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Opm::AllocationAudit;
+using Opm::NoAllocationRegion;
+
+void check(bool condition, const char* msg)
+{
+    if (!condition)
+        throw std::logic_error(msg);
+}
+
+// makes the memory escape, so that the compiler cannot elide the allocations
+const void* volatile sink = nullptr;
+
+std::size_t numAllocations(const std::string& regionName)
+{
+    const auto stats = AllocationAudit::statistics();
+    const auto it = stats.find(regionName);
+    return it == stats.end() ? 0 : it->second.numAllocations;
+}
+
+int main()
+{
+    check(AllocationAudit::operatorsInstalled(), "the replaced operator new was not registered");
+
+    // the regions do nothing if the audit is disabled
+    {
+        NoAllocationRegion region("disabled");
+        auto ptr = std::make_unique<double>(1.0);
+        sink = ptr.get();
+    }
+    check(numAllocations("disabled") == 0, "allocations recorded while the audit was disabled");
+
+    AllocationAudit::setMode(AllocationAudit::Mode::report);
+
+    // allocations are attributed to the innermost region, but not to regions which
+    // were already left
+    {
+        NoAllocationRegion outerRegion("outer");
+        std::vector<int> v(10);
+        sink = v.data();
+        {
+            NoAllocationRegion innerRegion("inner");
+            std::vector<int> w(3);
+            std::vector<int> x(4);
+            sink = w.data();
+            sink = x.data();
+        }
+        check(outerRegion.numAllocations() == 1, "wrong number of allocations of the outer region");
+    }
+    std::vector<int> outside(5);
+    sink = outside.data();
+
+    check(numAllocations("outer") == 1, "wrong number of allocations in the outer region");
+    check(numAllocations("inner") == 2, "wrong number of allocations in the inner region");
+
+    // allocations are not recorded while the audit is suspended, e.g. while the
+    // message of an exception is built
+    {
+        NoAllocationRegion region("suspended");
+        try {
+            AllocationAudit::SuspendGuard suspendAudit;
+            throw std::runtime_error(std::string(64, 'x'));
+        }
+        catch (const std::runtime_error&) {
+        }
+
+        auto ptr = std::make_unique<double>(1.0);
+        sink = ptr.get();
+    }
+    check(numAllocations("suspended") == 1, "allocations recorded while the audit was suspended");
+
+    // no allocations are recorded for regions without any
+    {
+        NoAllocationRegion region("empty");
+        int a[4] = {1, 2, 3, 4};
+        check(a[3] == 4, "stack memory is broken");
+    }
+    check(AllocationAudit::statistics().count("empty") == 0,
+          "region without allocations shows up in the statistics");
+
+    // the regions are per thread
+    std::vector<std::thread> threads;
+    {
+        NoAllocationRegion region("main thread");
+        threads.reserve(4);
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back([]() {
+                NoAllocationRegion threadRegion("worker");
+                auto ptr = std::make_unique<double[]>(8);
+                sink = ptr.get();
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    check(numAllocations("worker") == 4, "wrong number of allocations in the worker threads");
+
+    AllocationAudit::report(std::cout);
+
+    AllocationAudit::reset();
+    check(AllocationAudit::statistics().empty(), "statistics not empty after resetting them");
+
+    AllocationAudit::setMode(AllocationAudit::Mode::disabled);
+
+    return 0;
+}
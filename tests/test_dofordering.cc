@@ -0,0 +1,121 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the orderings of the degrees of freedom.
+ */
+#include "config.h"
+
+#include <opm/models/discretization/common/dofordering.hh>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+constexpr unsigned nx = 30;
+constexpr unsigned ny = 20;
+
+// a pseudo-random numbering of the cells of a structured grid
+unsigned scrambledIndex(unsigned i, unsigned j)
+{ return ((j*nx + i)*7919) % (nx*ny); }
+
+// the graph of the five-point stencil of the scrambled grid and the centers of its
+// cells
+Opm::DofGraph createGraph(std::vector<std::array<double, 2>>& centers)
+{
+    const unsigned numCells = nx*ny;
+    std::vector<std::vector<unsigned>> neighbors(numCells);
+    centers.resize(numCells);
+    for (unsigned j = 0; j < ny; ++j) {
+        for (unsigned i = 0; i < nx; ++i) {
+            const unsigned cellIdx = scrambledIndex(i, j);
+            centers[cellIdx] = {i + 0.5, j + 0.5};
+            if (i > 0)
+                neighbors[cellIdx].push_back(scrambledIndex(i - 1, j));
+            if (i < nx - 1)
+                neighbors[cellIdx].push_back(scrambledIndex(i + 1, j));
+            if (j > 0)
+                neighbors[cellIdx].push_back(scrambledIndex(i, j - 1));
+            if (j < ny - 1)
+                neighbors[cellIdx].push_back(scrambledIndex(i, j + 1));
+        }
+    }
+
+    Opm::DofGraph graph;
+    for (const auto& cellNeighbors : neighbors) {
+        graph.neighbors.insert(graph.neighbors.end(), cellNeighbors.begin(), cellNeighbors.end());
+        graph.offsets.push_back(graph.neighbors.size());
+    }
+    return graph;
+}
+
+void checkPermutation(const std::vector<unsigned>& newIndex, std::size_t size)
+{
+    if (newIndex.size() != size)
+        throw std::logic_error("the ordering has the wrong size");
+
+    std::vector<bool> used(size, false);
+    for (const unsigned idx : newIndex) {
+        if (idx >= size || used[idx])
+            throw std::logic_error("the ordering is not a permutation");
+        used[idx] = true;
+    }
+}
+
+int main()
+{
+    if (Opm::parseDofOrdering("rcm") != Opm::DofOrdering::reverseCuthillMcKee ||
+        Opm::parseDofOrdering("morton") != Opm::DofOrdering::morton ||
+        Opm::parseDofOrdering("none") != Opm::DofOrdering::none)
+        throw std::logic_error("wrong ordering parsed");
+
+    std::vector<std::array<double, 2>> centers;
+    const Opm::DofGraph graph = createGraph(centers);
+    const auto scrambled = Opm::dofOrderingQuality(graph);
+
+    const auto rcm = Opm::reverseCuthillMcKeeOrdering(graph);
+    checkPermutation(rcm, graph.numVertices());
+    const auto rcmQuality = Opm::dofOrderingQuality(graph, rcm);
+
+    const auto morton = Opm::mortonOrdering(centers);
+    checkPermutation(morton, graph.numVertices());
+    const auto mortonQuality = Opm::dofOrderingQuality(graph, morton);
+
+    std::cout << "scrambled: bandwidth " << scrambled.bandwidth
+              << ", mean distance " << scrambled.meanDistance << "\n"
+              << "rcm: bandwidth " << rcmQuality.bandwidth
+              << ", mean distance " << rcmQuality.meanDistance << "\n"
+              << "morton: bandwidth " << mortonQuality.bandwidth
+              << ", mean distance " << mortonQuality.meanDistance << "\n";
+
+    // the bandwidth of the reverse Cuthill-McKee ordering is bounded by the size of
+    // the shorter side of the grid plus one
+    if (rcmQuality.bandwidth > ny + 1)
+        throw std::logic_error("reverse Cuthill-McKee ordering does not reduce the bandwidth");
+    if (mortonQuality.meanDistance >= scrambled.meanDistance/4)
+        throw std::logic_error("Morton ordering does not improve the locality");
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test which makes sure that the element contexts allocate the storage for
+ *        their intensive and extensive quantities only once.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <opm/models/utils/start.hh>
+
+#include <iostream>
+#include <stdexcept>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#endif
+
+int main(int argc, char **argv)
+{
+    using TypeTag = Opm::Properties::TTag::LensProblemEcfvAd;
+    using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+    using ElementContext = Opm::GetPropType<TypeTag, Opm::Properties::ElementContext>;
+    using ThreadManager = Opm::GetPropType<TypeTag, Opm::Properties::ThreadManager>;
+
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    const char* testArgv[] = { argv[0], "--cells-x=12", "--cells-y=8" };
+    if (Opm::setupParameters_<TypeTag>(3, testArgv) != 0)
+        return 1;
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    const auto& model = simulator.model();
+    if (model.maxNumStencilDof() == 0
+        || model.maxNumStencilPrimaryDof() == 0
+        || model.maxNumStencilInteriorFaces() == 0
+        || model.maxNumStencilBoundaryFaces() == 0)
+        throw std::logic_error("the size of the largest stencil is not known after initialization");
+
+    // the storage for the largest stencil is allocated when the context is constructed
+    ElementContext elemCtx(simulator);
+    if (elemCtx.numStorageAllocations() != 1) {
+        std::cerr << "a new element context allocated its storage "
+                  << elemCtx.numStorageAllocations() << " times\n";
+        throw std::logic_error("the storage of the element context was not allocated up front");
+    }
+
+    // the stencils at the boundary are smaller than the ones in the interior. visiting
+    // all elements must neither shrink nor enlarge the storage
+    for (unsigned sweepIdx = 0; sweepIdx < 2; ++sweepIdx) {
+        for (const auto& elem : elements(simulator.gridView())) {
+            elemCtx.updateAll(elem);
+            const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+            if (stencil.numDof() > model.maxNumStencilDof()
+                || stencil.numPrimaryDof() > model.maxNumStencilPrimaryDof()
+                || stencil.numBoundaryFaces() > model.maxNumStencilBoundaryFaces())
+                throw std::logic_error("the stencil of an element is larger than the largest one");
+        }
+    }
+
+    if (elemCtx.numStorageAllocations() != 1) {
+        std::cerr << "the element context allocated its storage "
+                  << elemCtx.numStorageAllocations() << " times\n";
+        throw std::logic_error("the storage of the element context was re-allocated");
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test which compares the Jacobian-vector products of the matrix-free
+ *        operator with those of the assembled Jacobian.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <opm/models/utils/start.hh>
+#include <opm/simulators/linalg/matrixfreebackend.hh>
+#include <opm/simulators/linalg/parallelbicgstabbackend.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#endif
+
+namespace Opm::Properties {
+
+namespace TTag {
+struct MatrixFreeOperatorTestProblem
+{ using InheritsFrom = std::tuple<LensProblemEcfvAd>; };
+} // end namespace TTag
+
+// compare the products in double precision
+template<class TypeTag>
+struct LinearSolverScalar<TypeTag, TTag::MatrixFreeOperatorTestProblem>
+{ using type = double; };
+
+} // namespace Opm::Properties
+
+int main(int argc, char **argv)
+{
+    using TypeTag = Opm::Properties::TTag::MatrixFreeOperatorTestProblem;
+    using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+    using ThreadManager = Opm::GetPropType<TypeTag, Opm::Properties::ThreadManager>;
+    using GlobalEqVector = Opm::GetPropType<TypeTag, Opm::Properties::GlobalEqVector>;
+    using SolutionVector = Opm::GetPropType<TypeTag, Opm::Properties::SolutionVector>;
+    using BorderListCreator = Opm::GetPropType<TypeTag, Opm::Properties::BorderListCreator>;
+    using Overlap = Opm::GetPropType<TypeTag, Opm::Properties::Overlap>;
+    using OverlappingVector = Opm::GetPropType<TypeTag, Opm::Properties::OverlappingVector>;
+    using Operator = Opm::Linear::MatrixFreeOperator<TypeTag>;
+
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    // a small grid is sufficient; two threads exercise the accumulation of the
+    // per-thread contributions
+    const char* testArgv[] = { argv[0], "--cells-x=12", "--cells-y=8", "--threads-per-process=2" };
+    if (Opm::setupParameters_<TypeTag>(4, testArgv) != 0)
+        return 1;
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    auto& model = simulator.model();
+    model.applyInitialSolution();
+
+    // move away from the initial condition so that the Jacobian couples all primary
+    // variables
+    auto& solution = model.solution(/*timeIdx=*/0);
+    for (unsigned dofIdx = 0; dofIdx < solution.size(); ++dofIdx) {
+        solution[dofIdx][0] *= 1.0 + 1e-3*std::sin(0.3*dofIdx);
+        solution[dofIdx][1] += 0.05*(1.0 + std::sin(0.7*dofIdx));
+    }
+    model.invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+    const SolutionVector solutionBefore = solution;
+
+    auto& linearizer = model.linearizer();
+    linearizer.linearizeDomain();
+    const auto& jacobian = linearizer.jacobian().istlMatrix();
+
+    BorderListCreator borderListCreator(simulator.gridView(), model.dofMapper());
+    Overlap overlap(jacobian,
+                    borderListCreator.borderList(),
+                    borderListCreator.blackList(),
+                    /*overlapSize=*/2);
+
+    Operator op(simulator, overlap);
+    op.linearizeAt();
+
+    for (unsigned vectorIdx = 0; vectorIdx < 3; ++vectorIdx) {
+        GlobalEqVector nativeX(solution.size());
+        for (unsigned dofIdx = 0; dofIdx < nativeX.size(); ++dofIdx)
+            for (unsigned pvIdx = 0; pvIdx < nativeX[dofIdx].size(); ++pvIdx)
+                nativeX[dofIdx][pvIdx] = std::cos(1.3*dofIdx + 0.5*pvIdx + vectorIdx);
+
+        GlobalEqVector expected(nativeX.size());
+        jacobian.mv(nativeX, expected);
+
+        OverlappingVector x(overlap);
+        OverlappingVector y(overlap);
+        x.assign(nativeX);
+        op.apply(x, y);
+        GlobalEqVector result;
+        y.assignTo(result);
+
+        double maxRef = 0.0;
+        double maxDiff = 0.0;
+        for (unsigned dofIdx = 0; dofIdx < expected.size(); ++dofIdx) {
+            for (unsigned eqIdx = 0; eqIdx < expected[dofIdx].size(); ++eqIdx) {
+                maxRef = std::max(maxRef, std::abs(expected[dofIdx][eqIdx]));
+                maxDiff = std::max(maxDiff, std::abs(result[dofIdx][eqIdx] - expected[dofIdx][eqIdx]));
+            }
+        }
+
+        if (maxRef == 0.0 || maxDiff > 1e-10*maxRef) {
+            std::cerr << "matrix-free product " << vectorIdx << " deviates by " << maxDiff
+                      << " from the assembled one (max. entry: " << maxRef << ")\n";
+            throw std::logic_error("wrong Jacobian-vector product");
+        }
+
+        // applyscaleadd() must add the scaled product to the vector
+        OverlappingVector z(overlap);
+        z = 1.0;
+        op.applyscaleadd(0.5, x, z);
+        GlobalEqVector scaledResult;
+        z.assignTo(scaledResult);
+        for (unsigned dofIdx = 0; dofIdx < expected.size(); ++dofIdx) {
+            for (unsigned eqIdx = 0; eqIdx < expected[dofIdx].size(); ++eqIdx) {
+                double diff = scaledResult[dofIdx][eqIdx] - (1.0 + 0.5*result[dofIdx][eqIdx]);
+                if (std::abs(diff) > 1e-10*(1.0 + maxRef))
+                    throw std::logic_error("wrong result of applyscaleadd()");
+            }
+        }
+    }
+
+    // the operator must neither modify the solution nor the caches of the model
+    for (unsigned dofIdx = 0; dofIdx < solution.size(); ++dofIdx)
+        if (solution[dofIdx] != solutionBefore[dofIdx])
+            throw std::logic_error("the matrix-free operator modified the solution");
+    for (unsigned dofIdx = 0; dofIdx < solution.size(); ++dofIdx)
+        if (!model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0))
+            throw std::logic_error("the matrix-free operator invalidated the intensive quantities");
+
+    return 0;
+}
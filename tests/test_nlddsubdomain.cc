@@ -0,0 +1,222 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test for the partitioning of the nonlinear domain decomposition and the
+ *        linear systems of its subdomains.
+ */
+#include "config.h"
+
+#include <opm/models/discretization/common/nlddsubdomain.hh>
+#include <opm/simulators/linalg/nlddlocalsystem.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+constexpr int numEq = 2;
+using Block = Dune::FieldMatrix<double, numEq, numEq>;
+using Matrix = Dune::BCRSMatrix<Block>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, numEq>>;
+
+constexpr int nx = 12;
+constexpr int ny = 10;
+
+// the matrix of a five-point stencil on a structured grid with two coupled equations
+// per cell
+Matrix createMatrix()
+{
+    const int numCells = nx*ny;
+    Matrix matrix(numCells, numCells, 5*numCells, Matrix::row_wise);
+    for (auto rowIt = matrix.createbegin(); rowIt != matrix.createend(); ++rowIt) {
+        const int i = rowIt.index() % nx;
+        const int j = rowIt.index() / nx;
+        if (j > 0)
+            rowIt.insert(rowIt.index() - nx);
+        if (i > 0)
+            rowIt.insert(rowIt.index() - 1);
+        rowIt.insert(rowIt.index());
+        if (i < nx - 1)
+            rowIt.insert(rowIt.index() + 1);
+        if (j < ny - 1)
+            rowIt.insert(rowIt.index() + nx);
+    }
+
+    for (auto rowIt = matrix.begin(); rowIt != matrix.end(); ++rowIt) {
+        for (auto colIt = rowIt->begin(); colIt != rowIt->end(); ++colIt) {
+            if (colIt.index() == rowIt.index()) {
+                *colIt = Block{{5.0, 0.5}, {0.25, 6.0}};
+            }
+            else
+                *colIt = Block{{-1.0, 0.0}, {-0.1, -1.0}};
+        }
+    }
+
+    return matrix;
+}
+
+void testPartition(const Matrix& matrix)
+{
+    const std::size_t numRows = matrix.N();
+    std::vector<bool> active(numRows, true);
+    // the first row of the grid is not part of any subdomain
+    for (int i = 0; i < nx; ++i)
+        active[i] = false;
+
+    const unsigned numDomains = 5;
+    const auto domainOfRow = Opm::partitionMatrixGraph(matrix, active, numDomains);
+
+    const std::size_t numActive = numRows - nx;
+    const std::size_t maxSize = (numActive + numDomains - 1)/numDomains;
+    std::vector<std::size_t> domainSize(numDomains, 0);
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        const int domainIdx = domainOfRow[rowIdx];
+        if (!active[rowIdx]) {
+            if (domainIdx != -1)
+                throw std::logic_error("inactive row was assigned to a subdomain");
+            continue;
+        }
+
+        if (domainIdx < 0 || domainIdx >= static_cast<int>(numDomains))
+            throw std::logic_error("active row was not assigned to a valid subdomain");
+        ++domainSize[domainIdx];
+    }
+
+    for (unsigned domainIdx = 0; domainIdx < numDomains; ++domainIdx) {
+        if (domainSize[domainIdx] == 0 || domainSize[domainIdx] > maxSize) {
+            std::cerr << "subdomain " << domainIdx << " has " << domainSize[domainIdx]
+                      << " rows, expected at most " << maxSize << "\n";
+            throw std::logic_error("unbalanced partition");
+        }
+    }
+}
+
+void testColoring(const Matrix& matrix)
+{
+    const std::size_t numRows = matrix.N();
+    const std::vector<bool> active(numRows, true);
+    const int numDomains = 8;
+    const auto domainOfRow = Opm::partitionMatrixGraph(matrix, active, numDomains);
+    const auto colors = Opm::colorSubDomains(matrix, domainOfRow, numDomains);
+
+    std::vector<int> colorOfDomain(numDomains, -1);
+    for (std::size_t colorIdx = 0; colorIdx < colors.size(); ++colorIdx) {
+        for (const int domainIdx : colors[colorIdx]) {
+            if (colorOfDomain[domainIdx] != -1)
+                throw std::logic_error("subdomain has multiple colors");
+            colorOfDomain[domainIdx] = static_cast<int>(colorIdx);
+        }
+    }
+    for (const int colorIdx : colorOfDomain)
+        if (colorIdx == -1)
+            throw std::logic_error("subdomain was not colored");
+    if (colors.size() < 2 || colors.size() == static_cast<std::size_t>(numDomains))
+        throw std::logic_error("unexpected number of colors");
+
+    // no row may be connected to two subdomains of the same color
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        const auto& row = matrix[rowIdx];
+        for (auto colIt = row.begin(); colIt != row.end(); ++colIt) {
+            for (auto otherIt = row.begin(); otherIt != row.end(); ++otherIt) {
+                const int domainIdx = domainOfRow[colIt.index()];
+                const int otherIdx = domainOfRow[otherIt.index()];
+                if (domainIdx != otherIdx && colorOfDomain[domainIdx] == colorOfDomain[otherIdx]) {
+                    std::cerr << "subdomains " << domainIdx << " and " << otherIdx
+                              << " are connected via row " << rowIdx << "\n";
+                    throw std::logic_error("connected subdomains have the same color");
+                }
+            }
+        }
+    }
+}
+
+void testLocalSystem(const Matrix& matrix)
+{
+    const std::size_t numRows = matrix.N();
+
+    // a block of cells in the middle of the grid, given in arbitrary order
+    std::vector<int> cells;
+    for (int j = 6; j >= 3; --j)
+        for (int i = 2; i < 8; ++i)
+            cells.push_back(j*nx + i);
+
+    std::vector<bool> isLocal(numRows, false);
+    for (const int cellIdx : cells)
+        isLocal[cellIdx] = true;
+
+    // the right hand side only depends on the unknowns of the subdomain
+    Vector expected(numRows);
+    expected = 0.0;
+    for (const int cellIdx : cells) {
+        expected[cellIdx][0] = 1.0 + 0.1*cellIdx;
+        expected[cellIdx][1] = std::sin(0.3*cellIdx);
+    }
+    Vector rhs(numRows);
+    rhs = 0.0;
+    matrix.mv(expected, rhs);
+    // the residual of the other cells must not be used
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx)
+        if (!isLocal[rowIdx])
+            rhs[rowIdx] = 1e10;
+
+    std::vector<int> globalToLocal(numRows, -1);
+    Opm::Linear::NlddLocalSystem<Matrix, Vector> localSystem(matrix, cells, globalToLocal);
+    for (const int idx : globalToLocal)
+        if (idx != -1)
+            throw std::logic_error("scratch space was not reset");
+
+    localSystem.assemble(rhs);
+
+    Vector solution(numRows);
+    solution = -1.0;
+    if (!localSystem.solve(solution, 1e-12, 200))
+        throw std::logic_error("local linear solver did not converge");
+
+    for (std::size_t rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            const double ref = isLocal[rowIdx] ? expected[rowIdx][eqIdx] : -1.0;
+            if (std::abs(solution[rowIdx][eqIdx] - ref) > 1e-8) {
+                std::cerr << "row " << rowIdx << ", equation " << eqIdx << ": got "
+                          << solution[rowIdx][eqIdx] << ", expected " << ref << "\n";
+                throw std::logic_error("wrong solution of the local system");
+            }
+        }
+    }
+}
+
+int main()
+{
+    const Matrix matrix = createMatrix();
+    testPartition(matrix);
+    testColoring(matrix);
+    testLocalSystem(matrix);
+
+    return 0;
+}
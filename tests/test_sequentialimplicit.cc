@@ -0,0 +1,102 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test which makes sure that the sequential implicit strategy of the Newton
+ *        method converges for the black-oil reservoir problem without resorting to
+ *        the fully implicit Newton method.
+ */
+#include "config.h"
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <opm/models/io/dgfvanguard.hh>
+#include <opm/models/utils/start.hh>
+#include <opm/models/blackoil/blackoilmodel.hh>
+#include <opm/models/discretization/ecfv/ecfvdiscretization.hh>
+#include <opm/simulators/linalg/parallelbicgstabbackend.hh>
+
+#include "problems/reservoirproblem.hh"
+
+#include <iostream>
+#include <stdexcept>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#endif
+
+namespace Opm::Properties {
+
+namespace TTag {
+
+struct ReservoirBlackOilSequentialProblem
+{ using InheritsFrom = std::tuple<ReservoirBaseProblem, BlackOilModel>; };
+
+} // end namespace TTag
+
+template<class TypeTag>
+struct SpatialDiscretizationSplice<TypeTag, TTag::ReservoirBlackOilSequentialProblem>
+{ using type = TTag::EcfvDiscretization; };
+
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::ReservoirBlackOilSequentialProblem>
+{ using type = TTag::AutoDiffLocalLinearizer; };
+
+} // namespace Opm::Properties
+
+int main(int argc, char **argv)
+{
+    using TypeTag = Opm::Properties::TTag::ReservoirBlackOilSequentialProblem;
+    using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+    using ThreadManager = Opm::GetPropType<TypeTag, Opm::Properties::ThreadManager>;
+
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    const char* testArgv[] = { argv[0],
+                               "--end-time=8750000",
+                               "--enable-vtk-output=false",
+                               "--newton-sequential-implicit=true" };
+    if (Opm::setupParameters_<TypeTag>(4, testArgv) != 0)
+        return 1;
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    simulator.run();
+
+    const auto& newtonMethod = simulator.model().newtonMethod();
+    std::cout << "time steps solved by the sequential implicit strategy: "
+              << newtonMethod.numSequentialImplicitConverged()
+              << ", time steps solved by the fully implicit Newton method: "
+              << newtonMethod.numSequentialImplicitFallbacks() << "\n";
+
+    if (newtonMethod.numSequentialImplicitConverged() == 0)
+        throw std::logic_error("the sequential implicit strategy was not used");
+    if (newtonMethod.numSequentialImplicitFallbacks() != 0)
+        throw std::logic_error("the sequential implicit strategy did not converge");
+
+    return 0;
+}
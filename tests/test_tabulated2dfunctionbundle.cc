@@ -0,0 +1,118 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \brief A test which makes sure that a bundle of tabulated functions yields the same
+ *        values and derivatives as the individual functions.
+ */
+#include "config.h"
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+
+#include <opm/models/utils/tabulated2dfunctionbundle.hh>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+using Scalar = double;
+constexpr int numVars = 2;
+using Evaluation = Opm::DenseAd::Evaluation<Scalar, numVars>;
+using Table = Opm::UniformXTabulated2DFunction<Scalar>;
+
+constexpr std::size_t numFunctions = 3;
+using Bundle = Opm::UniformXTabulated2DFunctionBundle<Scalar, numFunctions>;
+
+Scalar sampleValue(std::size_t funcIdx, Scalar x, Scalar y)
+{
+    switch (funcIdx) {
+    case 0: return 1.0 + x*y;
+    case 1: return std::sin(x) + y*y;
+    default: return std::exp(-x)*(1.0 + y);
+    }
+}
+
+bool isClose(Scalar a, Scalar b)
+{ return std::abs(a - b) <= 1e-12*std::max(1.0, std::max(std::abs(a), std::abs(b))); }
+
+void testPolicy(Table::InterpolationPolicy policy)
+{
+    std::array<Table, numFunctions> tables;
+    tables.fill(Table(policy));
+    Bundle bundle(policy);
+
+    // the columns have different numbers of sampling points which start at different
+    // y-positions
+    const unsigned numX = 5;
+    for (unsigned i = 0; i < numX; ++i) {
+        const Scalar x = 0.2*i;
+        for (auto& table : tables)
+            table.appendXPos(x);
+        bundle.appendXPos(x);
+
+        const unsigned numY = 3 + i % 3;
+        for (unsigned j = 0; j < numY; ++j) {
+            const Scalar y = 10.0*i + 7.0*j;
+            Bundle::Values values;
+            for (std::size_t funcIdx = 0; funcIdx < numFunctions; ++funcIdx) {
+                values[funcIdx] = sampleValue(funcIdx, x, y);
+                tables[funcIdx].appendSamplePoint(i, y, values[funcIdx]);
+            }
+            bundle.appendSamplePoint(i, y, values);
+        }
+    }
+
+    // evaluate inside and outside of the tabulated range
+    for (Scalar x = -0.1; x < 1.0; x += 0.07) {
+        for (Scalar y = -5.0; y < 70.0; y += 3.1) {
+            const auto xEval = Evaluation::createVariable(x, 0);
+            const auto yEval = Evaluation::createVariable(y, 1);
+
+            const auto result = bundle.eval(xEval, yEval, /*extrapolate=*/true);
+            for (std::size_t funcIdx = 0; funcIdx < numFunctions; ++funcIdx) {
+                const Evaluation expected = tables[funcIdx].eval(xEval, yEval, /*extrapolate=*/true);
+                bool ok = isClose(result[funcIdx].value(), expected.value());
+                for (int varIdx = 0; varIdx < numVars; ++varIdx)
+                    ok = ok && isClose(result[funcIdx].derivative(varIdx), expected.derivative(varIdx));
+
+                if (!ok) {
+                    std::cerr << "function " << funcIdx << " at (" << x << ", " << y << "): "
+                              << "bundle yields " << result[funcIdx].value() << ", "
+                              << "table yields " << expected.value() << "\n";
+                    throw std::logic_error("bundle and individual table differ");
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    testPolicy(Table::InterpolationPolicy::Vertical);
+    testPolicy(Table::InterpolationPolicy::LeftExtreme);
+
+    return 0;
+}